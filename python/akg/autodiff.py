@@ -239,7 +239,9 @@ def differentiate(output, inputs=None, head=None, ad_attrs=None, new_pld_array=N
             be (2, 3), (?, 2, 3) and etc.
             If `None` is passed, the identity tensor of shape `output.shape + output.shape` will be used.
             Default: None.
-        ad_attrs (dict): The additional attributes for the auto-differentiate computation. Default: None.
+        ad_attrs (dict): The additional attributes for the auto-differentiate computation. Setting "recompute" to 1
+            recomputes cheap elementwise forward tensors inside the adjoints instead of keeping them alive, as long as
+            the extra flops per released byte stay below "recompute_flops_per_byte" (2.0 by default). Default: None.
         new_pld_array (list): List of additional variables which could be used in differentiation. Default: None.
         override (dict): A dictionary to override differentiation for certain tensors.
             Override is a dictionary with types: {tvm.tensor.Tensor: (list[tvm.tensor.Tensor],
@@ -281,6 +283,10 @@ def differentiate(output, inputs=None, head=None, ad_attrs=None, new_pld_array=N
             - adjoint_summands (dict{tvm.tensor.Tensor: dict{tvm.tensor.Tensor: tvm.tensor.Tensor}}):
               Single summands of the adjoints.
 
+            - recompute_stats (dict{str: object}):
+              With "recompute" set, the forward tensors no longer kept for the backward pass ("recomputed"),
+              the bytes they release ("saved_bytes") and the flops added to the adjoints ("extra_flops").
+
     Raises:
         ValueError: If the shape of `head` is invalid.
 
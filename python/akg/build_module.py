@@ -162,3 +162,31 @@ def build(inputs, args, target='cce', shape_params=None, name="default_function"
                             attrs=attrs, polyhedral=polyhedral, target=target)
 
     return _api_internal._BuildToModule(tmp_rst, target)
+
+
+def build_shape_buckets(inputs, args, buckets, shape_params, target="llvm", name="default_function",
+                        binds=None, attrs=None, polyhedral=True, bucket_max=None):
+    """
+    Build a dynamic shape cpu kernel which dispatches to variants scheduled for bounded ranges of the shape vars.
+
+    Args:
+        inputs (schedule.Schedule): The schedule to build.
+        args (list): The tensors of the kernel.
+        buckets (Union[str, list]): "pow2" for powers of two from 16 to `bucket_max` as bounds of every shape var,
+            or a list of points which give one upper bound per var of `shape_params`. A shape runs the variant of
+            the tightest bucket whose bounds it stays within.
+        shape_params (list): The shape vars of the kernel.
+        target (str): Only "llvm" is supported.
+        bucket_max (int): The largest "pow2" bound, 1024 if None.
+
+    Returns:
+        module. Shapes beyond every bucket run the symbolic kernel.
+    """
+    if target.split()[0] != "llvm":
+        raise ValueError("shape buckets are only built for the llvm target, but got %s" % target)
+    bucket_attrs = {} if attrs is None else dict(attrs)
+    bucket_attrs["shape_buckets"] = buckets
+    if bucket_max is not None:
+        bucket_attrs["shape_bucket_max"] = bucket_max
+    return build(inputs, args, target, shape_params, name=name, binds=binds, attrs=bucket_attrs,
+                 polyhedral=polyhedral)
@@ -13,5 +13,5 @@
 # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 # See the License for the specific language governing permissions and
 # limitations under the License.
-from .build_module import build, generate_trait, get_tiling_space
+from .build_module import build, build_batch, generate_trait, get_tiling_space
 from .topi import *
@@ -445,16 +445,16 @@ def _cpp_build(attrs, process, poly, segment_tree, segment_infos):
     return res
 
 
-def _build_to_module(desc_s, desc_d, attrs=None, poly=True):
+def _get_build_args(desc_s, desc_d, attrs=None, poly=True):
     """
-    build kernel with compute description in json format
+    get the arguments of the composite lower with compute description in json format
     Args:
        desc_s : str of compute description
        desc_d : dict of compute description
        attrs   : dict of build attributes
 
     Returns:
-       Module.
+       segment tree and segment infos.
     """
 
     process = desc_d["process"]
@@ -546,7 +546,21 @@ def _build_to_module(desc_s, desc_d, attrs=None, poly=True):
         ConstructType.TOT: _common_postprocess,
         ConstructType.CONCAT: _common_postprocess
     }
-    segment_tree, segment_infos = get_construct_args(desc_s, attrs, post_funcs)
+    return get_construct_args(desc_s, attrs, post_funcs)
+
+
+def _build_to_module(desc_s, desc_d, attrs=None, poly=True):
+    """
+    build kernel with compute description in json format
+    Args:
+       desc_s : str of compute description
+       desc_d : dict of compute description
+       attrs   : dict of build attributes
+
+    Returns:
+       Module.
+    """
+    segment_tree, segment_infos = _get_build_args(desc_s, desc_d, attrs, poly)
     process = desc_d["process"]
 
     return _cpp_build(attrs, process, poly, segment_tree, segment_infos)
@@ -956,6 +970,64 @@ def build(kernel_desc, attrs=None, poly=True, use_repo=True):
         return _build_to_module(desc_s, desc_d, attrs, poly)
 
 
+def build_batch(kernel_descs, attrs=None, poly=True, workers=0, callback=None):
+    """
+    build a list of kernels with compute description in json format in one call
+    Args:
+       kernel_descs : list of str or dict of compute description
+       attrs   : dict of build attributes shared by all kernels
+       poly    : bool, use the polyhedral scheduler
+       workers : int, kernels compiled at the same time, the number of cores when 0
+       callback : function called as callback(index, seconds, done, total, module_or_error) when a kernel is done
+
+    Returns:
+       list of Module, with None for the kernels that fail, and the list of their error messages.
+    """
+    from akg.ms.info_version_adapt import InfoVersionAdapt
+    modules = [None] * len(kernel_descs)
+    errors = [""] * len(kernel_descs)
+    batch_index = []
+    batch_kernels = []
+    for i, kernel_desc in enumerate(kernel_descs):
+        desc_d = json.loads(kernel_desc) if isinstance(kernel_desc, str) else kernel_desc
+        if not isinstance(desc_d, dict):
+            raise TypeError("kernel_desc should be a dict, but get a {}".format(type(desc_d)))
+        info_adapter = InfoVersionAdapt(desc_d)
+        if not info_adapter.run():
+            errors[i] = info_adapter.msg
+            continue
+        desc_s = _set_backend(desc_d)
+        kernel_attrs = _set_attrs(desc_d, dict(attrs) if attrs else dict(), poly)
+        backend = desc_d["process"]
+        if backend == "cuda":
+            _set_cuda_compute_capability(desc_d)
+        if backend == "aicore" or kernel_attrs.get("is_tbe_codegen") or "ret_mode" in kernel_attrs:
+            # these kernels are built by their own flows
+            try:
+                modules[i] = build(desc_d, kernel_attrs, poly)
+            except RuntimeError as e:
+                errors[i] = str(e)
+            continue
+        segment_tree, segment_infos = _get_build_args(desc_s, desc_d, kernel_attrs, poly)
+        batch_index.append(i)
+        batch_kernels.append({"target": backend, "poly": int(poly), "segment_tree": segment_tree,
+                              "segment_infos": segment_infos})
+
+    def _on_done(index, seconds, done, total, res):
+        kernel_index = batch_index[index]
+        if isinstance(res, str):
+            errors[kernel_index] = res
+        else:
+            modules[kernel_index] = res
+        if callback is not None:
+            callback(kernel_index, seconds, done, total, res)
+
+    if batch_kernels:
+        func = tvm.get_global_func("lower_composite_batch_to_module")
+        func(batch_kernels, workers, _on_done)
+    return modules, errors
+
+
 def get_tiling_space(kernel_desc, level=1, attr=None):
     """
     get tiling space of composite kernel
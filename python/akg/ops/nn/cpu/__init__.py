@@ -20,3 +20,4 @@ from .depthwise_conv2d import depthwise_conv2d_nchwc
 from .layout_transform import layout_transform
 from .pooling import pooling
 from .global_pooling import global_pooling
+from .quantize import requantize, matmul_u8s8, quantized_matmul, quantized_conv2d_nchwc
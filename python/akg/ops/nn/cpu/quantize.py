@@ -0,0 +1,76 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""operator dsl function: int8 quantized matmul and conv2d"""
+from akg.topi.util import get_const_tuple
+import akg.tvm as tvm
+from .conv2d import conv2d_nchwc
+
+QUANTIZED_RANGE = {"uint8": (0, 255), "int8": (-128, 127)}
+
+
+def requantize(data, scale, zero_point, out_dtype="uint8"):
+    """Requantize the int32 accumulator to 8 bits: clip(round(data * scale) + zero_point)"""
+    if out_dtype not in QUANTIZED_RANGE:
+        raise ValueError("out_dtype should be uint8 or int8, now is {}".format(out_dtype))
+    q_min, q_max = QUANTIZED_RANGE[out_dtype]
+
+    def _requantize(*indices):
+        value = tvm.round(data(*indices).astype("float32") * tvm.const(scale, "float32"))
+        value = value + tvm.const(zero_point, "float32")
+        value = tvm.max(tvm.min(value, tvm.const(q_max, "float32")), tvm.const(q_min, "float32"))
+        return value.astype(out_dtype)
+
+    return tvm.compute(data.shape, _requantize, name="requantize")
+
+
+def matmul_u8s8(data, weight, transpose_b=False):
+    """uint8 x int8 matmul accumulated in int32, the cpu gemm packs both operands in groups of 4 along k"""
+    if data.dtype != "uint8" or weight.dtype != "int8":
+        raise ValueError("matmul_u8s8 takes uint8 data and int8 weight, now is {} and {}".format(
+            data.dtype, weight.dtype))
+    m, k = get_const_tuple(data.shape)
+    n = weight.shape[0] if transpose_b else weight.shape[1]
+    reduce_k = tvm.reduce_axis((0, k), name="reduce_axis")
+    if transpose_b:
+        def _weight(j):
+            return weight[j, reduce_k]
+    else:
+        def _weight(j):
+            return weight[reduce_k, j]
+    return tvm.compute((m, n),
+                       lambda i, j: tvm.sum(data[i, reduce_k].astype("int32") * _weight(j).astype("int32"),
+                                            axis=[reduce_k]),
+                       name="matmul_u8s8", tag="matmul")
+
+
+def quantized_matmul(data, weight, scale=None, zero_point=0, out_dtype="int32", transpose_b=False):
+    """matmul_u8s8 with the requantize epilogue fused when out_dtype is 8 bits"""
+    out = matmul_u8s8(data, weight, transpose_b)
+    if out_dtype == "int32":
+        return out
+    return requantize(out, scale, zero_point, out_dtype)
+
+
+def quantized_conv2d_nchwc(data, weight, stride, pad, dilation, scale=None, zero_point=0, out_dtype="int32",
+                           target="llvm"):
+    """uint8 NCHWc data x int8 KCRSxy weight conv2d with the requantize epilogue fused when out_dtype is 8 bits"""
+    if data.dtype != "uint8" or weight.dtype != "int8":
+        raise ValueError("quantized_conv2d_nchwc takes uint8 data and int8 weight, now is {} and {}".format(
+            data.dtype, weight.dtype))
+    out = conv2d_nchwc(data, weight, stride, pad, dilation, out_dtype="int32", output_layout="NCHWc",
+                       target=target)
+    if out_dtype == "int32":
+        return out
+    return requantize(out, scale, zero_point, out_dtype)
@@ -39,7 +39,8 @@ CpuPackBBlockSize = {
     "sse": 12,
     "avx": 24,
     "avx2": 24,
-    "avx512": 48
+    "avx512": 48,
+    "avx512vnni": 48
 }
 
 class Log(logging.Logger):
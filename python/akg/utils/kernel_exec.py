@@ -412,6 +412,40 @@ def mod_launch_default(mod, args, outputs=(-1,), target=CUDA, tuning=False, devi
         return out_list[0] if len(out_list) == 1 else tuple(out_list), {'run_time': cycles}
 
 
+def export_bench_kernel(mod, args, out_dir, flops=None, spec_name="bench_spec.json"):
+    """
+    Export a cpu module and add it to the spec that tests/bench/cpp/bench_kernel reads.
+
+    Args:
+        mod: cpu module from op_build_test or composite build.
+        args: list of numpy arrays, the arguments of the kernel in launch order.
+        out_dir: directory of the exported library and of the spec.
+        flops: floating point operations of one launch, one per output element when None.
+        spec_name: spec file, the kernels already in it are kept.
+
+    Returns:
+        path of the spec.
+    """
+    import json
+    os.makedirs(out_dir, exist_ok=True)
+    func = mod.entry_name
+    lib_name = func + ".so"
+    mod.export_library(os.path.join(out_dir, lib_name))
+    spec_path = os.path.join(out_dir, spec_name)
+    spec = {"kernels": []}
+    if os.path.exists(spec_path):
+        with open(spec_path, "r") as f:
+            spec = json.load(f)
+    kernel = {"module": lib_name, "func": func,
+              "args": [{"dtype": str(a.dtype), "shape": list(a.shape)} for a in args]}
+    if flops is not None:
+        kernel["flops"] = flops
+    spec["kernels"] = [k for k in spec["kernels"] if k.get("func") != func] + [kernel]
+    with open(spec_path, "w") as f:
+        json.dump(spec, f, indent=2)
+    return spec_path
+
+
 @func_time_required
 def mod_launch(mod, args, outputs=(-1,), tuning=False, device_id=-1, expect=None, repeat_time=400, arch=None):
     """
@@ -100,14 +100,28 @@ TVM_REGISTER_API("gpu.info.compute.instance").set_body([](const TVMArgs args, TV
   int num_sm = -1;
   int active_blocks_per_sm = -1;
   int min_elem_for_io_bound = -1;
+  // Per-sm resources shared by volta and ampere.
+  int max_threads_per_sm = 2048;
+  int max_blocks_per_sm = 32;
+  int regs_per_sm = 64 * 1024;
+  int max_regs_per_thread = 255;
+  int shared_bytes_per_sm = -1;
+  int peak_gflops = -1;
+  int mem_bandwidth_gbps = -1;
   if (device_type == "v100") {
     num_sm = 80;
     active_blocks_per_sm = 5;
     min_elem_for_io_bound = 2;
+    shared_bytes_per_sm = 96 * 1024;
+    peak_gflops = 15700;
+    mem_bandwidth_gbps = 900;
   } else if (device_type == "a100") {
     num_sm = 108;
     active_blocks_per_sm = abps == 0 ? 10 : abps;
     min_elem_for_io_bound = io == 0 ? 2 : io;
+    shared_bytes_per_sm = 164 * 1024;
+    peak_gflops = 19500;
+    mem_bandwidth_gbps = 1555;
   }
   CHECK_NE(num_sm, -1) << "Invalid query for compute ability on " << device_type;
   CHECK_NE(active_blocks_per_sm, -1) << "Invalid query for compute ability on " << device_type;
@@ -117,6 +131,13 @@ TVM_REGISTER_API("gpu.info.compute.instance").set_body([](const TVMArgs args, TV
   node->num_sm = num_sm;
   node->active_blocks_per_sm = active_blocks_per_sm;
   node->min_elem_for_io_bound = min_elem_for_io_bound;
+  node->max_threads_per_sm = max_threads_per_sm;
+  node->max_blocks_per_sm = max_blocks_per_sm;
+  node->regs_per_sm = regs_per_sm;
+  node->max_regs_per_thread = max_regs_per_thread;
+  node->shared_bytes_per_sm = shared_bytes_per_sm;
+  node->peak_gflops = peak_gflops;
+  node->mem_bandwidth_gbps = mem_bandwidth_gbps;
   *ret = air::GpuComputeInfo(node);
 });
 
@@ -148,6 +148,9 @@ REGISTER_PASS(MatrixTranspose);
 REGISTER_PASS(AdaptDynamicBatch);
 REGISTER_PASS(AdjustParallelLoop);
 REGISTER_PASS(ReductionFactor);
+REGISTER_PASS(InjectCpuStreamHint);
+REGISTER_PASS(EmitCpuInt8Dot);
+REGISTER_PASS(UseFastMath);
 REGISTER_PASS(CheckBoundTensor);
 }  // namespace ir
 }  // namespace akg
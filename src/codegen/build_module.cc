@@ -31,7 +31,10 @@
 #include "ir_pass.h"
 #include "schedule_pass.h"
 #include "codegen/pass_mgr.h"
+#include "codegen/stage_lower.h"
 #include "composite/utils/util.h"
+#include "pass/gpu_kernel_analyzer.h"
+#include "poly/dynamic_shape.h"
 
 namespace akg {
 AttrMap g_attrs;
@@ -560,6 +563,198 @@ NodeRef Lower(Schedule sch, const Array<NodeRef> &in_args, const Array<NodeRef>
   return LowerImpl::Instance().Run(data, get_stmt);
 }
 
+namespace {
+constexpr int64_t kMinPow2ShapeBucket = 16;
+constexpr int kDefaultShapeBucketMax = 1024;
+constexpr size_t kMaxShapeBuckets = 16;
+constexpr auto kDynamicShape = "dynamic_shape";
+
+// Powers of two from kMinPow2ShapeBucket to max_value, at most count of them spread evenly over the range
+std::vector<int64_t> Pow2Bounds(int64_t max_value, size_t count) {
+  std::vector<int64_t> all;
+  for (int64_t value = kMinPow2ShapeBucket; value <= max_value; value *= 2) {
+    all.push_back(value);
+  }
+  if (all.size() <= count) {
+    return all;
+  }
+  std::vector<int64_t> bounds;
+  for (size_t i = 1; i <= count; ++i) {
+    bounds.push_back(all[i * all.size() / count - 1]);
+  }
+  return bounds;
+}
+
+// Upper bounds of the shape vars, one per var and bucket, in ascending lexicographic order, so that the first bucket
+// which holds a shape is the tightest. The spec is either "pow2", powers of two up to shape_bucket_max for each var,
+// or a list of points holding one bound per shape var.
+std::vector<std::vector<int64_t>> GetShapeBuckets(const NodeRef &spec, const Array<Var> &vars, int64_t max_value) {
+  std::vector<std::vector<int64_t>> buckets;
+  if (vars.empty()) {
+    return buckets;
+  }
+  if (auto kind = spec.as<StringImm>()) {
+    CHECK_EQ(kind->value, "pow2") << "unknown shape bucket kind " << kind->value;
+    // every var gets the same number of bounds, so that the product stays within kMaxShapeBuckets
+    auto fits = [&vars](size_t per_var) {
+      size_t total = 1;
+      for (size_t v = 0; v < vars.size(); ++v) {
+        total *= per_var;
+      }
+      return total <= kMaxShapeBuckets;
+    };
+    size_t per_var = 1;
+    while (fits(per_var + 1)) {
+      ++per_var;
+    }
+    auto bounds = Pow2Bounds(max_value, per_var);
+    buckets.emplace_back();
+    for (size_t v = 0; v < vars.size(); ++v) {
+      std::vector<std::vector<int64_t>> expanded;
+      for (const auto &bucket : buckets) {
+        for (auto bound : bounds) {
+          expanded.push_back(bucket);
+          expanded.back().push_back(bound);
+        }
+      }
+      buckets.swap(expanded);
+    }
+  } else {
+    CHECK(spec.as<air::ArrayNode>()) << "shape_buckets must be \"pow2\" or a list of points, but got " << spec;
+    for (const auto &value : Downcast<Array<NodeRef>>(spec)) {
+      Array<NodeRef> point = value.as<air::ArrayNode>() ? Downcast<Array<NodeRef>>(value) : Array<NodeRef>{value};
+      CHECK_EQ(point.size(), vars.size()) << "shape bucket " << value << " must give one value per shape var";
+      std::vector<int64_t> bucket;
+      for (const auto &bound : point) {
+        auto imm = bound.as<IntImm>();
+        CHECK(imm != nullptr && imm->value > 0) << "shape bucket value must be a positive integer, not " << bound;
+        bucket.push_back(imm->value);
+      }
+      buckets.push_back(bucket);
+    }
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+  }
+  if (buckets.size() > kMaxShapeBuckets) {
+    LOG(WARNING) << "Only the " << kMaxShapeBuckets << " smallest of " << buckets.size() << " shape buckets are built.";
+    buckets.resize(kMaxShapeBuckets);
+  }
+  return buckets;
+}
+
+// Gives the caller back its global attrs when the bucket lowering is left.
+class GlobalAttrsScope {
+ public:
+  GlobalAttrsScope() : saved_(g_attrs) {}
+  ~GlobalAttrsScope() { g_attrs = saved_; }
+
+ private:
+  AttrMap saved_;
+};
+}  // namespace
+
+NodeRef LowerShapeBuckets(Schedule sch, const Array<NodeRef> &in_args, const Array<NodeRef> &shape_vars,
+                          const std::string &name, const Map<Tensor, Buffer> &in_binds,
+                          const Map<std::string, NodeRef> &in_attrs, bool polyhedral, const std::string &target,
+                          const BuildConfig &config) {
+  GlobalAttrsScope attrs_scope;
+  Map<std::string, NodeRef> attrs;
+  for (const auto &it : in_attrs) {
+    if (it.first != kShapeBuckets && it.first != kShapeBucketMax) {
+      attrs.Set(it.first, it.second);
+    }
+  }
+  Array<Var> vars;
+  for (const auto &arg : shape_vars) {
+    if (arg.as<Variable>()) {
+      vars.push_back(Downcast<Var>(arg));
+    }
+  }
+  AttrMap spec_attrs;
+  spec_attrs = in_attrs;
+  auto buckets =
+    GetShapeBuckets(in_attrs[kShapeBuckets], vars, spec_attrs.GetInt(kShapeBucketMax, kDefaultShapeBucketMax));
+
+  // Every variant starts from the same initial stmt, so they all address the buffers of the generic arg list.
+  LowerData data = LowerDataNode::make(sch, in_args, in_binds, attrs, target, name, config, polyhedral, false, false,
+                                       shape_vars);
+  auto init = lower::StageLower(data).RunTo(lower::StageType::Begin);
+  Stmt init_stmt = Downcast<Stmt>(init.Node());
+  LowerData init_data = init.Data();
+
+  // A variant serves every shape up to the bounds of its bucket. The bounds reach the polyhedral context as dynamic
+  // shape limits of the shape vars, so the variant is scheduled and tiled for that range.
+  std::vector<std::pair<Expr, Stmt>> variants;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    Map<std::string, NodeRef> variant_attrs;
+    for (const auto &it : init_data->attrs) {
+      variant_attrs.Set(it.first, it.second);
+    }
+    Array<NodeRef> limits;
+    if (variant_attrs.count(kDynamicShape) != 0) {
+      limits = Downcast<Array<NodeRef>>(variant_attrs[kDynamicShape]);
+    }
+    Expr cond;
+    for (size_t v = 0; v < vars.size(); ++v) {
+      auto limit = air::make_node<air::DynamicShapeNode>();
+      limit->tensor_name = vars[v]->name_hint;
+      limit->pos = -1;
+      limit->dyn_shape_limit = static_cast<int>(buckets[i][v]);
+      limit->poly_upper_bound = static_cast<int>(buckets[i][v] + 1);
+      limits.push_back(air::DynamicShape(limit));
+      Expr le = LE::make(vars[v], air::make_const(vars[v].type(), buckets[i][v]));
+      cond = cond.defined() ? And::make(cond, le) : le;
+    }
+    // the passes of a variant write their attrs into a copy, so they never reach the other buckets
+    variant_attrs.Set(kDynamicShape, limits);
+    LowerData variant_data =
+      LowerDataNode::make(sch, init_data->args, init_data->binds, variant_attrs, target,
+                          name + "_bucket" + std::to_string(i), config, polyhedral, false, false, shape_vars,
+                          init_data->split_index, init_data->arg_list_0, init_data->binds_0);
+    lower::StageLower variant_lower(variant_data, init_stmt, lower::StageType::Tuning);
+    variants.emplace_back(cond, Downcast<Stmt>(variant_lower.RunTo(lower::StageType::BeforeLowerFunc).Node()));
+  }
+
+  // The symbolic kernel serves every shape beyond the buckets.
+  lower::StageLower generic(init_data, init_stmt, lower::StageType::Tuning);
+  Stmt stmt = Downcast<Stmt>(generic.RunTo(lower::StageType::BeforeLowerFunc).Node());
+  LowerData generic_data = generic.Data();
+  for (auto it = variants.rbegin(); it != variants.rend(); ++it) {
+    stmt = IfThenElse::make(it->first, it->second, stmt);
+  }
+  LOG(INFO) << name << " dispatches " << variants.size() << " shape bucket variants before the symbolic kernel.";
+
+  g_attrs = generic_data->attrs;
+  PassMgr::SetArgs(generic_data->arg_list_0);
+  return LowerFunc(stmt, name, config, generic_data->arg_list_0);
+}
+
+namespace {
+constexpr double kLowOccupancyWarnRatio = 0.125;
+
+void ReportGpuKernels(const Array<LoweredFunc> &fdevice) {
+  std::string device_type;
+  (void)g_attrs.GetStr(kDeviceType, &device_type);
+  auto sm = ir::GetGpuSmConfig(device_type);
+  for (const auto &func : fdevice) {
+    auto report = ir::AnalyzeGpuKernel(func, sm);
+    LOG(DEBUG) << report.ToString();
+    if (report.occupancy.occupancy < kLowOccupancyWarnRatio || report.strided_accesses > 0) {
+      LOG(INFO) << "Kernel " << report.name << " has occupancy " << report.occupancy.occupancy << " (limited by "
+                   << report.occupancy.limiter << ") and " << report.strided_accesses
+                   << " uncoalesced global accesses.";
+    }
+    if (g_attrs.GetInt(kDumpPassIr, 0) != 0) {
+      std::ofstream of(PassMgr::GetDir() + "/" + func->name + "_kernel_report.txt");
+      if (of.is_open()) {
+        of << report.ToString() << std::endl;
+        of.close();
+      }
+    }
+  }
+}
+}  // namespace
+
 void BuildForDevice(const Array<LoweredFunc> &flist, const std::string &target_name,
                     const std::string &target_host_name, Array<LoweredFunc> *out_flist,
                     air::runtime::Module *out_mdev) {
@@ -596,6 +791,7 @@ void BuildForDevice(const Array<LoweredFunc> &flist, const std::string &target_n
     for (size_t i = 0; i < fdevice.size(); ++i) {
       fdevice.Set(i, NEXT_PASS(LowerWarpMemory, fdevice[i], target->thread_warp_size));
     }
+    ReportGpuKernels(fdevice);
   }
 
   for (size_t i = 0; i < fhost.size(); ++i) {
@@ -658,7 +854,12 @@ BuildRst BuildToFunc(const Schedule &inputs, const Array<NodeRef> &in_args, cons
     attrs = in_attrs;
   }
 
-  auto rst = Lower(inputs, args, shape_vars, name, binds, attrs, false, polyhedral, false, target, config);
+  NodeRef rst;
+  if (attrs.count(kShapeBuckets) && Target::Create(target)->target_name == "llvm") {
+    rst = LowerShapeBuckets(inputs, args, shape_vars, name, binds, attrs, polyhedral, target, config);
+  } else {
+    rst = Lower(inputs, args, shape_vars, name, binds, attrs, false, polyhedral, false, target, config);
+  }
   return BuildRstNode::make(rst, name);
 }
 
@@ -24,6 +24,7 @@
  */
 
 #include <algorithm>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -33,6 +34,7 @@
 #include "codegen/stage_lower.h"
 #include "composite/utils/util.h"
 #include "pass/utils.h"
+#include "poly/poly_util.h"
 
 namespace akg {
 StageResult LLVMLowerBegin(Stmt &, LowerData &data) {
@@ -81,6 +83,7 @@ StageResult LLVMLowerBeforeFlattern(Stmt &stmt, LowerData &data) {
       stmt = NEXT_PASS(FixRealizeShape, stmt, data->target);
     }
     stmt = NEXT_PASS(RealizeCompress, stmt);
+    stmt = NEXT_PASS_IF(g_attrs.GetBool(kEnableCpuGemmEpilogue, true), FuseCpuGemmEpilogue, stmt);
     stmt = NEXT_PASS(ReconstructLayout, stmt);
     stmt = NEXT_PASS(MatrixTranspose, stmt);
     if (g_attrs.count(kDynamicInputIndex) > 0 && !g_attrs[kDynamicInputIndex].as<StringImm>()->value.empty()) {
@@ -90,6 +93,8 @@ StageResult LLVMLowerBeforeFlattern(Stmt &stmt, LowerData &data) {
       stmt = NEXT_PASS(AdaptDynamicBatch, stmt, data->arg_list_0, data->binds_0, bs, g_attrs[kDynamicInputIndex]);
     }
     stmt = NEXT_PASS(AdjustParallelLoop, stmt);
+    stmt = NEXT_PASS_IF(g_attrs.GetBool(kEnableCpuSegmentPrivatize, true), PrivatizeSegmentReduction, stmt,
+                        g_attrs.GetInt(kCpuThreadNum, kDefaultCpuThreadNum));
     stmt = NEXT_PASS(ReductionFactor, stmt, data->binds_0);
   }
   return {stmt, false};
@@ -97,10 +102,30 @@ StageResult LLVMLowerBeforeFlattern(Stmt &stmt, LowerData &data) {
 
 StageResult LLVMLowerFlattern(Stmt &stmt, LowerData &data) { return LowerFlattern(stmt, data); }
 
+namespace {
+// the x86 instruction sets that have an int8 dot product sequence in the llvm codegen
+bool HasInt8Dot(const std::string &feature) {
+  return feature == "avx2" || feature == "avx512" || feature == "avx512vnni";
+}
+}  // namespace
+
 StageResult LLVMBeforeLowerFunc(Stmt &stmt, LowerData &data) {
   stmt = NEXT_PASS_IF(!data->simple_mode, LoopPartition, stmt, data->config->partition_const_loop);
+  stmt = NEXT_PASS_IF(g_attrs.GetBool(kEnableCpuParallelScan, true), ParallelizeCpuScan, stmt,
+                      g_attrs.GetInt(kCpuThreadNum, kDefaultCpuThreadNum));
   stmt = NEXT_PASS_IF(data->config->disable_vectorize, SkipVectorize, stmt);
+  stmt = NEXT_PASS_IF(!data->config->disable_vectorize && g_attrs.GetBool(kEnableCpuGather, true),
+                      SelectVectorizedBranch, stmt);
   stmt = NEXT_PASS_IF(!data->config->disable_vectorize, VectorizeLoop, stmt);
+  stmt = NEXT_PASS_IF(data->polyhedral && g_attrs.GetBool(kEnableCpuStreamHint, false), InjectCpuStreamHint, stmt,
+                      data->arg_list_0);
+  stmt = NEXT_PASS_IF(data->polyhedral && g_attrs.GetBool(kEnableCpuInt8Dot, true) &&
+                        HasInt8Dot(g_attrs.GetStr(ir::ATTR_CONV_FEATURE_NAME, "")),
+                      EmitCpuInt8Dot, stmt);
+  std::string math_accuracy = g_attrs.GetStr(kCpuMathAccuracy, "precise");
+  CHECK(math_accuracy == "precise" || math_accuracy == "fast")
+    << "cpu_math_accuracy should be precise or fast, now is " << math_accuracy;
+  stmt = NEXT_PASS_IF(math_accuracy == "fast", UseFastMath, stmt);
   stmt = NEXT_PASS(UnrollLoop, stmt, data->config->auto_unroll_max_step, data->config->auto_unroll_max_depth,
                    data->config->auto_unroll_max_extent, data->config->unroll_explicit);
   return {stmt, false};
@@ -53,6 +53,7 @@ constexpr auto kEnableDoubleBuffer = "enable_double_buffer";
 constexpr auto kEnableQuadrupleBuffer = "enable_quadruple_buffer";
 constexpr auto kEnableTransferBuffer = "enable_transfer_buffer";
 constexpr auto kEnableThreadGroup = "enable_thread_group";
+constexpr auto kSharedPipelineStages = "shared_pipeline_stages";
 constexpr auto kEnableUnrollLoop = "enable_unroll_loop";
 constexpr auto kAlgebraSimplify = "enable_algebra_simplify";
 constexpr auto kPromoteCommonExpr = "promote_common_expr";
@@ -87,6 +88,18 @@ constexpr auto kEnableHoistCondWrite = "enable_hoist_cond_write";
 constexpr double kUsPerSecond = 1e6;
 constexpr size_t kMaxNumOfPassTimeToPrint = 5;
 constexpr auto kIsDynamic = "is_dynamic";
+constexpr auto kShapeBuckets = "shape_buckets";
+constexpr auto kShapeBucketMax = "shape_bucket_max";
+constexpr auto kEnableCpuStreamHint = "enable_cpu_stream_hint";
+constexpr auto kEnableCpuInt8Dot = "enable_cpu_int8_dot";
+constexpr auto kEnableCpuGather = "enable_cpu_gather";
+constexpr auto kEnableCpuSegmentPrivatize = "enable_cpu_segment_privatize";
+constexpr auto kCpuThreadNum = "cpu_thread_num";
+// the thread count of the cpu tiling strategy, independent of the machine that compiles
+constexpr int kDefaultCpuThreadNum = 8;
+constexpr auto kEnableCpuParallelScan = "enable_cpu_parallel_scan";
+constexpr auto kEnableCpuGemmEpilogue = "enable_cpu_gemm_epilogue";
+constexpr auto kCpuMathAccuracy = "cpu_math_accuracy";
 constexpr auto kEnableConvAnalyzeAlign = "enable_conv_analyze_align";
 constexpr auto kEnableHoistAllocate = "enable_hoist_allocate";
 constexpr auto kEnableScalarAlign = "enable_scalar_align";
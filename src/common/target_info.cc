@@ -46,8 +46,14 @@ TVM_STATIC_IR_FUNCTOR(IRPrinter, vtable).set_dispatch<GpuComputeInfoNode>([](con
   p->stream << "compute-info("
             << "num_sm=" << op->num_sm << ", "
             << "active_blocks_per_sm=" << op->active_blocks_per_sm << ", "
-            << "min_elem_for_io_bound=" << op->min_elem_for_io_bound << ","
-            << ")";
+            << "min_elem_for_io_bound=" << op->min_elem_for_io_bound << ", "
+            << "max_threads_per_sm=" << op->max_threads_per_sm << ", "
+            << "max_blocks_per_sm=" << op->max_blocks_per_sm << ", "
+            << "regs_per_sm=" << op->regs_per_sm << ", "
+            << "max_regs_per_thread=" << op->max_regs_per_thread << ", "
+            << "shared_bytes_per_sm=" << op->shared_bytes_per_sm << ", "
+            << "peak_gflops=" << op->peak_gflops << ", "
+            << "mem_bandwidth_gbps=" << op->mem_bandwidth_gbps << ")";
 });
 
 TVM_REGISTER_NODE_TYPE(GpuComputeInfoNode);
@@ -62,10 +62,38 @@ struct GpuComputeInfoNode : public Node {
   /*! \brief The minimal number of for-loop size for io-bounded ops */
   int min_elem_for_io_bound;
 
+  /*! \brief The maximum number of resident threads per sm */
+  int max_threads_per_sm;
+
+  /*! \brief The maximum number of resident blocks per sm */
+  int max_blocks_per_sm;
+
+  /*! \brief The number of 32-bit registers per sm */
+  int regs_per_sm;
+
+  /*! \brief The maximum number of 32-bit registers per thread */
+  int max_regs_per_thread;
+
+  /*! \brief The number of bytes of shared memory per sm */
+  int shared_bytes_per_sm;
+
+  /*! \brief The peak fp32 throughput of the whole device in GFLOP/s */
+  int peak_gflops;
+
+  /*! \brief The peak global memory bandwidth of the whole device in GB/s */
+  int mem_bandwidth_gbps;
+
   void VisitAttrs(AttrVisitor *v) {
     v->Visit("num_sm", &num_sm);
     v->Visit("active_blocks_per_sm", &active_blocks_per_sm);
     v->Visit("min_elem_for_io_bound", &min_elem_for_io_bound);
+    v->Visit("max_threads_per_sm", &max_threads_per_sm);
+    v->Visit("max_blocks_per_sm", &max_blocks_per_sm);
+    v->Visit("regs_per_sm", &regs_per_sm);
+    v->Visit("max_regs_per_thread", &max_regs_per_thread);
+    v->Visit("shared_bytes_per_sm", &shared_bytes_per_sm);
+    v->Visit("peak_gflops", &peak_gflops);
+    v->Visit("mem_bandwidth_gbps", &mem_bandwidth_gbps);
   }
 
   static constexpr const char *_type_key = "GpuComputeInfo";
@@ -0,0 +1,562 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "composite/composite_batch.h"
+
+#include <dirent.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "composite/lower_tree/base_node.h"
+#include "composite/utils/util.h"
+
+namespace akg {
+namespace lower {
+namespace {
+constexpr auto kJsonStr = "json_str";
+constexpr auto kOpDesc = "op_desc";
+constexpr auto kName = "name";
+constexpr auto kOp = "op";
+constexpr auto kKernelName = "kernel_name";
+// gemm and conv kernels spend most of their compile time in the polyhedral scheduler
+constexpr int64_t kHeavyOpCost = 8;
+const std::set<std::string> kHeavyOps = {"MatMul", "BatchMatMul", "Conv2D"};
+
+using Clock = std::chrono::steady_clock;
+
+// picojson objects are unordered maps, so the keys are sorted to make the text independent of the input
+void CanonicalizeJson(const picojson::value &value, std::ostringstream &os) {
+  if (value.is<picojson::object>()) {
+    const auto &obj = value.get<picojson::object>();
+    std::vector<std::string> keys;
+    for (const auto &it : obj) {
+      keys.push_back(it.first);
+    }
+    std::sort(keys.begin(), keys.end());
+    os << "{";
+    for (const auto &k : keys) {
+      os << picojson::value(k).serialize() << ":";
+      CanonicalizeJson(obj.at(k), os);
+      os << ",";
+    }
+    os << "}";
+  } else if (value.is<picojson::array>()) {
+    os << "[";
+    for (const auto &it : value.get<picojson::array>()) {
+      CanonicalizeJson(it, os);
+      os << ",";
+    }
+    os << "]";
+  } else {
+    os << value.serialize();
+  }
+}
+
+// The kernel names are left out of the text and collected in names, in the order of the text.
+void Canonicalize(const NodeRef &node, const std::string &key, std::ostringstream &os,
+                  std::vector<std::string> *names) {
+  if (!node.defined()) {
+    os << "null";
+  } else if (auto str = node.as<StringImm>()) {
+    if (key == kJsonStr) {
+      auto json = String2Json(str->value);
+      if (json.is<picojson::object>() && json.contains(kOp) && json.get(kOp).is<std::string>()) {
+        names->push_back(json.get(kOp).get<std::string>());
+        json.get<picojson::object>().erase(kOp);
+      }
+      CanonicalizeJson(json, os);
+    } else if (key == kKernelName) {
+      names->push_back(str->value);
+    } else {
+      os << '"' << str->value << '"';
+    }
+  } else if (auto imm = node.as<IntImm>()) {
+    os << imm->type << ":" << imm->value;
+  } else if (auto imm = node.as<air::ir::UIntImm>()) {
+    os << imm->type << ":" << imm->value;
+  } else if (auto imm = node.as<FloatImm>()) {
+    os << imm->type << ":" << imm->value;
+  } else if (node->IsInstance<air::StrMapNode>()) {
+    auto map = Downcast<Map<std::string, NodeRef>>(node);
+    std::vector<std::string> keys;
+    for (const auto &it : map) {
+      keys.push_back(it.first);
+    }
+    std::sort(keys.begin(), keys.end());
+    os << "{";
+    for (const auto &k : keys) {
+      os << '"' << k << "\":";
+      Canonicalize(map[k], k, os, names);
+      os << ",";
+    }
+    os << "}";
+  } else if (node->IsInstance<air::ArrayNode>()) {
+    os << "[";
+    for (const auto &it : Downcast<Array<NodeRef>>(node)) {
+      Canonicalize(it, key, os, names);
+      os << ",";
+    }
+    os << "]";
+  } else {
+    os << node;
+  }
+}
+
+std::string GetStr(const Map<std::string, NodeRef> &kernel, const std::string &key) {
+  CHECK(kernel.count(key)) << "batch kernel misses " << key;
+  auto str = kernel[key].as<StringImm>();
+  CHECK(str) << "batch kernel " << key << " should be a string";
+  return str->value;
+}
+
+bool GetPoly(const Map<std::string, NodeRef> &kernel) {
+  CHECK(kernel.count(kBatchPoly)) << "batch kernel misses " << kBatchPoly;
+  auto imm = kernel[kBatchPoly].as<IntImm>();
+  if (imm != nullptr) {
+    return imm->value != 0;
+  }
+  auto uimm = kernel[kBatchPoly].as<air::ir::UIntImm>();
+  CHECK(uimm) << "batch kernel " << kBatchPoly << " should be an integer";
+  return uimm->value != 0;
+}
+
+Module CompileKernel(const Map<std::string, NodeRef> &kernel) {
+  CHECK(kernel.count(kBatchSegmentInfos)) << "batch kernel misses " << kBatchSegmentInfos;
+  return LowerCompositeToModule(GetStr(kernel, kBatchTarget), GetPoly(kernel), GetStr(kernel, kBatchSegmentTree),
+                                Downcast<Map<std::string, NodeRef>>(kernel[kBatchSegmentInfos]));
+}
+
+// The passes keep their state in globals, so kernels are compiled in parallel only in separate processes. Only llvm
+// modules can be handed back to the caller through a file, and only their text can be renamed for another kernel.
+bool IsLlvmKernel(const Map<std::string, NodeRef> &kernel) {
+  return GetRealTarget(GetStr(kernel, kBatchTarget)).compare(0, strlen(kLlvm), kLlvm) == 0;
+}
+
+// fork copies only the calling thread, a lock that another thread holds stays locked in the child
+bool IsSingleThreaded() {
+  DIR *dir = opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return false;
+  }
+  int threads = 0;
+  while (auto entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      ++threads;
+    }
+  }
+  closedir(dir);
+  return threads == 1;
+}
+
+struct KernelResult {
+  Module module;
+  std::string error;
+  double seconds{0.0};
+};
+
+struct Worker {
+  size_t slot;
+  pid_t pid;
+  int fd;
+  std::string error;
+  Clock::time_point start;
+};
+
+class BatchCompiler {
+ public:
+  BatchCompiler(const Array<Map<std::string, NodeRef>> &kernels, const std::vector<std::vector<std::string>> &names,
+                const BatchPlan &plan, int num_workers, const PackedFunc &on_done)
+      : kernels_(kernels), names_(names), plan_(plan), num_workers_(num_workers), on_done_(on_done) {
+    members_.resize(plan.leaders.size());
+    for (size_t i = 0; i < plan.slot_of.size(); ++i) {
+      members_[plan.slot_of[i]].push_back(i);
+    }
+    results_.resize(plan.leaders.size());
+    result_.modules.resize(plan.slot_of.size());
+    result_.errors.resize(plan.slot_of.size());
+  }
+
+  ~BatchCompiler() {
+    if (!dir_.empty()) {
+      rmdir(dir_.c_str());
+    }
+  }
+
+  void Run() {
+    std::vector<size_t> local;
+    std::vector<size_t> forked;
+    for (size_t slot = 0; slot < plan_.leaders.size(); ++slot) {
+      if (num_workers_ > 1 && IsLlvmKernel(kernels_[plan_.leaders[slot]])) {
+        forked.push_back(slot);
+      } else {
+        local.push_back(slot);
+      }
+    }
+    if (!forked.empty()) {
+      RunWorkers(forked);
+    }
+    for (auto slot : local) {
+      auto start = Clock::now();
+      try {
+        results_[slot].module = CompileKernel(kernels_[plan_.leaders[slot]]);
+        if (!results_[slot].module.defined()) {
+          results_[slot].error = "no function was lowered";
+        }
+      } catch (const std::exception &e) {
+        results_[slot].error = e.what();
+      }
+      Finish(slot, Seconds(start));
+    }
+  }
+
+  const BatchResult &Result() const { return result_; }
+
+ private:
+  static double Seconds(const Clock::time_point &start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  const std::string &TempDir() {
+    if (dir_.empty()) {
+      const char *tmp = getenv("TMPDIR");
+      std::string dir_template = std::string(tmp != nullptr ? tmp : "/tmp") + "/akg_batch_XXXXXX";
+      std::vector<char> dir_buf(dir_template.begin(), dir_template.end());
+      dir_buf.push_back('\0');
+      CHECK(mkdtemp(dir_buf.data()) != nullptr) << "Failed to create a directory from " << dir_template;
+      dir_ = dir_buf.data();
+    }
+    return dir_;
+  }
+
+  void RunWorkers(const std::vector<size_t> &slots) {
+    TempDir();
+    size_t next = 0;
+    std::vector<Worker> running;
+    while (next < slots.size() || !running.empty()) {
+      while (next < slots.size() && running.size() < static_cast<size_t>(num_workers_)) {
+        running.push_back(Spawn(slots[next++]));
+      }
+      std::vector<struct pollfd> fds;
+      for (const auto &worker : running) {
+        fds.push_back({worker.fd, POLLIN, 0});
+      }
+      CHECK_GE(poll(fds.data(), fds.size(), -1), 0) << "poll on the compile workers failed";
+      for (size_t i = fds.size(); i-- > 0;) {
+        if (fds[i].revents == 0) {
+          continue;
+        }
+        char buf[4096];
+        ssize_t n = read(running[i].fd, buf, sizeof(buf));
+        if (n > 0) {
+          running[i].error.append(buf, static_cast<size_t>(n));
+          continue;
+        }
+        Reap(running[i]);
+        running.erase(running.begin() + i);
+      }
+    }
+  }
+
+  std::string ModulePath(size_t slot) const { return dir_ + "/kernel_" + std::to_string(slot) + ".ll"; }
+
+  // the module of the leader with its kernel names replaced by the ones of the descriptor
+  Module RenamedModule(size_t slot, size_t index) {
+    const auto &from = names_[plan_.leaders[slot]];
+    const auto &to = names_[index];
+    if (from == to) {
+      return results_[slot].module;
+    }
+    std::string path = TempDir() + "/kernel_" + std::to_string(slot) + "_" + std::to_string(index) + ".ll";
+    {
+      std::ofstream out(path);
+      out << ReplaceNames(results_[slot].module->GetSource("ll"), from, to);
+    }
+    Module mod;
+    try {
+      mod = Module::LoadFromFile(path, "ll");
+    } catch (...) {
+      std::remove(path.c_str());
+      throw;
+    }
+    std::remove(path.c_str());
+    return mod;
+  }
+
+  Worker Spawn(size_t slot) {
+    int fds[2];
+    CHECK_EQ(pipe(fds), 0) << "Failed to create a pipe for the compile worker";
+    Worker worker{slot, -1, fds[0], "", Clock::now()};
+    worker.pid = fork();
+    CHECK_GE(worker.pid, 0) << "Failed to fork a compile worker";
+    if (worker.pid == 0) {
+      close(fds[0]);
+      std::string error;
+      try {
+        Module mod = CompileKernel(kernels_[plan_.leaders[slot]]);
+        if (mod.defined()) {
+          mod->SaveToFile(ModulePath(slot), "ll");
+        } else {
+          error = "no function was lowered";
+        }
+      } catch (const std::exception &e) {
+        error = e.what();
+      }
+      size_t offset = 0;
+      while (offset < error.size()) {
+        ssize_t n = write(fds[1], error.data() + offset, error.size() - offset);
+        if (n <= 0) {
+          break;
+        }
+        offset += static_cast<size_t>(n);
+      }
+      // skip the exit handlers of the embedding process
+      _exit(error.empty() ? 0 : 1);
+    }
+    close(fds[1]);
+    return worker;
+  }
+
+  void Reap(Worker &worker) {
+    close(worker.fd);
+    int status = 0;
+    waitpid(worker.pid, &status, 0);
+    auto &result = results_[worker.slot];
+    std::string path = ModulePath(worker.slot);
+    if (WIFSIGNALED(status)) {
+      result.error = "compile worker was killed by signal " + std::to_string(WTERMSIG(status));
+    } else if (WEXITSTATUS(status) != 0 || !worker.error.empty()) {
+      result.error = worker.error.empty() ? "compile worker failed" : worker.error;
+    } else {
+      try {
+        result.module = Module::LoadFromFile(path, "ll");
+      } catch (const std::exception &e) {
+        result.error = e.what();
+      }
+    }
+    std::remove(path.c_str());
+    Finish(worker.slot, Seconds(worker.start));
+  }
+
+  void Finish(size_t slot, double seconds) {
+    auto &result = results_[slot];
+    result.seconds = seconds;
+    if (!result.error.empty()) {
+      LOG(WARNING) << "Compile of batch kernel " << plan_.leaders[slot] << " failed: " << result.error;
+    }
+    for (auto index : members_[slot]) {
+      ++done_;
+      auto &error = result_.errors[index];
+      error = result.error;
+      if (error.empty()) {
+        try {
+          result_.modules[index] = RenamedModule(slot, index);
+        } catch (const std::exception &e) {
+          error = e.what();
+        }
+      }
+      if (on_done_ == nullptr) {
+        continue;
+      }
+      auto i = static_cast<int64_t>(index);
+      auto done = static_cast<int64_t>(done_);
+      auto total = static_cast<int64_t>(plan_.slot_of.size());
+      if (error.empty()) {
+        on_done_(i, seconds, done, total, result_.modules[index]);
+      } else {
+        on_done_(i, seconds, done, total, error);
+      }
+    }
+  }
+
+  const Array<Map<std::string, NodeRef>> &kernels_;
+  const std::vector<std::vector<std::string>> &names_;
+  const BatchPlan &plan_;
+  int num_workers_;
+  const PackedFunc &on_done_;
+  std::vector<std::vector<size_t>> members_;
+  std::vector<KernelResult> results_;
+  BatchResult result_;
+  std::string dir_;
+  size_t done_{0};
+};
+}  // namespace
+
+std::string CanonicalizeKernel(const Map<std::string, NodeRef> &kernel, std::vector<std::string> *names) {
+  std::ostringstream os;
+  std::vector<std::string> kernel_names;
+  Canonicalize(kernel, "", os, &kernel_names);
+  if (names != nullptr) {
+    *names = kernel_names;
+  }
+  return os.str();
+}
+
+std::string ReplaceNames(const std::string &text, const std::vector<std::string> &from,
+                         const std::vector<std::string> &to) {
+  CHECK_EQ(from.size(), to.size());
+  std::string res;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    // the longest name wins, so that a name is not replaced inside a longer one
+    size_t match = from.size();
+    for (size_t i = 0; i < from.size(); ++i) {
+      if (!from[i].empty() && text.compare(pos, from[i].size(), from[i]) == 0 &&
+          (match == from.size() || from[i].size() > from[match].size())) {
+        match = i;
+      }
+    }
+    if (match == from.size()) {
+      res.push_back(text[pos++]);
+    } else {
+      res.append(to[match]);
+      pos += from[match].size();
+    }
+  }
+  return res;
+}
+
+int64_t EstimateCompileCost(const Map<std::string, NodeRef> &kernel) {
+  int64_t cost = 0;
+  std::function<void(const NodeRef &, const std::string &)> visit = [&cost, &visit](const NodeRef &node,
+                                                                                    const std::string &key) {
+    if (!node.defined()) {
+      return;
+    }
+    if (auto str = node.as<StringImm>()) {
+      if (key != kJsonStr) {
+        return;
+      }
+      auto json = String2Json(str->value);
+      if (!json.contains(kOpDesc) || !json.get(kOpDesc).is<picojson::array>()) {
+        return;
+      }
+      for (const auto &op : json.get(kOpDesc).get<picojson::array>()) {
+        bool heavy = op.contains(kName) && op.get(kName).is<std::string>() &&
+                     kHeavyOps.count(op.get(kName).get<std::string>()) > 0;
+        cost += heavy ? kHeavyOpCost : 1;
+      }
+    } else if (node->IsInstance<air::StrMapNode>()) {
+      for (const auto &it : Downcast<Map<std::string, NodeRef>>(node)) {
+        visit(it.second, it.first);
+      }
+    } else if (node->IsInstance<air::ArrayNode>()) {
+      for (const auto &it : Downcast<Array<NodeRef>>(node)) {
+        visit(it, key);
+      }
+    }
+  };
+  visit(kernel, "");
+  return cost;
+}
+
+BatchPlan PlanBatch(const std::vector<std::string> &keys, const std::vector<int64_t> &costs) {
+  CHECK_EQ(keys.size(), costs.size());
+  BatchPlan plan;
+  plan.slot_of.resize(keys.size());
+  std::unordered_map<std::string, size_t> first_of;
+  std::vector<size_t> leaders;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (first_of.emplace(keys[i], leaders.size()).second) {
+      leaders.push_back(i);
+    }
+  }
+  // the longest compiles start first so that they do not end up alone at the tail of the batch
+  std::vector<size_t> order(leaders.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&leaders, &costs](size_t a, size_t b) { return costs[leaders[a]] > costs[leaders[b]]; });
+  std::vector<size_t> slot_of_group(leaders.size());
+  for (size_t slot = 0; slot < order.size(); ++slot) {
+    plan.leaders.push_back(leaders[order[slot]]);
+    slot_of_group[order[slot]] = slot;
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    plan.slot_of[i] = slot_of_group[first_of[keys[i]]];
+  }
+  return plan;
+}
+
+BatchResult LowerCompositeBatchToModule(const Array<Map<std::string, NodeRef>> &kernels, int num_workers,
+                                        const PackedFunc &on_done) {
+  auto start = Clock::now();
+  std::vector<std::string> keys;
+  std::vector<std::vector<std::string>> names(kernels.size());
+  std::vector<int64_t> costs;
+  for (size_t i = 0; i < kernels.size(); ++i) {
+    std::string key;
+    int64_t cost = 0;
+    try {
+      key = CanonicalizeKernel(kernels[i], &names[i]);
+      cost = EstimateCompileCost(kernels[i]);
+    } catch (const std::exception &e) {
+      // a kernel that cannot be parsed shares nothing, its compile fails and reports the error
+      key = "\ninvalid kernel " + std::to_string(i);
+      names[i].clear();
+    }
+    if (!IsLlvmKernel(kernels[i])) {
+      // these modules cannot be renamed, so only kernels of the same name share one
+      for (const auto &name : names[i]) {
+        key += "\n" + name;
+      }
+    }
+    keys.push_back(key);
+    costs.push_back(cost);
+  }
+  BatchPlan plan = PlanBatch(keys, costs);
+  if (num_workers <= 0) {
+    num_workers = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1U));
+  }
+  num_workers = std::min(num_workers, static_cast<int>(std::max(plan.leaders.size(), size_t{1})));
+  if (num_workers > 1 && !IsSingleThreaded()) {
+    LOG(WARNING) << "The calling process runs several threads and cannot fork compile workers safely, the batch is "
+                    "compiled in it one kernel after another";
+    num_workers = 1;
+  }
+
+  BatchCompiler compiler(kernels, names, plan, num_workers, on_done);
+  compiler.Run();
+  LOG(INFO) << "Compiled " << kernels.size() << " composite kernels (" << plan.leaders.size() << " distinct) with "
+            << num_workers << " workers in " << std::chrono::duration<double>(Clock::now() - start).count() << "s";
+  return compiler.Result();
+}
+
+// The modules reach python only through on_done, an Array cannot hand them over.
+Array<NodeRef> LowerCompositeBatchErrors(const Array<Map<std::string, NodeRef>> &kernels, int num_workers,
+                                         const PackedFunc &on_done) {
+  CHECK(on_done != nullptr) << "lower_composite_batch_to_module needs the on_done callback";
+  Array<NodeRef> errors;
+  for (const auto &error : LowerCompositeBatchToModule(kernels, num_workers, on_done).errors) {
+    errors.push_back(StringImm::make(error));
+  }
+  return errors;
+}
+}  // namespace lower
+
+TVM_REGISTER_GLOBAL("lower_composite_batch_to_module").set_body_typed(lower::LowerCompositeBatchErrors);
+}  // namespace akg
@@ -0,0 +1,77 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef COMPOSITE_COMPOSITE_BATCH_H_
+#define COMPOSITE_COMPOSITE_BATCH_H_
+
+#include <string>
+#include <vector>
+#include "tvm.h"
+
+namespace akg {
+namespace lower {
+constexpr auto kBatchTarget = "target";
+constexpr auto kBatchPoly = "poly";
+constexpr auto kBatchSegmentTree = "segment_tree";
+constexpr auto kBatchSegmentInfos = "segment_infos";
+
+Module LowerCompositeToModule(const std::string &target, bool poly, const std::string &segment_tree_str,
+                              const Map<std::string, NodeRef> &segment_infos);
+
+/// \brief Text that is equal for two descriptors exactly when they compile to the same kernel up to its names. Maps
+/// are written with sorted keys and the kernel jsons are re-serialized, so key order does not matter.
+/// \param[out] names The kernel names left out of the text, in the order of the text
+std::string CanonicalizeKernel(const Map<std::string, NodeRef> &kernel, std::vector<std::string> *names = nullptr);
+
+/// \brief Replace every occurrence of from[i] in text by to[i], the longest name first where several match
+std::string ReplaceNames(const std::string &text, const std::vector<std::string> &from,
+                         const std::vector<std::string> &to);
+
+/// \brief Relative compile time of a descriptor, from the ops of its kernel jsons
+int64_t EstimateCompileCost(const Map<std::string, NodeRef> &kernel);
+
+struct BatchPlan {
+  // index into leaders of the kernel that is compiled for each descriptor
+  std::vector<size_t> slot_of;
+  // first descriptor of each distinct kernel, most expensive first
+  std::vector<size_t> leaders;
+};
+
+/// \brief Group equal keys and order the groups by descending cost, keeping the input order between equal costs
+BatchPlan PlanBatch(const std::vector<std::string> &keys, const std::vector<int64_t> &costs);
+
+struct BatchResult {
+  // per descriptor, undefined where the compile failed
+  std::vector<Module> modules;
+  // per descriptor, empty on success
+  std::vector<std::string> errors;
+};
+
+/// \brief Compile a list of composite descriptors. Llvm descriptors that differ only in their kernel names are
+/// compiled once and the module is renamed for the others.
+/// \param[in] kernels Descriptors with the arguments of LowerCompositeToModule: target, poly, segment_tree and
+///            segment_infos
+/// \param[in] num_workers Kernels compiled at the same time, the number of cores when not positive. Llvm kernels are
+///            compiled in forked processes, the others in the calling process one after another. fork is only safe
+///            while the calling process runs a single thread, otherwise every kernel is compiled in the calling
+///            process.
+/// \param[in] on_done Optional, called in the calling process for every descriptor once its kernel is compiled, with
+///            (index, seconds, done, total, module) on success and (index, seconds, done, total, error) on failure
+/// \return The modules and errors indexed like kernels
+BatchResult LowerCompositeBatchToModule(const Array<Map<std::string, NodeRef>> &kernels, int num_workers,
+                                        const PackedFunc &on_done);
+}  // namespace lower
+}  // namespace akg
+#endif  // COMPOSITE_COMPOSITE_BATCH_H_
@@ -792,6 +792,10 @@ void BatchMatMul(const TVMArgs &args, TVMRetValue *rv) {
     if (dst_type == "float32") {
       left_buffer = Cast::make(Float(BIT32), left_buffer);
       right_buffer = Cast::make(Float(BIT32), right_buffer);
+    } else if (dst_type == "int32") {
+      // quantized matmul, uint8 x int8 accumulated in int32
+      left_buffer = Cast::make(Int(BIT32), left_buffer);
+      right_buffer = Cast::make(Int(BIT32), right_buffer);
     }
 
     auto matrix_mul = Mul::make(left_buffer, right_buffer);
@@ -0,0 +1,380 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include "composite/optimize/pass.h"
+
+namespace akg {
+namespace {
+using FoldFunc = std::function<double(const std::vector<double> &)>;
+using FuncExprMap = std::unordered_map<FunctionRef, Expr, NodeHash, NodeEqual>;
+
+// scalar maths of the elemwise ops, evaluated in double and rounded to the output type by RoundToType
+const std::unordered_map<std::string, FoldFunc> &FoldableOps() {
+  static const std::unordered_map<std::string, FoldFunc> ops = {
+    {"Add", [](const std::vector<double> &v) { return v[0] + v[1]; }},
+    {"Sub", [](const std::vector<double> &v) { return v[0] - v[1]; }},
+    {"Mul", [](const std::vector<double> &v) { return v[0] * v[1]; }},
+    {"RealDiv", [](const std::vector<double> &v) { return v[0] / v[1]; }},
+    {"Maximum", [](const std::vector<double> &v) { return std::max(v[0], v[1]); }},
+    {"Minimum", [](const std::vector<double> &v) { return std::min(v[0], v[1]); }},
+    {"Pow", [](const std::vector<double> &v) { return std::pow(v[0], v[1]); }},
+    {"Neg", [](const std::vector<double> &v) { return -v[0]; }},
+    {"Abs", [](const std::vector<double> &v) { return std::fabs(v[0]); }},
+    {"Reciprocal", [](const std::vector<double> &v) { return 1.0 / v[0]; }},
+    {"Sqrt", [](const std::vector<double> &v) { return std::sqrt(v[0]); }},
+    {"Rsqrt", [](const std::vector<double> &v) { return 1.0 / std::sqrt(v[0]); }},
+    {"Exp", [](const std::vector<double> &v) { return std::exp(v[0]); }},
+    {"Log", [](const std::vector<double> &v) { return std::log(v[0]); }},
+    {"Cast", [](const std::vector<double> &v) { return v[0]; }},
+  };
+  return ops;
+}
+
+// ops whose integer result is not the double result truncated
+const std::unordered_set<std::string> kFloatOnlyOps = {"RealDiv", "Pow", "Reciprocal", "Sqrt", "Rsqrt", "Exp", "Log"};
+
+// The float16 nearest to v, to even on ties, inf beyond the largest float16.
+double RoundToFloat16(double v) {
+  constexpr int kMantissaBits = 10;
+  constexpr int kMinExp = -14;
+  constexpr double kMaxFloat16 = 65504.0;
+  if (v == 0.0 || !std::isfinite(v)) {
+    return v;
+  }
+  int exp = 0;
+  (void)std::frexp(v, &exp);
+  // the spacing of the float16 values around v, subnormals share the spacing of the smallest normals
+  double step = std::ldexp(1.0, std::max(exp - 1, kMinExp) - kMantissaBits);
+  double res = std::nearbyint(v / step) * step;
+  return std::fabs(res) > kMaxFloat16 ? std::copysign(std::numeric_limits<double>::infinity(), v) : res;
+}
+
+// Rounds the double result of a fold to the value type t holds, so the next fold starts from that value.
+double RoundToType(const Type &t, double v) {
+  if (!t.is_float()) {
+    // make_const truncates to the integer type
+    return v;
+  }
+  if (t.bits() == 16) {
+    return RoundToFloat16(v);
+  }
+  if (t.bits() == 32) {
+    return static_cast<double>(static_cast<float>(v));
+  }
+  return v;
+}
+
+bool GetConstValue(const Expr &e, double *value) {
+  if (e.type().is_bool()) {
+    return false;
+  }
+  if (auto imm = e.as<IntImm>()) {
+    *value = static_cast<double>(imm->value);
+  } else if (auto imm = e.as<UIntImm>()) {
+    *value = static_cast<double>(imm->value);
+  } else if (auto imm = e.as<FloatImm>()) {
+    *value = imm->value;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// The tensors that must stay as they are: the outputs of the kernel and the targets of Assign and InplaceAssign.
+FuncRefSet PinnedFuncs(const Stmt &s, const BuildInfo *info) {
+  FuncRefSet pinned(info->opt.output_funcs.begin(), info->opt.output_funcs.end());
+  PostOrderVisit(s, [&pinned](const NodeRef &node) {
+    auto provide = node.as<Provide>();
+    if (provide == nullptr) {
+      return;
+    }
+    auto call = provide->value.as<Call>();
+    if (call != nullptr && (IsAssign(call->name) || IsInplaceAssign(call->name)) && !call->args.empty()) {
+      if (auto target = call->args[0].as<Call>()) {
+        pinned.insert(target->func);
+      }
+    }
+  });
+  return pinned;
+}
+
+// Drops the attrs of the ops a pass removed, so no AttrStmt wraps an empty body.
+class RemovedOpCleaner : public IRMutator {
+ public:
+  Stmt Mutate_(const AttrStmt *op, const Stmt &s) override {
+    auto stmt = IRMutator::Mutate_(op, s);
+    auto attr = stmt.as<AttrStmt>();
+    if (attr != nullptr && attr->attr_key == "attrs" && is_no_op(attr->body)) {
+      return Evaluate::make(0);
+    }
+    return stmt;
+  }
+};
+
+class ConstantAnalysis : public IRVisitor {
+ public:
+  explicit ConstantAnalysis(const FuncRefSet &pinned) : pinned_(pinned) {}
+
+  void Visit_(const Provide *op) override {
+    auto call = op->value.as<Call>();
+    if (call == nullptr) {
+      return;
+    }
+    provides_.push_back(op);
+    std::vector<double> values;
+    bool all_const = true;
+    for (const auto &arg : call->args) {
+      double value = 0.0;
+      if (auto tensor = arg.as<Call>()) {
+        auto it = consts_.find(tensor->func);
+        all_const = all_const && it != consts_.end() && GetConstValue(it->second, &value);
+      } else {
+        all_const = all_const && GetConstValue(arg, &value);
+      }
+      values.push_back(value);
+    }
+    auto fold = FoldableOps().find(call->name);
+    if (!all_const || fold == FoldableOps().end() || !ShapeIsOne(op->args) || pinned_.count(op->func) ||
+        call->type.is_bool() || call->type.lanes() != 1 ||
+        (!call->type.is_float() && kFloatOnlyOps.count(call->name))) {
+      return;
+    }
+    double res = RoundToType(call->type, fold->second(values));
+    if (!std::isfinite(res)) {
+      return;
+    }
+    consts_[op->func] = make_const(call->type, res);
+  }
+
+  // A tensor is folded when every consumer is an elemwise op, which takes a scalar in its place, and a consumer
+  // that is not folded keeps one tensor input at least.
+  FuncRefSet Folded() {
+    FuncRefSet folded;
+    for (const auto &it : consts_) {
+      folded.insert(it.first);
+    }
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (auto p : provides_) {
+        auto call = p->value.as<Call>();
+        bool kept = folded.count(p->func) == 0;
+        std::vector<FunctionRef> inputs;
+        for (const auto &arg : call->args) {
+          if (auto tensor = arg.as<Call>()) {
+            inputs.push_back(tensor->func);
+          }
+        }
+        bool all_folded = !inputs.empty();
+        for (const auto &input : inputs) {
+          all_folded = all_folded && folded.count(input);
+        }
+        for (const auto &input : inputs) {
+          if (folded.count(input) && (!IsElemwise(call->name) || (kept && all_folded))) {
+            folded.erase(input);
+            changed = true;
+          }
+        }
+      }
+    }
+    return folded;
+  }
+  const FuncExprMap &Values() const { return consts_; }
+
+ private:
+  const FuncRefSet &pinned_;
+  std::vector<const Provide *> provides_;
+  FuncExprMap consts_;
+};
+
+class ConstantSubstituter : public IRMutator {
+ public:
+  ConstantSubstituter(const FuncRefSet &folded, const FuncExprMap &values) : folded_(folded), values_(values) {}
+
+ private:
+  Stmt Mutate_(const Provide *op, const Stmt &s) override {
+    if (folded_.count(op->func)) {
+      return Evaluate::make(0);
+    }
+    return IRMutator::Mutate_(op, s);
+  }
+  Expr Mutate_(const Call *op, const Expr &e) override {
+    if (op->call_type == Call::CallType::Halide && folded_.count(op->func)) {
+      return values_.at(op->func);
+    }
+    return IRMutator::Mutate_(op, e);
+  }
+
+  const FuncRefSet &folded_;
+  const FuncExprMap &values_;
+};
+
+bool EqualAttrValue(const ObjectRef &a, const ObjectRef &b) {
+  if (a.same_as(b)) {
+    return true;
+  }
+  if (!a.defined() || !b.defined()) {
+    return false;
+  }
+  if (a->IsInstance<ExprNode>() && b->IsInstance<ExprNode>()) {
+    return Equal(Downcast<Expr>(a), Downcast<Expr>(b));
+  }
+  auto arr_a = a.as<air::ArrayNode>();
+  auto arr_b = b.as<air::ArrayNode>();
+  if (arr_a != nullptr && arr_b != nullptr) {
+    if (arr_a->data.size() != arr_b->data.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < arr_a->data.size(); ++i) {
+      if (!EqualAttrValue(arr_a->data[i], arr_b->data[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+struct OpInstance {
+  FunctionRef output;
+  const Call *call;
+  Array<Expr> shape;
+  Map<std::string, NodeRef> attrs;
+};
+
+// The attrs are equal but for the format key of the output, whose name differs, and whose values are compared.
+bool EqualAttrs(const OpInstance &a, const OpInstance &b) {
+  auto out_a = CreateDataFormatKey(a.output->func_name());
+  auto out_b = CreateDataFormatKey(b.output->func_name());
+  size_t size_a = a.attrs.size() - a.attrs.count(out_a);
+  size_t size_b = b.attrs.size() - b.attrs.count(out_b);
+  if (size_a != size_b || a.attrs.count(out_a) != b.attrs.count(out_b)) {
+    return false;
+  }
+  if (a.attrs.count(out_a) && !EqualAttrValue(a.attrs[out_a], b.attrs[out_b])) {
+    return false;
+  }
+  for (const auto &kv : a.attrs) {
+    if (kv.first == out_a) {
+      continue;
+    }
+    if (!b.attrs.count(kv.first) || !EqualAttrValue(kv.second, b.attrs[kv.first])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameOp(const OpInstance &a, const OpInstance &b) {
+  if (a.call->name != b.call->name || a.call->type != b.call->type || !EqualShape(a.shape, b.shape) ||
+      a.call->args.size() != b.call->args.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.call->args.size(); ++i) {
+    if (!Equal(a.call->args[i], b.call->args[i])) {
+      return false;
+    }
+  }
+  return EqualAttrs(a, b);
+}
+
+// Merges every op into the first earlier op with the same name, inputs, attrs and output type and shape.
+class CommonOpMerger : public IRMutator {
+ public:
+  explicit CommonOpMerger(const FuncRefSet &pinned) : pinned_(pinned) {}
+
+ private:
+  Stmt Mutate_(const AttrStmt *op, const Stmt &s) override {
+    if (op->attr_key != "attrs") {
+      return IRMutator::Mutate_(op, s);
+    }
+    attrs_ = Downcast<Map<std::string, NodeRef>>(op->node);
+    auto body = this->Mutate(op->body);
+    auto attrs = attrs_;
+    attrs_ = {};
+    // the consumers keep the format of the inputs they now read
+    for (const auto &kv : replaced_) {
+      auto key = CreateDataFormatKey(kv.first->func_name());
+      if (attrs.count(key)) {
+        attrs.Set(CreateDataFormatKey(kv.second->func_name()), attrs[key]);
+      }
+    }
+    return AttrStmt::make(attrs, op->attr_key, op->value, body);
+  }
+
+  Stmt Mutate_(const Provide *op, const Stmt &s) override {
+    auto stmt = IRMutator::Mutate_(op, s);
+    auto provide = stmt.as<Provide>();
+    auto call = provide == nullptr ? nullptr : provide->value.as<Call>();
+    if (call == nullptr || !Mergeable(provide, call)) {
+      return stmt;
+    }
+    OpInstance cur{provide->func, call, provide->args, attrs_};
+    auto &candidates = seen_[call->name];
+    for (const auto &prev : candidates) {
+      if (SameOp(prev, cur)) {
+        replaced_[provide->func] = prev.output;
+        return Evaluate::make(0);
+      }
+    }
+    holds_.push_back(stmt);
+    candidates.push_back(cur);
+    return stmt;
+  }
+
+  Expr Mutate_(const Call *op, const Expr &e) override {
+    auto it = op->call_type == Call::CallType::Halide ? replaced_.find(op->func) : replaced_.end();
+    if (it != replaced_.end()) {
+      return Call::make(op->type, it->second->func_name(), op->args, op->call_type, it->second, op->value_index);
+    }
+    return IRMutator::Mutate_(op, e);
+  }
+
+  bool Mergeable(const Provide *provide, const Call *call) {
+    return !pinned_.count(provide->func) && !IsAssign(call->name) && !IsInplaceAssign(call->name) &&
+           call->name != "tuple_getitem" && call->name != "Custom" && call->type.code() != kArrayHandle;
+  }
+
+  const FuncRefSet &pinned_;
+  Map<std::string, NodeRef> attrs_;
+  FuncRefMap replaced_;
+  std::unordered_map<std::string, std::vector<OpInstance>> seen_;
+  // keeps the calls of seen_ alive
+  std::vector<Stmt> holds_;
+};
+}  // namespace
+
+Stmt ConstantFolding(const Stmt &s, BuildInfo *info) {
+  auto pinned = PinnedFuncs(s, info);
+  ConstantAnalysis analysis(pinned);
+  analysis.Visit(s);
+  auto folded = analysis.Folded();
+  if (folded.empty()) {
+    return s;
+  }
+  auto stmt = ConstantSubstituter(folded, analysis.Values()).Mutate(s);
+  return RemovedOpCleaner().Mutate(stmt);
+}
+
+Stmt CommonSubexprElim(const Stmt &s, BuildInfo *info) {
+  auto pinned = PinnedFuncs(s, info);
+  auto stmt = CommonOpMerger(pinned).Mutate(s);
+  return RemovedOpCleaner().Mutate(stmt);
+}
+}  // namespace akg
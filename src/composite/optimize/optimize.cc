@@ -38,6 +38,8 @@ Stmt Optimize(Stmt &s, BuildInfo &info) {
     ADD_PASS(pm, OpsCombine);
   }
   ADD_PASS(pm, AxisAttrNormalize);
+  ADD_PASS(pm, ConstantFolding);
+  ADD_PASS(pm, CommonSubexprElim);
   ADD_PASS(pm, ElimReshapeBackward);
   ADD_PASS(pm, ElimReshapeForward);
   if (info.opt.fold_dim) {
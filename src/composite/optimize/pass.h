@@ -38,6 +38,12 @@ Stmt TypeCastInserter(const Stmt &s, BuildInfo *info);
 // intrin rewrite
 Stmt IntrinRewriter(const Stmt &s, BuildInfo *info);
 
+// fold the ops whose inputs are all constants into scalars
+Stmt ConstantFolding(const Stmt &s, BuildInfo *info);
+
+// merge the ops with the same inputs and attrs
+Stmt CommonSubexprElim(const Stmt &s, BuildInfo *info);
+
 // elim reshape forward
 Stmt ElimReshapeForward(const Stmt &s, BuildInfo *info);
 
@@ -54,6 +54,16 @@ NodeRef Lower(Schedule sch, const Array<NodeRef> &in_args, const Array<NodeRef>
               bool polyhedral, bool tuning, const std::string &target, const BuildConfig &config,
               bool get_stmt = false);
 
+/*
+ * Lower one kernel into a function that holds a variant per shape bucket of attrs["shape_buckets"] and the
+ * symbolic kernel. A shape runs the first variant whose upper bounds it stays within, otherwise the symbolic
+ * kernel.
+ */
+NodeRef LowerShapeBuckets(Schedule sch, const Array<NodeRef> &in_args, const Array<NodeRef> &shape_vars,
+                          const std::string &name, const Map<Tensor, Buffer> &in_binds,
+                          const Map<std::string, NodeRef> &in_attrs, bool polyhedral, const std::string &target,
+                          const BuildConfig &config);
+
 air::runtime::Module BuildModule(const Schedule &inputs, const Array<NodeRef> &in_args,
                                  const Array<NodeRef> &shape_vars, const std::string &target_name,
                                  const std::string &name, const Map<Tensor, Buffer> &in_binds,
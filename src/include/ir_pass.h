@@ -101,6 +101,20 @@ Stmt AdjustParallelLoop(const Stmt &stmt);
 
 Stmt ReductionFactor(const Stmt &stmt, const Map<Tensor, Buffer> &extern_buffer);
 
+Stmt PrivatizeSegmentReduction(const Stmt &stmt, int thread_num);
+
+Stmt ParallelizeCpuScan(const Stmt &stmt, int thread_num);
+
+Stmt FuseCpuGemmEpilogue(const Stmt &stmt);
+
+Stmt InjectCpuStreamHint(const Stmt &stmt, const Array<NodeRef> &arg_list);
+
+Stmt EmitCpuInt8Dot(const Stmt &stmt);
+
+Stmt UseFastMath(const Stmt &stmt);
+
+Stmt SelectVectorizedBranch(const Stmt &stmt);
+
 Stmt ElementwiseFlatten(Stmt stmt, const Map<Tensor, Buffer> &extern_buffer,
                         const Map<Tensor, Buffer> &new_extern_buffer);
 
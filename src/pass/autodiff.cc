@@ -14,17 +14,20 @@
  * limitations under the License.
  */
 #include "pass/autodiff.h"
+#include <op/op_util.h>
 #include "pass/autodiff_cce.h"
 #include "pass/zero_elimination.h"
 
 namespace akg {
 namespace ir {
 DifferentiationResult DifferentiationResultNode::make(Array<Tensor> result, Map<Tensor, Tensor> adjoints,
-                                                      Map<Tensor, Map<Tensor, Tensor>> summands) {
+                                                      Map<Tensor, Map<Tensor, Tensor>> summands,
+                                                      Map<std::string, NodeRef> recompute_stats) {
   auto n = make_node<DifferentiationResultNode>();
   n->result = std::move(result);
   n->adjoints = std::move(adjoints);
   n->adjoint_summands = std::move(summands);
+  n->recompute_stats = std::move(recompute_stats);
   return DifferentiationResult(n);
 }
 
@@ -32,7 +35,7 @@ TVM_STATIC_IR_FUNCTOR(IRPrinter, vtable)
   .set_dispatch<DifferentiationResultNode>([](const ObjectRef &node, IRPrinter *p) {
     auto r = static_cast<const DifferentiationResultNode *>(node.get());
     p->stream << "DifferentiationResult(result=" << r->result << ", adjoints=" << r->adjoints
-              << ", adjoint_summands=" << r->adjoint_summands << ')';
+              << ", adjoint_summands=" << r->adjoint_summands << ", recompute_stats=" << r->recompute_stats << ')';
   });
 
 TVM_REGISTER_NODE_TYPE(DifferentiationResultNode);
@@ -86,6 +89,242 @@ std::unordered_map<Tensor, std::vector<Tensor>> ReverseDependenciesGenerator(
   return reverse_dependencies;
 }
 
+namespace {
+// Arithmetic operations needed to produce one element of the expression, loads excluded.
+class ElementOpCounter : public IRVisitor {
+ public:
+  int64_t count{0};
+
+  void Visit(const NodeRef &node) override {
+    if (node->IsInstance<Add>() || node->IsInstance<Sub>() || node->IsInstance<Mul>() || node->IsInstance<Div>() ||
+        node->IsInstance<Mod>() || node->IsInstance<FloorDiv>() || node->IsInstance<FloorMod>() ||
+        node->IsInstance<Min>() || node->IsInstance<Max>() || node->IsInstance<Select>()) {
+      ++count;
+    } else if (auto call = node.as<Call>()) {
+      if (call->call_type != Call::Halide) {
+        ++count;
+      }
+    }
+    IRVisitor::Visit(node);
+  }
+};
+
+int64_t CountElementOps(const Expr &expr) {
+  ElementOpCounter counter;
+  counter.Visit(expr);
+  return counter.count;
+}
+
+// Number of elements of the tensor, or -1 when the shape is not static.
+int64_t ConstElements(const Tensor &tensor) {
+  int64_t elements = 1;
+  for (const auto &dim : tensor->shape) {
+    auto imm = dim.as<IntImm>();
+    if (imm == nullptr) {
+      return -1;
+    }
+    elements *= imm->value;
+  }
+  return elements;
+}
+
+// The points at which a compute evaluates its body, its elements times the extent of its reduction
+int64_t IterationPoints(const Tensor &tensor) {
+  auto op = tensor->op.as<ComputeOpNode>();
+  int64_t elements = ConstElements(tensor);
+  if (op == nullptr || elements < 0) {
+    return -1;
+  }
+  int64_t reduce_extent = 1;
+  for (const auto &iv : op->reduce_axis) {
+    if (auto imm = iv->dom->extent.as<IntImm>()) {
+      reduce_extent *= imm->value;
+    }
+  }
+  return elements * reduce_extent;
+}
+
+int64_t TensorFlops(const Tensor &tensor) {
+  int64_t points = IterationPoints(tensor);
+  if (points < 0) {
+    return 0;
+  }
+  return CountElementOps(tensor->op.as<ComputeOpNode>()->body[tensor->value_index]) * points;
+}
+
+bool IsCheapElementwise(const Tensor &tensor) {
+  auto op = tensor->op.as<ComputeOpNode>();
+  return op != nullptr && op->reduce_axis.empty() && op->body[tensor->value_index].as<Reduce>() == nullptr &&
+         ConstElements(tensor) > 0;
+}
+
+std::unordered_set<Tensor> TensorsCalledBy(const Tensor &tensor) {
+  std::unordered_set<Tensor> called;
+  for (const auto &t : tensor->op->InputTensors()) {
+    called.insert(t);
+  }
+  return called;
+}
+}  // namespace
+
+/*!
+ * \brief Trade activation memory for recomputation in the backward graph.
+ *
+ *  Forward intermediates which the adjoints read back are normally kept alive until the backward
+ *  kernels run. An elementwise forward tensor is inlined into its backward consumers instead when
+ *  the arithmetic spent recomputing it, per byte of storage released, stays below
+ *  \p max_flops_per_byte. Reductions and dynamic shapes are always kept.
+ */
+Array<Tensor> RecomputeForwardTensors(const Array<Tensor> &results, const Tensor &output,
+                                      const std::unordered_map<Tensor, std::vector<Tensor>> &reverse_dependencies,
+                                      double max_flops_per_byte, Map<std::string, NodeRef> *stats) {
+  std::unordered_set<Tensor> forward{output};
+  for (const auto &kv : reverse_dependencies) {
+    forward.insert(kv.first);
+  }
+
+  // Collect the backward graph and the forward tensors it reads
+  std::vector<Tensor> backward;
+  std::unordered_set<Tensor> visited;
+  std::function<void(const Tensor &)> collect = [&](const Tensor &t) {
+    if (forward.count(t) || !visited.insert(t).second) {
+      return;
+    }
+    for (const auto &input : t->op->InputTensors()) {
+      collect(input);
+    }
+    backward.push_back(t);
+  };
+  for (const auto &t : results) {
+    collect(t);
+  }
+  // An inlined tensor is recomputed at every point of each consumer, so a use counts the points of the consumer per
+  // element of the tensor: more than one for a broadcast or a reduction, less for a slice
+  std::unordered_map<Tensor, double> backward_uses;
+  for (const auto &t : backward) {
+    int64_t points = IterationPoints(t);
+    for (const auto &input : TensorsCalledBy(t)) {
+      if (forward.count(input)) {
+        int64_t elements = ConstElements(input);
+        backward_uses[input] +=
+          points > 0 && elements > 0 ? static_cast<double>(points) / static_cast<double>(elements) : 1.0;
+      }
+    }
+  }
+
+  // Decide greedily from the inputs up, so that the recomputation cost of a tensor includes the
+  // forward tensors which are recomputed inside it
+  std::unordered_map<Tensor, int64_t> recompute_ops;
+  std::function<int64_t(const Tensor &)> cost = [&](const Tensor &t) -> int64_t {
+    auto it = recompute_ops.find(t);
+    if (it != recompute_ops.end()) {
+      return it->second;
+    }
+    int64_t ops = -1;
+    if (!t.same_as(output) && IsCheapElementwise(t)) {
+      ops = CountElementOps(t->op.as<ComputeOpNode>()->body[t->value_index]);
+      for (const auto &input : TensorsCalledBy(t)) {
+        int64_t input_ops = cost(input);
+        if (input_ops > 0) {
+          ops += input_ops;
+        }
+      }
+    }
+    recompute_ops[t] = ops;
+    return ops;
+  };
+  Array<Tensor> recomputed;
+  for (const auto &kv : backward_uses) {
+    const Tensor &t = kv.first;
+    int64_t ops = cost(t);
+    if (ops < 0) {
+      continue;
+    }
+    double flops_per_byte = static_cast<double>(ops) * kv.second / t->dtype.bytes();
+    if (flops_per_byte <= max_flops_per_byte) {
+      recomputed.push_back(t);
+    }
+  }
+  if (recomputed.empty()) {
+    return results;
+  }
+  // The cost of a chosen tensor assumed its cheap forward inputs are recomputed as well. The
+  // other entries are only reachable through the bodies of rejected tensors, which are never inlined.
+  std::unordered_set<Tensor> chosen(recomputed.begin(), recomputed.end());
+  for (const auto &kv : recompute_ops) {
+    if (kv.second >= 0 && !chosen.count(kv.first) && !backward_uses.count(kv.first)) {
+      recomputed.push_back(kv.first);
+      chosen.insert(kv.first);
+    }
+  }
+
+  // Rebuild the backward graph with the chosen tensors inlined
+  std::unordered_map<Operation, Operation> rebuilt;
+  std::function<Tensor(const Tensor &)> rebuild = [&](const Tensor &t) -> Tensor {
+    if (forward.count(t) || t->op.as<ComputeOpNode>() == nullptr) {
+      return t;
+    }
+    auto it = rebuilt.find(t->op);
+    if (it == rebuilt.end()) {
+      auto op = t->op.as<ComputeOpNode>();
+      std::unordered_map<Tensor, Tensor> vmap;
+      for (const auto &input : op->InputTensors()) {
+        Tensor new_input = rebuild(input);
+        if (!new_input.same_as(input)) {
+          vmap[input] = new_input;
+        }
+      }
+      bool changed = false;
+      Array<Expr> body;
+      for (const auto &e : op->body) {
+        Expr new_e = vmap.empty() ? e : air::op::ReplaceTensor(e, vmap);
+        new_e = InlineTensors(new_e, recomputed, false);
+        changed = changed || !new_e.same_as(e);
+        body.push_back(new_e);
+      }
+      Operation new_op = changed ? ComputeOpNode::make(op->name, op->tag, op->attrs, op->axis, body) : t->op;
+      it = rebuilt.emplace(t->op, new_op).first;
+    }
+    return it->second.output(t->value_index);
+  };
+  Array<Tensor> new_results;
+  for (const auto &t : results) {
+    new_results.push_back(rebuild(t));
+  }
+
+  // Report what was released against what has to be recomputed
+  std::unordered_set<Tensor> still_read;
+  for (const auto &kv : rebuilt) {
+    for (const auto &input : kv.second->InputTensors()) {
+      if (forward.count(input)) {
+        still_read.insert(input);
+      }
+    }
+  }
+  int64_t saved_bytes = 0;
+  Array<Tensor> released;
+  for (const auto &kv : backward_uses) {
+    if (!still_read.count(kv.first)) {
+      saved_bytes += ConstElements(kv.first) * kv.first->dtype.bytes();
+      released.push_back(kv.first);
+    }
+  }
+  int64_t extra_flops = 0;
+  for (const auto &kv : rebuilt) {
+    for (int i = 0; i < kv.first->num_outputs(); ++i) {
+      extra_flops += TensorFlops(kv.second.output(i)) - TensorFlops(kv.first.output(i));
+    }
+  }
+  LOG(INFO) << "Autodiff recomputation releases " << released.size() << " forward tensors (" << saved_bytes
+            << " bytes) for " << extra_flops << " extra flops";
+  if (stats != nullptr) {
+    stats->Set("recomputed", released);
+    stats->Set("saved_bytes", make_const(Int(64), saved_bytes));
+    stats->Set("extra_flops", make_const(Int(64), extra_flops));
+  }
+  return new_results;
+}
+
 DifferentiationResult Differentiate(const Tensor &output, const Array<Tensor> &inputs, const Tensor &head_or_null,
                                     const Map<std::string, NodeRef> &attrs, const Array<Tensor> &new_pld_array,
                                     const FDiffBuildingBlock &fdiff, const Map<Tensor, Array<Tensor>> &override_deps) {
@@ -172,14 +411,20 @@ DifferentiationResult Differentiate(const Tensor &output, const Array<Tensor> &i
     in_attrs = attrs;
   }
 
+  Map<std::string, NodeRef> recompute_stats;
+  if (in_attrs.GetInt("recompute", 0) != 0) {
+    double max_flops_per_byte = in_attrs.GetFloat("recompute_flops_per_byte", 2.0);
+    result = RecomputeForwardTensors(result, output_split, reverse_dependencies, max_flops_per_byte, &recompute_stats);
+  }
+
   bool tensor_optimize_ = (in_attrs.GetInt("tensor_optimize", 0) != 0);
   if (!tensor_optimize_) {
-    return DifferentiationResultNode::make(result, adjoints, summands);
+    return DifferentiationResultNode::make(result, adjoints, summands, recompute_stats);
   } else {  // Running TIL optimization passes
     Array<Tensor> optimized_result;
     ADOptimizePasses(result, optimized_result, attrs, new_pld_array);
     // AD FINISHED... Returning to Poly
-    return DifferentiationResultNode::make(optimized_result, adjoints, summands);
+    return DifferentiationResultNode::make(optimized_result, adjoints, summands, recompute_stats);
   }
 }
 
@@ -34,6 +34,8 @@ class DifferentiationResultNode : public Node {
   Map<Tensor, Tensor> adjoints;
   /*! \brief Single summands of the adjoints*/
   Map<Tensor, Map<Tensor, Tensor>> adjoint_summands;
+  /*! \brief Forward tensors recomputed in the backward graph, with the bytes released and the flops added */
+  Map<std::string, NodeRef> recompute_stats;
   /*! \brief constructor */
   DifferentiationResultNode() = default;
 
@@ -44,9 +46,11 @@ class DifferentiationResultNode : public Node {
     v->Visit("result", &result);
     v->Visit("adjoints", &adjoints);
     v->Visit("adjoint_summands", &adjoint_summands);
+    v->Visit("recompute_stats", &recompute_stats);
   }
   TVM_DLL static DifferentiationResult make(Array<Tensor> result, Map<Tensor, Tensor> adjoints,
-                                            Map<Tensor, Map<Tensor, Tensor>> adjoint_summands);
+                                            Map<Tensor, Map<Tensor, Tensor>> adjoint_summands,
+                                            Map<std::string, NodeRef> recompute_stats = {});
 
   static constexpr const char *_type_key = "DifferentiationResult";
   TVM_DECLARE_NODE_TYPE_INFO(DifferentiationResultNode, Node);
@@ -147,6 +151,9 @@ TVM_DLL Tensor DiffBuildingBlock(const Tensor &output, const Tensor &input, cons
  *            tensors).
  *         - `adjoint_summands` A map from tensors to maps from parent tensors to individual
  *            summands of the adjoint.
+ *         - `recompute_stats` Filled when \p attrs sets "recompute": the forward tensors recomputed
+ *            inside the adjoints instead of being kept alive, the bytes released and the extra flops.
+ *            "recompute_flops_per_byte" bounds the recomputation flops per released byte.
  */
 TVM_DLL DifferentiationResult
 Differentiate(const Tensor &output, const Array<Tensor> &inputs = Array<Tensor>(), const Tensor &head = Tensor(),
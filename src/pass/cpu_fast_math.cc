@@ -0,0 +1,56 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The fast cpu math of cpu_math_accuracy = "fast":
+ *
+ * T_exp[ramp(i*8, 1, 8)] = exp(A[ramp(i*8, 1, 8)])
+ * -->
+ * T_exp[ramp(i*8, 1, 8)] = fast_exp(A[ramp(i*8, 1, 8)])
+ *
+ * The math calls that have a faster llvm intrinsic rule are renamed, so the accuracy is part of the IR of each build
+ * and builds of different accuracy do not share any state.
+ */
+
+#include <tvm/ir.h>
+#include <tvm/ir_mutator.h>
+#include <tvm/ir_pass.h>
+
+#include <string>
+#include <unordered_set>
+
+#include "ir_pass.h"
+
+namespace akg {
+namespace ir {
+namespace {
+class FastMathRenamer : public IRMutator {
+ public:
+  Expr Mutate_(const Call *op, const Expr &e) final {
+    static const std::unordered_set<std::string> fast_calls = {"exp", "tanh", "sigmoid", "rsqrt"};
+    Expr expr = IRMutator::Mutate_(op, e);
+    op = expr.as<Call>();
+    if (op == nullptr || op->call_type != Call::PureIntrinsic || fast_calls.count(op->name) == 0) {
+      return expr;
+    }
+    return Call::make(op->type, "fast_" + op->name, op->args, op->call_type, op->func, op->value_index);
+  }
+};
+}  // namespace
+
+Stmt UseFastMath(const Stmt &stmt) { return FastMathRenamer().Mutate(stmt); }
+}  // namespace ir
+}  // namespace akg
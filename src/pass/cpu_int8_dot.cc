@@ -0,0 +1,286 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Int8 dot products for the reduction loops of cpu gemm and conv:
+ *
+ * for (k, 0, 64) {
+ *   C[ramp(0, 1, 8)] = C[ramp(0, 1, 8)] + x8(int32(A[k])) * int32(B[ramp(k*8, 1, 8)])
+ * }
+ * -->
+ * for (k.o, 0, 16) {
+ *   C[ramp(0, 1, 8)] = akg_dot_u8s8(C[ramp(0, 1, 8)],
+ *                                   reinterpret(x8(reinterpret(A[ramp(k.o*4, 1, 4)]))),
+ *                                   shuffle(B[ramp(k.o*32, 1, 8)], B[ramp(k.o*32 + 8, 1, 8)], ...))
+ * }
+ *
+ * Four consecutive iterations of the reduction are folded into one akg_dot_u8s8, which the x86 codegen emits as
+ * vpdpbusd, a widening vpmaddwd sequence or a widening multiply depending on the target features. Operands that
+ * hold the four k of a lane next to each other, like the u8s8 packed locals of the gemm, are loaded as one vector;
+ * the others are interleaved with a shuffle. A tail loop keeps the iterations left over by the folding.
+ */
+
+#include <tvm/ir.h>
+#include <tvm/ir_mutator.h>
+#include <tvm/ir_pass.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "pass/utils.h"
+#include "ir_pass.h"
+
+namespace akg {
+namespace ir {
+namespace {
+constexpr int kDotGroup = 4;
+
+struct DotStore {
+  const Store *store{nullptr};
+  Expr acc;
+  // the uint8 and int8 vectors before they are widened to int32
+  Expr u8;
+  Expr s8;
+};
+
+bool IsByte(const Type &t) { return t.bits() == 8 && (t.is_int() || t.is_uint()); }
+
+// the 8-bit vector that an int32 operand of the multiplication widens
+Expr NarrowOperand(const Expr &e, int lanes) {
+  if (auto cast = e.as<Cast>()) {
+    if (IsByte(cast->value.type()) && cast->value.type().lanes() == lanes) {
+      return cast->value;
+    }
+  } else if (auto broadcast = e.as<Broadcast>()) {
+    auto cast = broadcast->value.as<Cast>();
+    if (cast != nullptr && IsByte(cast->value.type()) && cast->value.type().lanes() == 1) {
+      return Broadcast::make(cast->value, lanes);
+    }
+  }
+  return Expr();
+}
+
+bool IsConstOffset(const Expr &a, const Expr &b, int64_t offset) {
+  if (a.type() != b.type()) {
+    return false;
+  }
+  auto diff = as_const_int(Simplify(b - a));
+  return diff != nullptr && *diff == offset;
+}
+
+class DotMatcher {
+ public:
+  explicit DotMatcher(const Var &loop_var) : loop_var_(loop_var) {}
+
+  bool Match(const Stmt &stmt) {
+    if (auto op = stmt.as<For>()) {
+      if (ExprUseVar(op->min, loop_var_) || ExprUseVar(op->extent, loop_var_)) {
+        return false;
+      }
+      return Match(op->body);
+    } else if (auto op = stmt.as<Block>()) {
+      return Match(op->first) && Match(op->rest);
+    } else if (auto op = stmt.as<Store>()) {
+      return MatchStore(op);
+    }
+    return false;
+  }
+
+  bool Valid() const {
+    if (stores_.empty()) {
+      return false;
+    }
+    // the reduction must not read what it writes, besides its own accumulator
+    std::unordered_set<const Variable *> written;
+    for (const auto &dot : stores_) {
+      written.insert(dot.store->buffer_var.get());
+    }
+    for (const auto &dot : stores_) {
+      bool reads_written = false;
+      PostOrderVisit(Block::make(Evaluate::make(dot.u8), Evaluate::make(dot.s8)),
+                     [&reads_written, &written](const NodeRef &node) {
+                       auto load = node.as<Load>();
+                       reads_written = reads_written || (load != nullptr && written.count(load->buffer_var.get()) > 0);
+                     });
+      if (reads_written) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const std::vector<DotStore> &Stores() const { return stores_; }
+
+ private:
+  bool MatchStore(const Store *op) {
+    Type t = op->value.type();
+    if (!t.is_int() || t.bits() != 32 || t.lanes() < 2 || ExprUseVar(op->index, loop_var_)) {
+      return false;
+    }
+    auto add = op->value.as<Add>();
+    if (add == nullptr) {
+      return false;
+    }
+    Expr acc = add->a;
+    auto mul = add->b.as<Mul>();
+    if (mul == nullptr) {
+      acc = add->b;
+      mul = add->a.as<Mul>();
+    }
+    auto acc_load = acc.as<Load>();
+    if (mul == nullptr || acc_load == nullptr || !acc_load->buffer_var.same_as(op->buffer_var) ||
+        !Equal(acc_load->index, op->index)) {
+      return false;
+    }
+    Expr lhs = NarrowOperand(mul->a, t.lanes());
+    Expr rhs = NarrowOperand(mul->b, t.lanes());
+    if (!lhs.defined() || !rhs.defined()) {
+      return false;
+    }
+    if (lhs.type().is_int() && rhs.type().is_uint()) {
+      std::swap(lhs, rhs);
+    }
+    if (!lhs.type().is_uint() || !rhs.type().is_int()) {
+      return false;
+    }
+    if (!ExprUseVar(lhs, loop_var_) && !ExprUseVar(rhs, loop_var_)) {
+      return false;
+    }
+    DotStore dot;
+    dot.store = op;
+    dot.acc = acc;
+    dot.u8 = lhs;
+    dot.s8 = rhs;
+    stores_.push_back(dot);
+    return true;
+  }
+
+  Var loop_var_;
+  std::vector<DotStore> stores_;
+};
+
+class Int8DotRewriter : public IRMutator {
+ public:
+  Stmt Mutate_(const For *op, const Stmt &s) final {
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    op = stmt.as<For>();
+    CHECK(op);
+    auto extent = as_const_int(op->extent);
+    if ((op->for_type != ForType::Serial && op->for_type != ForType::Unrolled) || extent == nullptr ||
+        *extent < kDotGroup) {
+      return stmt;
+    }
+    DotMatcher matcher(op->loop_var);
+    if (!matcher.Match(op->body) || !matcher.Valid()) {
+      return stmt;
+    }
+
+    Var outer(op->loop_var->name_hint + ".o", op->loop_var.type());
+    std::unordered_map<const Store *, Stmt> dots;
+    for (const auto &dot : matcher.Stores()) {
+      Type t = dot.store->value.type();
+      Expr u8 = GroupK(dot.u8, op->loop_var, op->min, outer);
+      Expr s8 = GroupK(dot.s8, op->loop_var, op->min, outer);
+      Expr value = Call::make(t, air::ir::intrinsic::akg_dot_u8s8, {dot.acc, u8, s8}, Call::PureIntrinsic);
+      dots[dot.store] = Store::make(dot.store->buffer_var, value, dot.store->index, dot.store->predicate);
+    }
+    Stmt body = StoreReplacer(dots).Mutate(op->body);
+    int64_t groups = *extent / kDotGroup;
+    int64_t rest = *extent % kDotGroup;
+    Stmt main = For::make(outer, make_zero(outer.type()), make_const(outer.type(), groups), op->for_type,
+                          op->device_api, body);
+    if (rest == 0) {
+      return main;
+    }
+    Stmt tail = For::make(op->loop_var, Simplify(op->min + make_const(op->min.type(), groups * kDotGroup)),
+                          make_const(op->extent.type(), rest), op->for_type, op->device_api, op->body);
+    return Block::make(main, tail);
+  }
+
+ private:
+  class StoreReplacer : public IRMutator {
+   public:
+    explicit StoreReplacer(const std::unordered_map<const Store *, Stmt> &dots) : dots_(dots) {}
+
+    Stmt Mutate_(const Store *op, const Stmt &s) final {
+      auto it = dots_.find(op);
+      return it == dots_.end() ? s : it->second;
+    }
+
+   private:
+    const std::unordered_map<const Store *, Stmt> &dots_;
+  };
+
+  // the vector of 4 * lanes bytes whose lane i holds the operand of lane i at k, k+1, k+2 and k+3
+  Expr GroupK(const Expr &narrow, const Var &loop_var, const Expr &min, const Var &outer) {
+    int lanes = narrow.type().lanes();
+    Type group_type = narrow.type().with_lanes(lanes * kDotGroup);
+    std::vector<Expr> parts;
+    for (int q = 0; q < kDotGroup; ++q) {
+      Expr k = min + outer * kDotGroup + make_const(outer.type(), q);
+      std::unordered_map<const Variable *, Expr> vmap = {{loop_var.get(), k}};
+      parts.push_back(Simplify(Substitute(narrow, vmap)));
+    }
+
+    // packed operand: the four k of a lane are contiguous
+    auto first = parts[0].as<Load>();
+    bool packed = first != nullptr && first->index.as<Ramp>() != nullptr;
+    for (int q = 0; q < kDotGroup && packed; ++q) {
+      auto load = parts[q].as<Load>();
+      auto ramp = load != nullptr ? load->index.as<Ramp>() : nullptr;
+      packed = ramp != nullptr && is_const_int(ramp->stride, kDotGroup) && first->buffer_var.same_as(load->buffer_var) &&
+               IsConstOffset(first->index.as<Ramp>()->base, ramp->base, q);
+    }
+    if (packed) {
+      Expr base = first->index.as<Ramp>()->base;
+      return Load::make(group_type, first->buffer_var, Ramp::make(base, make_const(base.type(), 1), group_type.lanes()),
+                        const_true(group_type.lanes()));
+    }
+
+    // broadcast operand: one word of four contiguous k, repeated over the lanes
+    auto first_broadcast = parts[0].as<Broadcast>();
+    auto first_scalar = first_broadcast != nullptr ? first_broadcast->value.as<Load>() : nullptr;
+    bool word = first_scalar != nullptr;
+    for (int q = 0; q < kDotGroup && word; ++q) {
+      auto broadcast = parts[q].as<Broadcast>();
+      auto load = broadcast != nullptr ? broadcast->value.as<Load>() : nullptr;
+      word = load != nullptr && first_scalar->buffer_var.same_as(load->buffer_var) &&
+             IsConstOffset(first_scalar->index, load->index, q);
+    }
+    if (word) {
+      Type bytes = narrow.type().with_lanes(kDotGroup);
+      Expr index = first_scalar->index;
+      Expr quad = Load::make(bytes, first_scalar->buffer_var, Ramp::make(index, make_const(index.type(), 1), kDotGroup),
+                             const_true(kDotGroup));
+      Expr packed_word = Call::make(Int(32), Call::reinterpret, {quad}, Call::PureIntrinsic);
+      return Call::make(group_type, Call::reinterpret, {Broadcast::make(packed_word, lanes)}, Call::PureIntrinsic);
+    }
+
+    Array<Expr> indices;
+    for (int i = 0; i < lanes; ++i) {
+      for (int q = 0; q < kDotGroup; ++q) {
+        indices.push_back(make_const(Int(32), q * lanes + i));
+      }
+    }
+    return Shuffle::make(Array<Expr>(parts.begin(), parts.end()), indices);
+  }
+};
+}  // namespace
+
+Stmt EmitCpuInt8Dot(const Stmt &stmt) { return Int8DotRewriter().Mutate(stmt); }
+}  // namespace ir
+}  // namespace akg
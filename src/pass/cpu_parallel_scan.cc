@@ -0,0 +1,238 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Blocked parallel scan for the loop carried recurrences of cumsum and cumprod on cpu:
+ *
+ * for (m, 1, 65535) {
+ *   T[m] = T[(m - 1)] + A[m]
+ * }
+ * -->
+ * // attr [scan_carry] storage_scope = "local"
+ * allocate scan_carry[float32 * 8]
+ * parallel (b, 0, 8) {
+ *   if (b == 0) {
+ *     for (r, 0, 8192) {
+ *       T[(r + 1)] = T[r] + A[(r + 1)]
+ *     }
+ *   } else {
+ *     T[(b*8192 + 1)] = A[(b*8192 + 1)]
+ *     for (r, 1, (min(8192, (65535 - b*8192)) - 1)) {
+ *       T[((b*8192 + r) + 1)] = T[(b*8192 + r)] + A[((b*8192 + r) + 1)]
+ *     }
+ *   }
+ * }
+ * scan_carry[1] = T[8192]
+ * for (b, 2, 6) {
+ *   scan_carry[b] = scan_carry[(b - 1)] + T[b*8192]
+ * }
+ * parallel (b, 1, 7) {
+ *   for (r, 0, min(8192, (65535 - b*8192))) {
+ *     T[((b*8192 + r) + 1)] = scan_carry[b] + T[((b*8192 + r) + 1)]
+ *   }
+ * }
+ *
+ * Every block first scans its own range, the first one seeded by the element before the loop. The serial pass
+ * turns the block totals into the prefix of every block, and the fix-up adds it back. The fix-up has no carried
+ * dependence, so llvm vectorizes it; float results differ from the serial order only by reassociation.
+ */
+
+#include <tvm/ir.h>
+#include <tvm/ir_mutator.h>
+#include <tvm/ir_pass.h>
+#include <tvm/arithmetic.h>
+
+#include <algorithm>
+
+#include "pass/utils.h"
+#include "ir_pass.h"
+
+namespace akg {
+namespace ir {
+namespace {
+// below this a block does not pay for the wake up of a thread
+constexpr int64_t kMinScanBlock = 4096;
+// the blocked scan touches the data twice, so fewer blocks are slower than the serial loop
+constexpr int64_t kMinScanBlocks = 4;
+constexpr int64_t kMaxScanBlocks = 64;
+
+struct ScanInfo {
+  const Store *store{nullptr};
+  // the loop carried load of the previous element
+  const Load *carry{nullptr};
+  // the value combined with the previous element
+  Expr value;
+  bool is_add{true};
+};
+
+bool ReadsBuffer(const Expr &e, const Variable *buffer) {
+  bool found = false;
+  PostOrderVisit(e, [&found, buffer](const NodeRef &node) {
+    const auto load = node.as<Load>();
+    if (load != nullptr && load->buffer_var.get() == buffer) {
+      found = true;
+    }
+  });
+  return found;
+}
+
+class ParallelScanRewriter : public IRMutator {
+ public:
+  explicit ParallelScanRewriter(int thread_num) : thread_num_(thread_num) {}
+
+ private:
+  Stmt Mutate_(const For *op, const Stmt &s) final {
+    if (op->for_type == ForType::Parallel) {
+      ++parallel_depth_;
+      Stmt stmt = IRMutator::Mutate_(op, s);
+      --parallel_depth_;
+      return stmt;
+    }
+    ScanInfo info;
+    if (parallel_depth_ == 0 && op->for_type == ForType::Serial && MatchScan(op, &info)) {
+      Stmt stmt = LowerScan(op, info);
+      if (stmt.defined()) {
+        return stmt;
+      }
+    }
+    return IRMutator::Mutate_(op, s);
+  }
+
+  // for (m) { T[f(m)] = T[f(m) - s] op v(m) }, where f is linear in m with the constant stride s
+  static bool MatchScan(const For *op, ScanInfo *info) {
+    const auto store = op->body.as<Store>();
+    if (store == nullptr || !is_one(store->predicate) || store->value.type().lanes() != 1) {
+      return false;
+    }
+    Expr a;
+    Expr b;
+    if (const auto add = store->value.as<Add>()) {
+      a = add->a;
+      b = add->b;
+    } else if (const auto mul = store->value.as<Mul>()) {
+      a = mul->a;
+      b = mul->b;
+      info->is_add = false;
+    } else {
+      return false;
+    }
+    auto IsCarry = [store](const Expr &e) {
+      const auto load = e.as<Load>();
+      return load != nullptr && load->buffer_var.get() == store->buffer_var.get() ? load : nullptr;
+    };
+    if ((info->carry = IsCarry(a)) != nullptr) {
+      info->value = b;
+    } else if ((info->carry = IsCarry(b)) != nullptr) {
+      info->value = a;
+    } else {
+      return false;
+    }
+    if (!is_one(info->carry->predicate) || ReadsBuffer(info->value, store->buffer_var.get())) {
+      return false;
+    }
+    Array<Expr> coeff = air::arith::DetectLinearEquation(store->index, {op->loop_var});
+    if (coeff.size() != 2) {
+      return false;
+    }
+    const int64_t *stride = as_const_int(Simplify(coeff[0]));
+    if (stride == nullptr || *stride == 0 || !is_zero(Simplify(info->carry->index - (store->index - coeff[0])))) {
+      return false;
+    }
+    info->store = store;
+    return true;
+  }
+
+  Stmt LowerScan(const For *op, const ScanInfo &info) {
+    const int64_t *extent = as_const_int(op->extent);
+    if (extent == nullptr) {
+      return Stmt();
+    }
+    int64_t len = *extent;
+    int64_t blocks = std::max(static_cast<int64_t>(thread_num_), static_cast<int64_t>(1));
+    blocks = std::min({blocks, len / kMinScanBlock, kMaxScanBlocks});
+    if (blocks < kMinScanBlocks) {
+      return Stmt();
+    }
+    int64_t block = (len + blocks - 1) / blocks;
+    blocks = (len + block - 1) / block;
+
+    const Store *store = info.store;
+    Type type = store->value.type();
+    Type t = op->loop_var.type();
+    Var carry("scan_carry", Handle());
+    auto Combine = [&info](const Expr &x, const Expr &y) {
+      return info.is_add ? Add::make(x, y) : Mul::make(x, y);
+    };
+    auto At = [op](const Expr &pos) {
+      Map<Var, Expr> vmap;
+      vmap.Set(op->loop_var, Simplify(op->min + pos));
+      return vmap;
+    };
+    auto StoreAt = [&At, store](const Expr &pos) { return air::ir::Substitute(GetRef<Stmt>(store), At(pos)); };
+    auto IndexAt = [&At, store](const Expr &pos) { return air::ir::Substitute(store->index, At(pos)); };
+    auto BlockLen = [len, block, t](const Var &b) {
+      return Simplify(Min::make(make_const(t, block), make_const(t, len) - b * make_const(t, block)));
+    };
+
+    // local scans: the first block keeps the original recurrence, the others restart at their first element
+    Var b1("b", t);
+    Var r0("r", t);
+    Var r1("r", t);
+    Stmt first = For::make(r0, make_zero(t), make_const(t, block), ForType::Serial, DeviceAPI::None, StoreAt(r0));
+    Expr begin = b1 * make_const(t, block);
+    Stmt restart =
+      Store::make(store->buffer_var, air::ir::Substitute(info.value, At(begin)), IndexAt(begin), const_true());
+    Stmt rest = For::make(r1, make_const(t, 1), Simplify(BlockLen(b1) - 1), ForType::Serial, DeviceAPI::None,
+                          StoreAt(begin + r1));
+    Stmt local = For::make(b1, make_zero(t), make_const(t, blocks), ForType::Parallel, DeviceAPI::None,
+                           IfThenElse::make(EQ::make(b1, make_zero(t)), first, Block::make(restart, rest)));
+
+    // prefix of every block but the first one
+    Expr first_total = Load::make(type, store->buffer_var, IndexAt(make_const(t, block - 1)), const_true());
+    Stmt prefix = Store::make(carry, first_total, make_const(t, 1), const_true());
+    if (blocks > 2) {
+      Var b2("b", t);
+      Expr total = Load::make(type, store->buffer_var, IndexAt(b2 * make_const(t, block) - 1), const_true());
+      Stmt next = Store::make(carry, Combine(Load::make(type, carry, b2 - 1, const_true()), total), b2, const_true());
+      prefix = Block::make(
+        prefix, For::make(b2, make_const(t, 2), make_const(t, blocks - 2), ForType::Serial, DeviceAPI::None, next));
+    }
+
+    // fix-up
+    Var b3("b", t);
+    Var r3("r", t);
+    Expr index = IndexAt(b3 * make_const(t, block) + r3);
+    Stmt fix = Store::make(store->buffer_var,
+                           Combine(Load::make(type, carry, b3, const_true()),
+                                   Load::make(type, store->buffer_var, index, const_true())),
+                           index, const_true());
+    fix = For::make(r3, make_zero(t), BlockLen(b3), ForType::Serial, DeviceAPI::None, fix);
+    fix = For::make(b3, make_const(t, 1), make_const(t, blocks - 1), ForType::Parallel, DeviceAPI::None, fix);
+
+    Stmt body = Block::make(local, Block::make(prefix, fix));
+    body = Allocate::make(carry, type, {make_const(t, blocks)}, const_true(), body);
+    return AttrStmt::make(carry, air::ir::attr::storage_scope, StringImm::make("local"), body);
+  }
+
+  // the threads the blocks are spread over
+  int thread_num_;
+  int parallel_depth_{0};
+};
+}  // namespace
+
+Stmt ParallelizeCpuScan(const Stmt &stmt, int thread_num) { return ParallelScanRewriter(thread_num).Mutate(stmt); }
+}  // namespace ir
+}  // namespace akg
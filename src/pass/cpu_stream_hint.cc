@@ -0,0 +1,251 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Memory hints for bandwidth bound cpu kernels (elementwise, broadcast and transpose):
+ *
+ * for (i, 0, 4096) {
+ *   C[ramp(i*8, 1, 8)] = A[ramp(i*8, 1, 8)] + B[ramp(i*8, 1, 8)]
+ * }
+ * -->
+ * // attr [C] nontemporal_scope = 1
+ * for (i, 0, 4096) {
+ *   prefetch(&A[min(i*8 + 256, 32767)], 0, 3, 1)
+ *   prefetch(&B[min(i*8 + 256, 32767)], 0, 3, 1)
+ *   C[ramp(i*8, 1, 8)] = A[ramp(i*8, 1, 8)] + B[ramp(i*8, 1, 8)]
+ * }
+ *
+ * Loads of large inputs are prefetched a fixed number of bytes ahead of the innermost loop, so the distance in
+ * iterations follows from the access stride. Large outputs that are only written with contiguous vectors bypass
+ * the cache, which saves the read-for-ownership of every output line. The scope encloses the outermost parallel
+ * loop, so codegen fences once after the loop of every task instead of once per iteration.
+ *
+ * The pass is off unless enable_cpu_stream_hint is set.
+ */
+
+#include <tvm/ir.h>
+#include <tvm/ir_mutator.h>
+#include <tvm/ir_pass.h>
+#include <tvm/buffer.h>
+#include <tvm/arithmetic.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "pass/utils.h"
+#include "ir_pass.h"
+
+namespace akg {
+namespace ir {
+namespace {
+constexpr int64_t kCacheLineBytes = 64;
+// how far ahead of the current iteration the inputs are fetched
+constexpr int64_t kPrefetchAheadBytes = 1024;
+constexpr int64_t kMinPrefetchIters = 4;
+// buffers below these sizes stay in the caches anyway
+constexpr int64_t kPrefetchMinBytes = 1LL << 20;
+constexpr int64_t kNonTemporalMinBytes = 16LL << 20;
+// narrower stores would be split into partial line writes
+constexpr int kNonTemporalMinVectorBytes = 16;
+
+struct StreamBuffer {
+  int64_t elems{0};
+  int64_t bytes{0};
+};
+
+class StreamHintInjector : public IRMutator {
+ public:
+  StreamHintInjector(const std::unordered_map<const Variable *, StreamBuffer> &buffers,
+                     const std::unordered_set<const Variable *> &nontemporal)
+      : buffers_(buffers), nontemporal_(nontemporal) {}
+
+  Stmt Run(const Stmt &stmt) {
+    Stmt s = Mutate(stmt);
+    return has_parallel_ ? s : AddNonTemporalScope(s);
+  }
+
+ private:
+  Stmt Mutate_(const For *op, const Stmt &s) final {
+    bool outer_parallel = op->for_type == ForType::Parallel && !in_parallel_;
+    if (outer_parallel) {
+      in_parallel_ = true;
+    }
+    has_inner_loop_ = false;
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    bool innermost = !has_inner_loop_;
+    has_inner_loop_ = true;
+
+    op = stmt.as<For>();
+    CHECK(op);
+    Stmt body = op->body;
+    if (innermost && op->for_type != ForType::Vectorized) {
+      body = InsertPrefetch(op->loop_var, body);
+    }
+    if (!body.same_as(op->body)) {
+      stmt = For::make(op->loop_var, op->min, op->extent, op->for_type, op->device_api, body);
+    }
+    if (outer_parallel) {
+      in_parallel_ = false;
+      has_parallel_ = true;
+      stmt = AddNonTemporalScope(stmt);
+    }
+    return stmt;
+  }
+
+  Stmt InsertPrefetch(const Var &loop_var, const Stmt &body) {
+    std::unordered_set<const Variable *> local_vars;
+    PostOrderVisit(body, [&local_vars](const NodeRef &node) {
+      if (auto let = node.as<LetStmt>()) {
+        local_vars.insert(let->var.get());
+      } else if (auto let = node.as<Let>()) {
+        local_vars.insert(let->var.get());
+      }
+    });
+
+    std::vector<Stmt> prefetches;
+    std::unordered_set<const Variable *> fetched;
+    PostOrderVisit(body, [&, this](const NodeRef &node) {
+      auto load = node.as<Load>();
+      if (load == nullptr || fetched.count(load->buffer_var.get()) > 0 ||
+          buffers_.count(load->buffer_var.get()) == 0) {
+        return;
+      }
+      const StreamBuffer &buffer = buffers_.at(load->buffer_var.get());
+      if (buffer.bytes < kPrefetchMinBytes) {
+        return;
+      }
+      Expr base = load->index;
+      if (auto ramp = base.as<Ramp>()) {
+        base = ramp->base;
+      }
+      if (ExprUseVar(base, local_vars)) {
+        return;
+      }
+      Array<Expr> coeffs = air::arith::DetectLinearEquation(base, {loop_var});
+      if (coeffs.size() != 2 || as_const_int(coeffs[0]) == nullptr) {
+        return;
+      }
+      int64_t coef = *as_const_int(coeffs[0]);
+      Type t = load->type.element_of();
+      int64_t step = std::abs(coef) * t.bytes();
+      // narrow strides are served by the hardware stream prefetcher
+      if (step * 2 < kCacheLineBytes) {
+        return;
+      }
+      int64_t ahead = std::max((kPrefetchAheadBytes + step - 1) / step, kMinPrefetchIters);
+      Expr index = base + make_const(base.type(), coef * ahead);
+      index = coef > 0 ? Min::make(index, make_const(base.type(), buffer.elems - 1))
+                       : Max::make(index, make_const(base.type(), 0));
+      Expr addr = Call::make(Handle(), air::ir::intrinsic::tvm_address_of,
+                             {Load::make(t, load->buffer_var, Simplify(index), const_true())}, Call::PureIntrinsic);
+      prefetches.push_back(Evaluate::make(Call::make(t, Call::prefetch, {addr, 0, 3, 1}, Call::Intrinsic)));
+      fetched.insert(load->buffer_var.get());
+    });
+    if (prefetches.empty()) {
+      return body;
+    }
+    prefetches.push_back(body);
+    return Block::make(prefetches);
+  }
+
+  Stmt AddNonTemporalScope(const Stmt &body) {
+    std::unordered_set<const Variable *> stored;
+    PostOrderVisit(body, [&stored, this](const NodeRef &node) {
+      auto store = node.as<Store>();
+      if (store != nullptr && nontemporal_.count(store->buffer_var.get()) > 0) {
+        stored.insert(store->buffer_var.get());
+      }
+    });
+    Stmt stmt = body;
+    for (auto var : stored) {
+      stmt = AttrStmt::make(GetRef<Var>(var), air::ir::attr::nontemporal_scope, make_const(Int(32), 1), stmt);
+    }
+    return stmt;
+  }
+
+  const std::unordered_map<const Variable *, StreamBuffer> &buffers_;
+  const std::unordered_set<const Variable *> &nontemporal_;
+  bool in_parallel_{false};
+  bool has_parallel_{false};
+  bool has_inner_loop_{false};
+};
+}  // namespace
+
+Stmt InjectCpuStreamHint(const Stmt &stmt, const Array<NodeRef> &arg_list) {
+  bool is_stream_op = false;
+  PostOrderVisit(stmt, [&is_stream_op](const NodeRef &node) {
+    if (auto attr = node.as<AttrStmt>()) {
+      is_stream_op = is_stream_op || attr->attr_key == AKG_STREAM_OP;
+    }
+  });
+  if (!is_stream_op) {
+    return stmt;
+  }
+
+  std::unordered_map<const Variable *, StreamBuffer> buffers;
+  for (const auto &arg : arg_list) {
+    auto buffer = arg.as<BufferNode>();
+    if (buffer == nullptr) {
+      continue;
+    }
+    StreamBuffer info;
+    info.elems = 1;
+    for (const auto &dim : buffer->shape) {
+      auto extent = as_const_int(dim);
+      if (extent == nullptr) {
+        info.elems = 0;
+        break;
+      }
+      info.elems *= *extent;
+    }
+    if (info.elems > 0) {
+      info.bytes = info.elems * buffer->dtype.bytes();
+      buffers[buffer->data.get()] = info;
+    }
+  }
+
+  // write-once outputs: never read back and only written with whole contiguous vectors
+  std::unordered_set<const Variable *> loaded;
+  std::unordered_set<const Variable *> streamed;
+  std::unordered_set<const Variable *> partial;
+  PostOrderVisit(stmt, [&loaded, &streamed, &partial](const NodeRef &node) {
+    if (auto load = node.as<Load>()) {
+      loaded.insert(load->buffer_var.get());
+    } else if (auto store = node.as<Store>()) {
+      auto ramp = store->index.as<Ramp>();
+      Type t = store->value.type();
+      if (ramp != nullptr && is_one(ramp->stride) && is_one(store->predicate) &&
+          t.bytes() * t.lanes() >= kNonTemporalMinVectorBytes) {
+        streamed.insert(store->buffer_var.get());
+      } else {
+        partial.insert(store->buffer_var.get());
+      }
+    }
+  });
+  std::unordered_set<const Variable *> nontemporal;
+  for (auto var : streamed) {
+    if (loaded.count(var) == 0 && partial.count(var) == 0 && buffers.count(var) > 0 &&
+        buffers[var].bytes >= kNonTemporalMinBytes) {
+      nontemporal.insert(var);
+    }
+  }
+
+  return StreamHintInjector(buffers, nontemporal).Run(stmt);
+}
+}  // namespace ir
+}  // namespace akg
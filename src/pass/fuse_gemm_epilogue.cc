@@ -0,0 +1,342 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Apply the elementwise epilogue of a cpu gemm to the C tile when it leaves the registers:
+ *
+ * parallel (cc0, 0, 32) {
+ *   ...
+ *   for (cc5, 0, 4) {
+ *     vectorized (cc6, 0, 8) {
+ *       compute(cc0*4 + cc5, cc4*8 + cc6) = compute_local(cc5, cc6)
+ *     }
+ *   }
+ * }
+ * parallel (cc0, 0, 128) {
+ *   vectorized (cc1, 0, 64) {
+ *     T_add(cc0, cc1) = max(compute(cc0, cc1) + bias(cc1), 0f)
+ *   }
+ * }
+ * -->
+ * parallel (cc0, 0, 32) {
+ *   ...
+ *   for (cc5, 0, 4) {
+ *     vectorized (cc6, 0, 8) {
+ *       compute(cc0*4 + cc5, cc4*8 + cc6) = compute_local(cc5, cc6)
+ *       T_add(cc0*4 + cc5, cc4*8 + cc6) = max(compute_local(cc5, cc6) + bias(cc4*8 + cc6), 0f)
+ *     }
+ *   }
+ * }
+ *
+ * The epilogue nests (bias-add, activation, residual-add, cast) that directly follow the gemm are folded into its
+ * last write of C, so C is not read back from memory in a second pass. A nest is only folded when it visits every
+ * element of C once, accesses C and the tensors it folded before at its store indices, and reads nothing the gemm
+ * writes otherwise; the write of C itself is kept for other consumers. Where that write accumulates into C, the
+ * folded epilogue reloads C after it.
+ */
+
+#include <tvm/ir.h>
+#include <tvm/ir_mutator.h>
+#include <tvm/ir_pass.h>
+#include <tvm/operation.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "pass/utils.h"
+#include "ir_pass.h"
+
+namespace akg {
+namespace ir {
+namespace {
+constexpr auto GEMM_PACK_A = "pack_a";
+
+struct GemmOutput {
+  const Provide *write{nullptr};
+  // elements of C, which the loops around the write visit once each
+  int64_t elems{0};
+};
+
+int64_t TensorElems(const Provide *op) {
+  if (op->func.as<OperationNode>() == nullptr) {
+    return -1;
+  }
+  Operation func = Downcast<Operation>(op->func);
+  int64_t elems = 1;
+  for (const auto &dim : func.output(op->value_index)->shape) {
+    const int64_t *extent = as_const_int(dim);
+    if (extent == nullptr) {
+      return -1;
+    }
+    elems *= *extent;
+  }
+  return elems;
+}
+
+// Finds the last write of every tensor in a gemm nest and whether each element gets it only once.
+class GemmOutputFinder : public IRVisitor {
+ public:
+  void Visit_(const For *op) final {
+    loops_.push_back(op);
+    IRVisitor::Visit_(op);
+    loops_.pop_back();
+  }
+
+  void Visit_(const IfThenElse *op) final {
+    ++guards_;
+    IRVisitor::Visit_(op);
+    --guards_;
+  }
+
+  void Visit_(const Provide *op) final {
+    written_.insert(op->func.get());
+    GemmOutput &out = last_write_[op->func.get()];
+    out.write = op;
+    // a guarded write may skip elements
+    out.elems = guards_ == 0 ? 1 : -1;
+    for (const auto loop : loops_) {
+      if (out.elems < 0) {
+        break;
+      }
+      const int64_t *extent = as_const_int(loop->extent);
+      bool indexed = std::any_of(op->args.begin(), op->args.end(),
+                                 [loop](const Expr &arg) { return ExprUseVar(arg, loop->loop_var); });
+      out.elems = (extent == nullptr || !indexed) ? -1 : out.elems * *extent;
+    }
+    IRVisitor::Visit_(op);
+  }
+
+  std::unordered_set<const Node *> written_;
+  std::unordered_map<const Node *, GemmOutput> last_write_;
+
+ private:
+  std::vector<const For *> loops_;
+  int guards_{0};
+};
+
+// Rewrites an epilogue value at the write of C: the store indices of the epilogue become the indices of C, and
+// the tensors folded so far are replaced by their values.
+class EpilogueRewriter : public IRMutator {
+ public:
+  EpilogueRewriter(const Array<Expr> &from, const Array<Expr> &to,
+                   const std::unordered_map<const Node *, Expr> &values)
+      : from_(from), to_(to), values_(values) {}
+
+  Expr Mutate(Expr e) final {
+    for (size_t i = 0; i < from_.size(); ++i) {
+      if (Equal(e, from_[i])) {
+        return to_[i];
+      }
+    }
+    return IRMutator::Mutate(e);
+  }
+
+  Expr Mutate_(const Call *op, const Expr &e) final {
+    if (op->call_type == Call::Halide && values_.count(op->func.get()) > 0) {
+      if (op->args.size() != from_.size()) {
+        valid_ = false;
+        return e;
+      }
+      for (size_t i = 0; i < from_.size(); ++i) {
+        if (!Equal(op->args[i], from_[i])) {
+          valid_ = false;
+          return e;
+        }
+      }
+      return values_.at(op->func.get());
+    }
+    return IRMutator::Mutate_(op, e);
+  }
+
+  bool valid_{true};
+
+ private:
+  const Array<Expr> &from_;
+  const Array<Expr> &to_;
+  const std::unordered_map<const Node *, Expr> &values_;
+};
+
+class ProvideReplacer : public IRMutator {
+ public:
+  ProvideReplacer(const Provide *target, const Stmt &stmt) : target_(target), stmt_(stmt) {}
+
+  Stmt Mutate_(const Provide *op, const Stmt &s) final { return op == target_ ? stmt_ : s; }
+
+ private:
+  const Provide *target_;
+  Stmt stmt_;
+};
+
+class GemmEpilogueFuser : public IRMutator {
+ public:
+  Stmt Mutate_(const Block *op, const Stmt &s) final {
+    std::vector<Stmt> stmts;
+    FlattenBlock(s, &stmts);
+    std::vector<Stmt> fused;
+    for (const auto &stmt : stmts) {
+      if (!fused.empty() && TryFuse(fused.back(), stmt)) {
+        continue;
+      }
+      fused.push_back(stmt);
+    }
+    for (auto &stmt : fused) {
+      stmt = Mutate(stmt);
+    }
+    return Block::make(fused);
+  }
+
+ private:
+  static void FlattenBlock(const Stmt &s, std::vector<Stmt> *stmts) {
+    if (const auto block = s.as<Block>()) {
+      FlattenBlock(block->first, stmts);
+      FlattenBlock(block->rest, stmts);
+    } else {
+      stmts->push_back(s);
+    }
+  }
+
+  // the provides of a perfect nest, and the number of points it visits
+  static bool MatchEpilogue(const Stmt &s, std::vector<const Provide *> *provides, int64_t *points) {
+    Stmt body = s;
+    *points = 1;
+    while (const auto loop = body.as<For>()) {
+      const int64_t *extent = as_const_int(loop->extent);
+      if (extent == nullptr || !is_zero(loop->min)) {
+        return false;
+      }
+      *points *= *extent;
+      body = loop->body;
+    }
+    if (!s.as<For>()) {
+      return false;
+    }
+    std::vector<Stmt> stmts;
+    FlattenBlock(body, &stmts);
+    for (const auto &stmt : stmts) {
+      const auto provide = stmt.as<Provide>();
+      if (provide == nullptr) {
+        return false;
+      }
+      provides->push_back(provide);
+    }
+    return !provides->empty();
+  }
+
+  // folds the epilogue nest into the gemm nest, which is replaced in place
+  bool TryFuse(Stmt &gemm, const Stmt &epilogue) {
+    std::vector<const Provide *> provides;
+    int64_t points = 0;
+    if (!MatchEpilogue(epilogue, &provides, &points)) {
+      return false;
+    }
+    GemmOutputFinder finder;
+    finder.Visit(gemm);
+
+    // the epilogue reads the gemm output at its own store indices
+    const Array<Expr> &indices = provides.front()->args;
+    const GemmOutput *out = nullptr;
+    PostOrderVisit(provides.front()->value, [&finder, &out, &indices](const NodeRef &node) {
+      const auto call = node.as<Call>();
+      if (call == nullptr || call->call_type != Call::Halide || finder.last_write_.count(call->func.get()) == 0) {
+        return;
+      }
+      const GemmOutput &write = finder.last_write_.at(call->func.get());
+      if (write.elems > 0 && call->args.size() == indices.size() &&
+          std::equal(indices.begin(), indices.end(), call->args.begin(),
+                     [](const Expr &a, const Expr &b) { return Equal(a, b); })) {
+        out = &write;
+      }
+    });
+    if (out == nullptr || out->elems != points || TensorElems(out->write) != points) {
+      return false;
+    }
+
+    // a write that reads C itself, such as C = C + C_local, leaves its value in C only after it, so the epilogue
+    // reloads C at the write indices
+    Expr c_value = out->write->value;
+    const Provide *write = out->write;
+    PostOrderVisit(write->value, [&c_value, write](const NodeRef &node) {
+      const auto call = node.as<Call>();
+      if (call != nullptr && call->call_type == Call::Halide && call->func.same_as(write->func)) {
+        c_value = Call::make(write->value.type(), Downcast<Operation>(write->func)->name, write->args, Call::Halide,
+                             write->func, write->value_index);
+      }
+    });
+    std::unordered_map<const Node *, Expr> values = {{write->func.get(), c_value}};
+    std::vector<Stmt> stores = {GetRef<Stmt>(out->write)};
+    for (const auto provide : provides) {
+      if (provide->args.size() != indices.size() || finder.written_.count(provide->func.get()) > 0 ||
+          values.count(provide->func.get()) > 0 ||
+          !std::equal(indices.begin(), indices.end(), provide->args.begin(),
+                      [](const Expr &a, const Expr &b) { return Equal(a, b); })) {
+        return false;
+      }
+      bool reads_gemm = false;
+      PostOrderVisit(provide->value, [&finder, &values, &reads_gemm](const NodeRef &node) {
+        const auto call = node.as<Call>();
+        if (call != nullptr && call->call_type == Call::Halide && finder.written_.count(call->func.get()) > 0 &&
+            values.count(call->func.get()) == 0) {
+          reads_gemm = true;
+        }
+      });
+      if (reads_gemm) {
+        return false;
+      }
+      EpilogueRewriter rewriter(indices, out->write->args, values);
+      Expr value = rewriter.Mutate(provide->value);
+      if (!rewriter.valid_ || UsesEpilogueVar(value, epilogue)) {
+        return false;
+      }
+      values[provide->func.get()] = value;
+      stores.push_back(Provide::make(provide->func, provide->value_index, value, out->write->args));
+    }
+
+    gemm = ProvideReplacer(out->write, Block::make(stores)).Mutate(gemm);
+    return true;
+  }
+
+  static bool UsesEpilogueVar(const Expr &value, const Stmt &epilogue) {
+    std::unordered_set<const Variable *> vars;
+    for (Stmt body = epilogue; const auto loop = body.as<For>(); body = loop->body) {
+      vars.insert(loop->loop_var.get());
+    }
+    return ExprUseVar(value, vars);
+  }
+};
+
+// only the matmul template packs its operands
+bool IsCpuGemm(const Stmt &stmt) {
+  bool found = false;
+  PostOrderVisit(stmt, [&found](const NodeRef &node) {
+    const auto attr = node.as<AttrStmt>();
+    if (attr != nullptr && attr->attr_key == GEMM_PACK_A) {
+      found = true;
+    }
+  });
+  return found;
+}
+}  // namespace
+
+Stmt FuseCpuGemmEpilogue(const Stmt &stmt) {
+  if (!IsCpuGemm(stmt)) {
+    return stmt;
+  }
+  return GemmEpilogueFuser().Mutate(stmt);
+}
+}  // namespace ir
+}  // namespace akg
@@ -0,0 +1,312 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pass/gpu_kernel_analyzer.h"
+
+#include <tvm/arithmetic.h>
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/target_info.h"
+#include "pass/utils.h"
+
+namespace akg {
+namespace ir {
+namespace {
+constexpr int64_t kBaseRegsPerThread = 16;
+constexpr int64_t kBytesPerRegister = 4;
+constexpr int64_t kWarpSize = 32;
+constexpr auto kThreadIdxX = "threadIdx.x";
+constexpr auto kBlockIdxPrefix = "blockIdx.";
+constexpr auto kThreadIdxPrefix = "threadIdx.";
+
+int64_t CeilTo(int64_t value, int64_t unit) { return unit <= 0 ? value : ((value + unit - 1) / unit) * unit; }
+
+class GpuKernelVisitor : public IRVisitor {
+ public:
+  explicit GpuKernelVisitor(GpuKernelReport &report) : report_(report) {}
+  ~GpuKernelVisitor() override = default;
+
+  void Run(const LoweredFunc &func) {
+    for (const auto &arg : func->args) {
+      (void)global_vars_.insert(arg.get());
+    }
+    Visit(func->body);
+    for (const auto &it : block_extent_) {
+      report_.grid_size *= it.second;
+    }
+    for (const auto &it : thread_extent_) {
+      report_.threads_per_block *= it.second;
+    }
+    int64_t total_threads = report_.grid_size * report_.threads_per_block;
+    report_.flops = flops_per_thread_ * total_threads;
+    report_.global_bytes = bytes_per_thread_ * total_threads;
+    report_.regs_per_thread = EstimateRegsPerThread(report_.local_bytes, static_cast<int64_t>(scalar_vars_.size()));
+  }
+
+  void Visit_(const AttrStmt *op) final {
+    if (op->attr_key == air::ir::attr::thread_extent) {
+      auto iv = op->node.as<IterVarNode>();
+      auto extent = op->value.as<IntImm>();
+      if (iv != nullptr && extent != nullptr) {
+        const std::string &tag = iv->thread_tag;
+        if (tag.compare(0, strlen(kBlockIdxPrefix), kBlockIdxPrefix) == 0) {
+          block_extent_[tag] = std::max<int64_t>(block_extent_[tag], extent->value);
+        } else if (tag.compare(0, strlen(kThreadIdxPrefix), kThreadIdxPrefix) == 0) {
+          thread_extent_[tag] = std::max<int64_t>(thread_extent_[tag], extent->value);
+          if (tag == kThreadIdxX) {
+            thread_x_ = iv->var;
+          }
+        }
+      }
+    } else if (op->attr_key == air::ir::attr::storage_scope) {
+      auto buf = op->node.as<Variable>();
+      auto scope = op->value.as<StringImm>();
+      if (buf != nullptr && scope != nullptr) {
+        storage_scope_[buf] = scope->value;
+      }
+    }
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Allocate *op) final {
+    int64_t elems = op->constant_allocation_size();
+    int64_t bytes = elems * op->type.bytes() * op->type.lanes();
+    std::string scope = storage_scope_.count(op->buffer_var.get()) ? storage_scope_[op->buffer_var.get()] : "";
+    if (scope == "shared") {
+      report_.shared_bytes += bytes;
+    } else if (scope == "local" || scope.find("wmma") != std::string::npos) {
+      // fragments are distributed over the lanes of a warp
+      report_.local_bytes += scope == "local" ? bytes : CeilTo(bytes, kWarpSize) / kWarpSize;
+    } else if (scope == "global") {
+      (void)global_vars_.insert(op->buffer_var.get());
+    }
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const For *op) final {
+    (void)scalar_vars_.insert(op->loop_var.get());
+    int64_t extent = 1;
+    if (auto imm = op->extent.as<IntImm>()) {
+      extent = std::max<int64_t>(imm->value, 1);
+    }
+    int64_t saved = trips_;
+    trips_ *= extent;
+    IRVisitor::Visit_(op);
+    trips_ = saved;
+  }
+
+  void Visit_(const LetStmt *op) final {
+    (void)scalar_vars_.insert(op->var.get());
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Load *op) final {
+    CountGlobalAccess(op->buffer_var.get(), op->index, op->type);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Store *op) final {
+    CountGlobalAccess(op->buffer_var.get(), op->index, op->value.type());
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Add *op) final { CountFlops(op->type, op); }
+  void Visit_(const Sub *op) final { CountFlops(op->type, op); }
+  void Visit_(const Mul *op) final { CountFlops(op->type, op); }
+  void Visit_(const Div *op) final { CountFlops(op->type, op); }
+  void Visit_(const Min *op) final { CountFlops(op->type, op); }
+  void Visit_(const Max *op) final { CountFlops(op->type, op); }
+
+  void Visit_(const Call *op) final {
+    if (op->type.is_float() && (op->call_type == Call::PureIntrinsic || op->call_type == Call::PureExtern)) {
+      flops_per_thread_ += trips_ * op->type.lanes();
+    }
+    IRVisitor::Visit_(op);
+  }
+
+ private:
+  template <typename T>
+  void CountFlops(const Type &type, const T *op) {
+    if (type.is_float()) {
+      flops_per_thread_ += trips_ * type.lanes();
+    }
+    IRVisitor::Visit_(op);
+  }
+
+  void CountGlobalAccess(const Variable *buf, const Expr &index, const Type &type) {
+    if (global_vars_.count(buf) == 0) {
+      return;
+    }
+    bytes_per_thread_ += trips_ * type.bytes() * type.lanes();
+    if (!thread_x_.defined()) {
+      ++report_.uniform_accesses;
+      return;
+    }
+    Expr base = index;
+    int64_t lanes = 1;
+    if (auto ramp = index.as<Ramp>()) {
+      if (!is_const_int(ramp->stride, 1)) {
+        ++report_.strided_accesses;
+        return;
+      }
+      base = ramp->base;
+      lanes = ramp->lanes;
+    }
+    Array<Expr> coef = air::arith::DetectLinearEquation(base, {thread_x_});
+    if (coef.size() != 2 || coef[0].as<IntImm>() == nullptr) {
+      ++report_.unknown_accesses;
+      return;
+    }
+    int64_t stride = std::abs(coef[0].as<IntImm>()->value);
+    if (stride == 0) {
+      ++report_.uniform_accesses;
+    } else if (stride <= lanes) {
+      ++report_.coalesced_accesses;
+    } else {
+      ++report_.strided_accesses;
+    }
+  }
+
+  GpuKernelReport &report_;
+  Var thread_x_;
+  int64_t trips_{1};
+  int64_t flops_per_thread_{0};
+  int64_t bytes_per_thread_{0};
+  std::unordered_map<std::string, int64_t> block_extent_;
+  std::unordered_map<std::string, int64_t> thread_extent_;
+  std::unordered_map<const Variable *, std::string> storage_scope_;
+  std::unordered_set<const Variable *> global_vars_;
+  std::unordered_set<const Variable *> scalar_vars_;
+};
+}  // namespace
+
+GpuSmConfig GetGpuSmConfig(const std::string &device_type) {
+  GpuSmConfig sm;
+  air::GpuComputeInfo compute = air::GetGpuComputeInfo("instance", device_type);
+  if (compute.defined()) {
+    sm.num_sm = compute->num_sm;
+    sm.max_threads_per_sm = compute->max_threads_per_sm;
+    sm.max_blocks_per_sm = compute->max_blocks_per_sm;
+    sm.regs_per_sm = compute->regs_per_sm;
+    sm.max_regs_per_thread = compute->max_regs_per_thread;
+    sm.shared_bytes_per_sm = compute->shared_bytes_per_sm;
+    sm.peak_gflops = compute->peak_gflops;
+    sm.mem_bandwidth_gbps = compute->mem_bandwidth_gbps;
+  }
+  air::GpuMemoryInfo shared = air::GetGpuMemoryInfo("shared", device_type);
+  if (shared.defined()) {
+    sm.shared_bytes_per_block = shared->max_bytes_per_block;
+  }
+  return sm;
+}
+
+int64_t EstimateRegsPerThread(int64_t local_bytes, int64_t scalar_vars) {
+  return kBaseRegsPerThread + (local_bytes + kBytesPerRegister - 1) / kBytesPerRegister + scalar_vars;
+}
+
+GpuOccupancy ComputeGpuOccupancy(const GpuSmConfig &sm, int64_t threads_per_block, int64_t regs_per_thread,
+                                 int64_t shared_bytes_per_block) {
+  GpuOccupancy result;
+  if (threads_per_block <= 0 || threads_per_block > sm.max_threads_per_block ||
+      regs_per_thread > sm.max_regs_per_thread || shared_bytes_per_block > sm.shared_bytes_per_block) {
+    result.limiter = threads_per_block > sm.max_threads_per_block ? "threads"
+                     : regs_per_thread > sm.max_regs_per_thread   ? "registers"
+                                                                  : "shared";
+    return result;
+  }
+  int64_t max_warps = sm.max_threads_per_sm / sm.warp_size;
+  int64_t warps_per_block = (threads_per_block + sm.warp_size - 1) / sm.warp_size;
+
+  std::vector<std::pair<int64_t, std::string>> limits;
+  limits.emplace_back(max_warps / warps_per_block, "threads");
+  limits.emplace_back(sm.max_blocks_per_sm, "blocks");
+  int64_t regs_per_warp = CeilTo(std::max<int64_t>(regs_per_thread, 1) * sm.warp_size, sm.reg_alloc_unit);
+  limits.emplace_back((sm.regs_per_sm / regs_per_warp) / warps_per_block, "registers");
+  if (shared_bytes_per_block > 0) {
+    limits.emplace_back(sm.shared_bytes_per_sm / CeilTo(shared_bytes_per_block, sm.shared_alloc_unit), "shared");
+  }
+  auto min_limit = *std::min_element(limits.begin(), limits.end(),
+                                     [](const std::pair<int64_t, std::string> &a,
+                                        const std::pair<int64_t, std::string> &b) { return a.first < b.first; });
+  result.active_blocks_per_sm = min_limit.first;
+  result.limiter = min_limit.second;
+  result.active_warps_per_sm = result.active_blocks_per_sm * warps_per_block;
+  result.occupancy = static_cast<double>(result.active_warps_per_sm) / max_warps;
+  return result;
+}
+
+std::string GpuKernelReport::ToString() const {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "[GpuKernelReport] " << name << "\n";
+  ss << "  launch: grid = " << grid_size << ", block = " << threads_per_block << "\n";
+  ss << "  resource: shared = " << shared_bytes << " bytes/block, local = " << local_bytes
+     << " bytes/thread, regs = " << regs_per_thread << "/thread (estimated)\n";
+  ss << "  occupancy: " << occupancy.occupancy << " (" << occupancy.active_blocks_per_sm << " blocks, "
+     << occupancy.active_warps_per_sm << " warps per sm, limited by " << occupancy.limiter << ")\n";
+  ss << "  roofline: flops = " << flops << ", global bytes = " << global_bytes << ", intensity = " << arith_intensity
+     << " flop/byte, ridge = " << ridge_point << " -> " << (memory_bound ? "memory bound" : "compute bound") << "\n";
+  ss << "  global access: coalesced = " << coalesced_accesses << ", uniform = " << uniform_accesses
+     << ", strided = " << strided_accesses << ", unknown = " << unknown_accesses;
+  return ss.str();
+}
+
+Map<std::string, NodeRef> GpuKernelReport::ToMap() const {
+  Map<std::string, NodeRef> res;
+  res.Set("grid_size", make_const(Int(64), grid_size));
+  res.Set("threads_per_block", make_const(Int(64), threads_per_block));
+  res.Set("shared_bytes", make_const(Int(64), shared_bytes));
+  res.Set("regs_per_thread", make_const(Int(64), regs_per_thread));
+  res.Set("active_blocks_per_sm", make_const(Int(64), occupancy.active_blocks_per_sm));
+  res.Set("occupancy", make_const(Float(64), occupancy.occupancy));
+  res.Set("occupancy_limiter", StringImm::make(occupancy.limiter));
+  res.Set("flops", make_const(Int(64), flops));
+  res.Set("global_bytes", make_const(Int(64), global_bytes));
+  res.Set("arith_intensity", make_const(Float(64), arith_intensity));
+  res.Set("memory_bound", make_const(Bool(), memory_bound));
+  res.Set("coalesced_accesses", make_const(Int(32), coalesced_accesses));
+  res.Set("uniform_accesses", make_const(Int(32), uniform_accesses));
+  res.Set("strided_accesses", make_const(Int(32), strided_accesses));
+  res.Set("unknown_accesses", make_const(Int(32), unknown_accesses));
+  return res;
+}
+
+GpuKernelReport AnalyzeGpuKernel(const LoweredFunc &func, const GpuSmConfig &sm) {
+  GpuKernelReport report;
+  report.name = func->name;
+  GpuKernelVisitor(report).Run(func);
+  report.occupancy = ComputeGpuOccupancy(sm, report.threads_per_block, report.regs_per_thread, report.shared_bytes);
+  report.arith_intensity =
+    report.global_bytes > 0 ? static_cast<double>(report.flops) / static_cast<double>(report.global_bytes) : 0.0;
+  report.ridge_point = sm.mem_bandwidth_gbps > 0 ? sm.peak_gflops / sm.mem_bandwidth_gbps : 0.0;
+  report.memory_bound = report.arith_intensity < report.ridge_point;
+  return report;
+}
+
+Map<std::string, NodeRef> AnalyzeGpuKernelApi(const LoweredFunc &func, const std::string &device_type) {
+  return AnalyzeGpuKernel(func, GetGpuSmConfig(device_type)).ToMap();
+}
+
+TVM_REGISTER_API("ir_pass.AnalyzeGpuKernel").set_body_typed(AnalyzeGpuKernelApi);
+}  // namespace ir
+}  // namespace akg
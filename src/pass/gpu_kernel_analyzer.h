@@ -0,0 +1,103 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PASS_GPU_KERNEL_ANALYZER_H_
+#define PASS_GPU_KERNEL_ANALYZER_H_
+
+#include <string>
+
+#include "tvm.h"
+
+namespace akg {
+namespace ir {
+/*!
+ * \brief Static resource limits of one streaming multiprocessor, used by the occupancy model.
+ */
+struct GpuSmConfig {
+  int num_sm{80};
+  int warp_size{32};
+  int max_threads_per_block{1024};
+  int max_threads_per_sm{2048};
+  int max_blocks_per_sm{32};
+  int regs_per_sm{64 * 1024};
+  int max_regs_per_thread{255};
+  // registers are allocated per warp with this granularity
+  int reg_alloc_unit{256};
+  int shared_bytes_per_sm{96 * 1024};
+  int shared_bytes_per_block{48 * 1024};
+  int shared_alloc_unit{256};
+  double peak_gflops{15700.0};
+  double mem_bandwidth_gbps{900.0};
+};
+
+/*!
+ * \brief Build the sm config from the registered GpuComputeInfo/GpuMemoryInfo of the device.
+ */
+GpuSmConfig GetGpuSmConfig(const std::string &device_type);
+
+struct GpuOccupancy {
+  int64_t active_blocks_per_sm{0};
+  int64_t active_warps_per_sm{0};
+  double occupancy{0.0};
+  // resource that bounds active_blocks_per_sm: "threads", "blocks", "registers" or "shared"
+  std::string limiter;
+};
+
+/*!
+ * \brief Theoretical occupancy of a kernel launched with the given per-block resources.
+ *  An occupancy of zero means the block cannot be resident on a sm at all.
+ */
+GpuOccupancy ComputeGpuOccupancy(const GpuSmConfig &sm, int64_t threads_per_block, int64_t regs_per_thread,
+                                 int64_t shared_bytes_per_block);
+
+/*!
+ * \brief Rough register usage of one thread: a fixed base for indices and pointers plus the
+ *  32-bit words of thread-local buffers and scalar temporaries.
+ */
+int64_t EstimateRegsPerThread(int64_t local_bytes, int64_t scalar_vars);
+
+struct GpuKernelReport {
+  std::string name;
+  int64_t grid_size{1};
+  int64_t threads_per_block{1};
+  int64_t shared_bytes{0};
+  int64_t local_bytes{0};
+  int64_t regs_per_thread{0};
+  GpuOccupancy occupancy;
+  // floating point operations and global memory traffic of the whole launch, without cache reuse
+  int64_t flops{0};
+  int64_t global_bytes{0};
+  double arith_intensity{0.0};
+  double ridge_point{0.0};
+  bool memory_bound{true};
+  // global accesses classified by their stride along threadIdx.x
+  int coalesced_accesses{0};
+  int uniform_accesses{0};
+  int strided_accesses{0};
+  int unknown_accesses{0};
+
+  std::string ToString() const;
+  Map<std::string, NodeRef> ToMap() const;
+};
+
+/*!
+ * \brief Analyze a lowered cuda device function without running it: shared memory and estimated registers
+ *  per thread, theoretical occupancy, flops against bytes moved, and coalescing of global accesses.
+ */
+GpuKernelReport AnalyzeGpuKernel(const LoweredFunc &func, const GpuSmConfig &sm);
+}  // namespace ir
+}  // namespace akg
+#endif  // PASS_GPU_KERNEL_ANALYZER_H_
@@ -59,6 +59,8 @@ class IfTensorCore : public IRVisitor {
 
 class PrefetchScopeInjector : public IRMutator {
  public:
+  explicit PrefetchScopeInjector(int stages) : stages_(stages) {}
+
   bool HasShared(const Stmt &s) {
     if (auto store = s.as<Store>()) {
       is_nested_block_ = true;
@@ -106,7 +108,7 @@ class PrefetchScopeInjector : public IRMutator {
     if (IsPrefetchBlock(s)) {
       prefetch_outer_loop_ = (loop_nest_.back()->extent).as<IntImm>()->value;
       if_prefetch_injected_ = true;
-      return AttrStmt::make(prefetch_var_, PREFETCH_SCOPE, 1, s);
+      return AttrStmt::make(prefetch_var_, PREFETCH_SCOPE, stages_, s);
     } else if (is_nested_block_) {
       return s;
     } else {
@@ -121,7 +123,7 @@ class PrefetchScopeInjector : public IRMutator {
     if (IsPrefetchBlock(s)) {
       prefetch_outer_loop_ = (loop_nest_.back()->extent).as<IntImm>()->value;
       if_prefetch_injected_ = true;
-      return AttrStmt::make(prefetch_var_, PREFETCH_SCOPE, 1, s);
+      return AttrStmt::make(prefetch_var_, PREFETCH_SCOPE, stages_, s);
     }
     return IRMutator::Mutate_(op, s);
   }
@@ -161,6 +163,8 @@ class PrefetchScopeInjector : public IRMutator {
   const int GetPrefetchOuterLoop() { return prefetch_outer_loop_; }
 
  private:
+  // the number of shared memory stages, carried to InjectDoubleBuffer by the value of the scope
+  int stages_;
   std::unordered_set<const Variable *> touched_;
   VarExpr prefetch_var_;
   std::vector<const For *> loop_nest_;
@@ -260,6 +264,7 @@ class IfResouceIsEnough : public IRVisitor {
       return thread_x_value_;
   }
   const int GetTotalSharedUsage() { return shared_usage_.as<IntImm>()->value; }
+  const bool IsSharedUsageConstant() { return shared_usage_.as<IntImm>() != nullptr; }
   const int GetTotalLocalUsage() { return (promote_local_usage_ + prefetch_local_usage_).as<IntImm>()->value; }
 
  private:
@@ -316,9 +321,29 @@ class ThreadGroupScopeInjector : public IRMutator {
   Expr thread_offset_;
 };
 
+// The number of shared memory stages requested for the K loop, reduced until all stages fit in shared memory.
+static int GetPipelineStages(const Stmt &stmt) {
+  int stages = g_attrs.GetInt(kSharedPipelineStages, 0);
+  if (stages <= 2) return stages;
+  IfResouceIsEnough resource_calc;
+  resource_calc.Visit(stmt);
+  if (!resource_calc.IsSharedUsageConstant()) return stages;
+  const int total_shared_usage = resource_calc.GetTotalSharedUsage();
+  int fit_stages = stages;
+  while (fit_stages > 2 && total_shared_usage * fit_stages > static_cast<int>(common::ADVANCED_SHARED_MEMORY_SIZE)) {
+    --fit_stages;
+  }
+  if (fit_stages != stages) {
+    LOG(WARNING) << stages << " shared memory stages of " << total_shared_usage << " bytes exceed the shared memory, use "
+                 << fit_stages << " stages instead.";
+  }
+  return fit_stages;
+}
+
 Stmt InjectTransferBufferScope(Stmt stmt) {
   if (!IfTensorCore().IfUseTensorCore(stmt)) return stmt;
-  PrefetchScopeInjector prefetch_injector;
+  const int pipeline_stages = GetPipelineStages(stmt);
+  PrefetchScopeInjector prefetch_injector(std::max(pipeline_stages, 1));
   Stmt new_stmt = prefetch_injector.Mutate(stmt);
   const bool if_prefetch_injected = prefetch_injector.GetIfPrefetchInjected();
   if (!if_prefetch_injected) return stmt;
@@ -354,6 +379,11 @@ Stmt InjectTransferBufferScope(Stmt stmt) {
       }
     }
   }
+  // pipelining shared memory over two or more stages builds on double buffer
+  if (pipeline_stages >= 2 && !enable_double_buffer) {
+    enable_double_buffer = true;
+    g_attrs.Set(kEnableDoubleBuffer, air::make_const(Int(BIT32), true));
+  }
   // avoid enabling two modes
   if (enable_double_buffer) {
     enable_transfer_buffer = false;
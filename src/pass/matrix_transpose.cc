@@ -25,7 +25,7 @@ namespace ir {
 static constexpr auto PROMOTE_TRANSPOSE = "promoted_transpose";
 static constexpr auto MATRIX_TRANSPOSE = "MatrixTranspose";
 static constexpr auto INT32 = 32;
-static constexpr auto PARAMETER_NUM = 4;
+static constexpr auto PARAMETER_NUM = 5;
 static constexpr size_t LOOP_NUM = 2;
 
 class MatrixTransposeMutator : public IRMutator {
@@ -84,7 +84,8 @@ class MatrixTransposeMutator : public IRMutator {
     for (auto shape : shapes) {
       args.push_back(shape);
     }
-    CHECK(args.size() == PARAMETER_NUM) << "The number of input parameters of the transpose interface must be 4.";
+    args.push_back(make_const(Int(INT32), pro_value->type.bits()));
+    CHECK(args.size() == PARAMETER_NUM) << "The number of input parameters of the transpose interface must be 5.";
     Expr dst_call = Call::make(pro_value->type, pro_func->func_name(), indices, pro_value->call_type, pro_func,
                                pro_value->value_index);
     Expr src_call = Call::make(pro_value->type, pro_value->name, indices, pro_value->call_type, pro_value->func,
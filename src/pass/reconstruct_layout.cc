@@ -28,6 +28,7 @@
 #include <tvm/runtime/device_api.h>
 
 #include <unordered_map>
+#include <unordered_set>
 
 #include "common/common_util.h"
 #include "pass/utils.h"
@@ -51,6 +52,8 @@ static constexpr auto TRANS_B = "col_major_matrix_b";
 static constexpr auto PREPARE_PACK = "prepare_pack";
 static constexpr auto PACK_A_SIZE = 4;
 static constexpr auto PACK_B_SIZE = 24;
+// k of an int8 gemm is packed in groups that the cpu dot product instructions read as one 32-bit word
+static constexpr auto PACK_K_INT8 = 4;
 static constexpr size_t LOOP_NUM = 2;
 static constexpr auto NUM_2 = 2;
 static constexpr auto NUM_3 = 3;
@@ -470,6 +473,9 @@ class CPULocalReconstruction : public IRMutator {
       } else {
         b_func_ = op->func;
       }
+      if (op->type.bits() == NUM_8) {
+        int8_funcs_.insert(op->func.get());
+      }
       auto body = IRMutator::Mutate(op->body);
       auto block_size = matrix_name == MATRIX_A ? a_block_size_ : b_block_size_;
       auto trans = matrix_name == MATRIX_A ? a_trans_ : b_trans_;
@@ -491,6 +497,14 @@ class CPULocalReconstruction : public IRMutator {
         new_bounds.push_back(op->bounds[i]);
       }
       new_bounds.push_back(Range::make_by_min_extent(bound_n->min, floordiv(bound_n->extent, block_size)));
+      if (int8_funcs_.count(op->func.get()) > 0) {
+        // u8s8 layout [n / block, k / 4, block, 4]
+        new_bounds.push_back(
+          Range::make_by_min_extent(bound_k->min, floordiv(bound_k->extent + PACK_K_INT8 - 1, PACK_K_INT8)));
+        new_bounds.push_back(Range::make_by_min_extent(bound_n->min, block_size));
+        new_bounds.push_back(Range::make_by_min_extent(bound_k->min, PACK_K_INT8));
+        return Realize::make(op->func, op->value_index, op->type, new_bounds, op->condition, body);
+      }
       new_bounds.push_back(bound_k);
       new_bounds.push_back(Range::make_by_min_extent(bound_n->min, block_size));
       return Realize::make(op->func, op->value_index, op->type, new_bounds, op->condition, body);
@@ -554,6 +568,12 @@ class CPULocalReconstruction : public IRMutator {
       new_args.push_back(op->args[i]);
     }
     new_args.push_back(floordiv(n, block_size));
+    if (int8_funcs_.count(op->func.get()) > 0) {
+      new_args.push_back(floordiv(k, PACK_K_INT8));
+      new_args.push_back(indexmod(n, block_size));
+      new_args.push_back(indexmod(k, PACK_K_INT8));
+      return new_args;
+    }
     new_args.push_back(k);
     new_args.push_back(indexmod(n, block_size));
     return new_args;
@@ -622,6 +642,7 @@ class CPULocalReconstruction : public IRMutator {
   std::vector<const For *> fors_;
   Stmt provide_;
   std::string matrix_b_;
+  std::unordered_set<const Node *> int8_funcs_;
 };
 
 Stmt ReconstructLayout(const Stmt &stmt) {
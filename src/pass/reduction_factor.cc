@@ -794,6 +794,10 @@ class ReduceVectorizeEnable : public IRMutator {
       }
       final_reduce = For::make(loop_var, cur_reduce_data_->parallel_for->min, cur_reduce_data_->parallel_for->extent,
                              air::ir::ForType::Serial, cur_reduce_data_->parallel_for->device_api, final_reduce);
+    } else if (vector_parallel_for->for_type == air::ir::ForType::Parallel && is_zero(vector_parallel_for->min) &&
+               as_const_int(vector_parallel_for->extent) != nullptr &&
+               cur_reduce_data_->outter_reduction_data == nullptr) {
+      final_reduce = MakeTreeFinalReduce(vector_parallel_for, reduce_provide_new, loop_var);
     } else {
       final_reduce = For::make(loop_var, vector_parallel_for->min, vector_parallel_for->extent,
                                   air::ir::ForType::Serial, vector_parallel_for->device_api, reduce_provide_new);
@@ -843,6 +847,55 @@ class ReduceVectorizeEnable : public IRMutator {
     return stmt;
   }
 
+  /*
+   * The partial results of the parallel tiles are combined pairwise in a fixed order, which depends on the number of
+   * tiles only and not on the threads that computed them, e.g. for 6 tiles:
+   * for (i, 0, 3) temp[i * 2] = temp[i * 2] + temp[i * 2 + 1]
+   * for (i, 0, 1) temp[i * 4] = temp[i * 4] + temp[i * 4 + 2]
+   * for (i, 0, 1) temp[i * 8] = temp[i * 8] + temp[i * 8 + 4]
+   * dst = dst + temp[0]
+   */
+  Stmt MakeTreeFinalReduce(const For *parallel_for, const Stmt &final_provide, const Var &final_var) {
+    int64_t extent = *as_const_int(parallel_for->extent);
+    Type index_type = parallel_for->loop_var.type();
+    Expr reduce_value = cur_reduce_data_->reduce_provide->value;
+    std::vector<Stmt> stmts;
+    for (int64_t stride = 1; stride < extent; stride *= 2) {
+      Var i(parallel_for->loop_var->name_hint + std::to_string(var_name_count_++), index_type);
+      Expr lhs_index = i * make_const(index_type, stride * 2);
+      Expr rhs_index = lhs_index + make_const(index_type, stride);
+      Expr value =
+        MakeReduceValue(reduce_value, MakeCallFromTempTensor({lhs_index}), MakeCallFromTempTensor({rhs_index}));
+      Stmt provide = Provide::make(cur_reduce_data_->temp_tensor->op, cur_reduce_data_->temp_tensor->value_index, value,
+                                   {lhs_index});
+      int64_t pairs = (extent - stride + stride * 2 - 1) / (stride * 2);
+      stmts.push_back(For::make(i, make_zero(index_type), make_const(index_type, pairs), air::ir::ForType::Serial,
+                                parallel_for->device_api, provide));
+    }
+    Map<Var, Expr> first_tile;
+    first_tile.Set(final_var, make_zero(final_var.type()));
+    stmts.push_back(air::ir::Substitute(final_provide, first_tile));
+    return Block::make(stmts);
+  }
+
+  Expr MakeReduceValue(const Expr &reduce_value, const Expr &a, const Expr &b) {
+    if (reduce_value.as<Min>()) {
+      return Min::make(a, b);
+    } else if (reduce_value.as<Max>()) {
+      return Max::make(a, b);
+    } else if (reduce_value.as<And>()) {
+      return And::make(a, b);
+    } else if (reduce_value.as<Or>()) {
+      return Or::make(a, b);
+    } else if (reduce_value.as<Add>()) {
+      return Add::make(a, b);
+    } else if (reduce_value.as<Mul>()) {
+      return Mul::make(a, b);
+    }
+    CHECK(false) << "reduce type is invalid";
+    return Expr();
+  }
+
   Expr MakeCallFromTempTensor(const Array<Expr> &args) {
     std::string name = cur_reduce_data_->temp_tensor->op->name;
     Type type = cur_reduce_data_->temp_buffer->dtype;
@@ -879,5 +932,338 @@ Stmt ReductionFactor(const Stmt &stmt, const Map<Tensor, Buffer> &extern_buffer)
   return ReduceVectorizeEnable(identify_reduce.reduce_datas_).Mutate(stmt);
 }
 
+namespace {
+// the accumulations of one tile that pay for zeroing and merging its private copy
+constexpr int64_t kSegmentMinTileWork = 4096;
+// bound of the private copies of all the tiles together
+constexpr int64_t kSegmentMaxPrivateBytes = 64LL << 20;
+
+// Collects what the privatization of one serial loop depends on: the provides of its body, the accesses of the
+// accumulated tensor and the iterations of the provide.
+class SegmentLoopInfo : public IRVisitor {
+ public:
+  using IRVisitor::Visit_;
+
+  void Visit_(const For *op) final {
+    auto extent = as_const_int(op->extent);
+    if (extent == nullptr) {
+      valid_ = false;
+      return;
+    }
+    loop_extents_.push_back(*extent);
+    IRVisitor::Visit_(op);
+    loop_extents_.pop_back();
+  }
+
+  void Visit_(const Provide *op) final {
+    provides_.push_back(op);
+    work_ = 1;
+    for (auto extent : loop_extents_) {
+      work_ *= extent;
+    }
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Call *op) final {
+    calls_.push_back(op);
+    IRVisitor::Visit_(op);
+  }
+
+  void Visit_(const Realize *op) final { valid_ = false; }
+  void Visit_(const Allocate *op) final { valid_ = false; }
+
+  void Visit_(const AttrStmt *op) final {
+    if (op->attr_key == REDUCE_AREA_FLAG) {
+      valid_ = false;
+      return;
+    }
+    IRVisitor::Visit_(op);
+  }
+
+  bool valid_{true};
+  int64_t work_{0};
+  std::vector<int64_t> loop_extents_;
+  std::vector<const Provide *> provides_;
+  std::vector<const Call *> calls_;
+};
+
+// Moves the accumulation into the private copy of the tile and serializes the inner parallel loops, which now run
+// inside the parallel loop of the tiles.
+class PrivatizeAccumulation : public IRMutator {
+ public:
+  PrivatizeAccumulation(const Provide *target, const Tensor &private_tensor, const Var &tile)
+      : target_(target), private_tensor_(private_tensor), tile_(tile) {}
+  ~PrivatizeAccumulation() override = default;
+
+  Array<Expr> PrivateArgs(const Array<Expr> &args) const {
+    Array<Expr> private_args{tile_};
+    for (const auto &arg : args) {
+      private_args.push_back(arg);
+    }
+    return private_args;
+  }
+
+ private:
+  Stmt Mutate_(const Provide *op, const Stmt &s) final {
+    if (op != target_) {
+      return IRMutator::Mutate_(op, s);
+    }
+    return Provide::make(private_tensor_->op, 0, Mutate(op->value), PrivateArgs(op->args));
+  }
+
+  Expr Mutate_(const Call *op, const Expr &e) final {
+    if (op->func.defined() && op->func == target_->func && op->value_index == target_->value_index) {
+      return Call::make(op->type, private_tensor_->op->name, PrivateArgs(op->args), Call::Halide,
+                        private_tensor_->op, 0);
+    }
+    return IRMutator::Mutate_(op, e);
+  }
+
+  Stmt Mutate_(const For *op, const Stmt &s) final {
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    if (op->for_type != ForType::Parallel) {
+      return stmt;
+    }
+    auto new_for = stmt.as<For>();
+    CHECK(new_for);
+    return For::make(new_for->loop_var, new_for->min, new_for->extent, ForType::Serial, new_for->device_api,
+                     new_for->body);
+  }
+
+  const Provide *target_;
+  Tensor private_tensor_;
+  Var tile_;
+};
+
+/*
+ * Index driven accumulations (unsorted_segment_sum, TensorScatterAdd, csr reductions) carry a dependence over the
+ * rows, so their loop stays serial. When the output is small compared with the work, the rows are split into tiles
+ * that accumulate into private copies of the output in parallel, and the copies are merged afterwards:
+ *
+ * for (i, 0, 65536) {
+ *   for (j, 0, 32) {
+ *     if ((seg(i) >= 0) && (seg(i) < 64)) {
+ *       out(seg(i), j) = (data(i, j) + out(seg(i), j))
+ *     }
+ *   }
+ * }
+ * -->
+ * // attr [out_private] realize_scope = "local"
+ * realize out_private([0, 16], [0, 64], [0, 32]) {
+ *   for (tile, 0, 16) parallel {
+ *     for (s0, 0, 64) for (s1, 0, 32) out_private(tile, s0, s1) = 0f
+ *     for (row, 0, 4096) {
+ *       for (j, 0, 32) {
+ *         if ((seg(tile*4096 + row) >= 0) && (seg(tile*4096 + row) < 64)) {
+ *           out_private(tile, seg(tile*4096 + row), j) = (data(tile*4096 + row, j) +
+ *                                                         out_private(tile, seg(tile*4096 + row), j))
+ *         }
+ *       }
+ *     }
+ *   }
+ *   for (m0, 0, 64) parallel {
+ *     for (t, 0, 16) for (m1, 0, 32) out(m0, m1) = (out(m0, m1) + out_private(t, m0, m1))
+ *   }
+ * }
+ *
+ * The number of tiles follows from the cpu_thread_num attr, the accumulations of the loop and the size of the output,
+ * so that zeroing and merging the copies stays below half of the work. No atomics are needed since each tile owns its
+ * copy.
+ */
+class SegmentReductionPrivatizer : public IRMutator {
+ public:
+  explicit SegmentReductionPrivatizer(int thread_num) : thread_num_(thread_num) {}
+  ~SegmentReductionPrivatizer() override = default;
+
+ private:
+  Stmt Mutate_(const For *op, const Stmt &s) final {
+    if (op->for_type == ForType::Parallel) {
+      ++parallel_depth_;
+      Stmt stmt = IRMutator::Mutate_(op, s);
+      --parallel_depth_;
+      return stmt;
+    }
+    if (parallel_depth_ == 0 && op->for_type == ForType::Serial) {
+      Stmt privatized = TryPrivatize(op);
+      if (privatized.defined()) {
+        return privatized;
+      }
+    }
+    return IRMutator::Mutate_(op, s);
+  }
+
+  Stmt Mutate_(const AttrStmt *op, const Stmt &s) final {
+    // regular reductions are left to the reduction factor
+    if (op->attr_key == REDUCE_AREA_FLAG) {
+      return s;
+    }
+    return IRMutator::Mutate_(op, s);
+  }
+
+  // out(args) = out(args) + x, where some arg loads another tensor and out is not accessed elsewhere in the loop
+  static bool IsIndexDrivenAccumulation(const Provide *op, const SegmentLoopInfo &info, const Var &loop_var) {
+    auto add = op->value.as<Add>();
+    if (add == nullptr || !op->func.defined()) {
+      return false;
+    }
+    auto IsSelf = [op](const Expr &e) -> bool {
+      auto call = e.as<Call>();
+      if (call == nullptr || call->func != op->func || call->value_index != op->value_index ||
+          call->args.size() != op->args.size()) {
+        return false;
+      }
+      for (size_t i = 0; i < call->args.size(); ++i) {
+        if (!Equal(call->args[i], op->args[i])) {
+          return false;
+        }
+      }
+      return true;
+    };
+    if (!IsSelf(add->a) && !IsSelf(add->b)) {
+      return false;
+    }
+    size_t self_accesses = 0;
+    for (auto call : info.calls_) {
+      if (call->func.defined() && call->func == op->func) {
+        ++self_accesses;
+      }
+    }
+    if (self_accesses != 1) {
+      return false;
+    }
+    bool index_driven = false;
+    bool uses_loop_var = false;
+    for (const auto &arg : op->args) {
+      PostOrderVisit(arg, [&index_driven](const NodeRef &node) {
+        auto call = node.as<Call>();
+        if (call != nullptr && call->call_type == Call::Halide) {
+          index_driven = true;
+        }
+      });
+      uses_loop_var = uses_loop_var || ExprUseVar(arg, loop_var);
+    }
+    return index_driven && uses_loop_var;
+  }
+
+  int64_t NumTiles(int64_t rows, int64_t work, int64_t out_elems, int bytes) const {
+    int64_t tiles = std::max(static_cast<int64_t>(thread_num_), static_cast<int64_t>(1));
+    tiles = std::min(tiles, rows);
+    tiles = std::min(tiles, work / kSegmentMinTileWork);
+    tiles = std::min(tiles, work / (2 * out_elems));
+    tiles = std::min(tiles, kSegmentMaxPrivateBytes / (out_elems * bytes));
+    return tiles;
+  }
+
+  Stmt TryPrivatize(const For *op) {
+    auto rows = as_const_int(op->extent);
+    if (rows == nullptr || *rows <= 1) {
+      return Stmt();
+    }
+    SegmentLoopInfo info;
+    info.loop_extents_.push_back(*rows);
+    info.Visit(op->body);
+    if (!info.valid_ || info.provides_.size() != 1 ||
+        !IsIndexDrivenAccumulation(info.provides_[0], info, op->loop_var)) {
+      return Stmt();
+    }
+    const Provide *accumulation = info.provides_[0];
+    auto out_op = accumulation->func.as<OperationNode>();
+    if (out_op == nullptr) {
+      return Stmt();
+    }
+    Array<Expr> out_shape = out_op->output_shape(accumulation->value_index);
+    if (out_shape.empty() || out_shape.size() != accumulation->args.size()) {
+      return Stmt();
+    }
+    int64_t out_elems = 1;
+    for (const auto &dim : out_shape) {
+      auto extent = as_const_int(dim);
+      if (extent == nullptr || *extent <= 0) {
+        return Stmt();
+      }
+      out_elems *= *extent;
+    }
+    Type type = accumulation->value.type();
+    int64_t tiles = NumTiles(*rows, info.work_, out_elems, std::max(type.bytes(), 1));
+    if (tiles < 2) {
+      return Stmt();
+    }
+
+    Type index_type = op->loop_var.type();
+    int64_t chunk = (*rows + tiles - 1) / tiles;
+    tiles = (*rows + chunk - 1) / chunk;
+    Array<Expr> private_shape{make_const(Int(32), tiles)};
+    for (const auto &dim : out_shape) {
+      private_shape.push_back(dim);
+    }
+    Tensor private_tensor = placeholder(private_shape, type, out_op->name + "_private");
+
+    // step 1: each tile zeroes its copy, then accumulates its rows into it
+    Var tile("tile", index_type);
+    Var row(op->loop_var->name_hint + "_row", index_type);
+    PrivatizeAccumulation privatize(accumulation, private_tensor, tile);
+    Expr row_index = tile * make_const(index_type, chunk) + row;
+    Map<Var, Expr> row_map;
+    row_map.Set(op->loop_var, op->min + row_index);
+    Stmt body = air::ir::Substitute(privatize.Mutate(op->body), row_map);
+    if (chunk * tiles != *rows) {
+      body = IfThenElse::make(row_index < op->extent, body);
+    }
+    body = For::make(row, make_zero(index_type), make_const(index_type, chunk), ForType::Serial, op->device_api, body);
+
+    Array<Expr> elem_args;
+    std::vector<Var> elem_vars;
+    for (size_t i = 0; i < out_shape.size(); ++i) {
+      elem_vars.emplace_back("s" + std::to_string(i), Int(32));
+      elem_args.push_back(elem_vars.back());
+    }
+    Stmt init = Provide::make(private_tensor->op, 0, make_zero(type), privatize.PrivateArgs(elem_args));
+    for (size_t i = out_shape.size(); i > 0; --i) {
+      init = For::make(elem_vars[i - 1], 0, out_shape[i - 1], ForType::Serial, op->device_api, init);
+    }
+    Stmt accumulate = For::make(tile, make_zero(index_type), make_const(index_type, tiles), ForType::Parallel,
+                                op->device_api, Block::make(init, body));
+
+    // step 2: the copies are added to the output in tile order, in parallel over the first axis of the output
+    Var merge_tile("t", Int(32));
+    Array<Expr> merge_args;
+    std::vector<Var> merge_vars;
+    for (size_t i = 0; i < out_shape.size(); ++i) {
+      merge_vars.emplace_back("m" + std::to_string(i), Int(32));
+      merge_args.push_back(merge_vars.back());
+    }
+    Array<Expr> private_args{merge_tile};
+    for (const auto &arg : merge_args) {
+      private_args.push_back(arg);
+    }
+    Expr out_value =
+      Call::make(type, out_op->name, merge_args, Call::Halide, accumulation->func, accumulation->value_index);
+    Expr private_value = Call::make(type, private_tensor->op->name, private_args, Call::Halide, private_tensor->op, 0);
+    Stmt merge = Provide::make(accumulation->func, accumulation->value_index, Add::make(out_value, private_value),
+                               merge_args);
+    for (size_t i = out_shape.size(); i > 1; --i) {
+      merge = For::make(merge_vars[i - 1], 0, out_shape[i - 1], ForType::Serial, op->device_api, merge);
+    }
+    merge = For::make(merge_tile, 0, make_const(Int(32), tiles), ForType::Serial, op->device_api, merge);
+    merge = For::make(merge_vars[0], 0, out_shape[0], ForType::Parallel, op->device_api, merge);
+
+    Region bounds;
+    for (const auto &dim : private_shape) {
+      bounds.push_back(Range::make_by_min_extent(Expr(0), dim));
+    }
+    Stmt stmt = Realize::make(private_tensor->op, 0, type, bounds, const_true(1), Block::make(accumulate, merge));
+    return AttrStmt::make(private_tensor->op, air::ir::attr::realize_scope, Expr("local"), stmt);
+  }
+
+  // the threads the tiles are spread over, at most one private copy per thread
+  int thread_num_;
+  int parallel_depth_{0};
+};
+}  // namespace
+
+Stmt PrivatizeSegmentReduction(const Stmt &stmt, int thread_num) {
+  return SegmentReductionPrivatizer(thread_num).Mutate(stmt);
+}
+
 }  // namespace ir
 }  // namespace akg
@@ -448,6 +448,9 @@ constexpr auto AKG_REDUCE_UNSUPPORTED = "X";
 constexpr auto AKG_CONVOLUTION_TPYE = "CONVOLUTION_TPYE";
 constexpr auto AKG_CONVOLUTION_AXES = "CONVOLUTION_AXES";
 
+// cpu bandwidth bound kernel attr
+constexpr auto AKG_STREAM_OP = "STREAM_OP";
+
 constexpr auto AKG_TENSOR_NOT_PROMOTE = "TENSOR_NOT_PROMOTE";
 constexpr auto AKG_INNER_TENSOR = "INNER_TENSOR";
 constexpr auto AKG_TENSOR_OF_TENSOR = "TENSOR_OF_TENSOR";
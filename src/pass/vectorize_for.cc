@@ -13,12 +13,15 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <tvm/arithmetic.h>
 #include <tvm/ir.h>
 #include <tvm/ir_mutator.h>
 #include <tvm/ir_pass.h>
 #include <pass/ir_util.h>
 #include <algorithm>
+#include <vector>
 #include "pass/utils.h"
+#include "ir_pass.h"
 
 namespace akg {
 namespace ir {
@@ -103,5 +106,135 @@ Expr VectorizeFor::Mutate_(const Variable *op, const Expr &e) {
   }
   return IRMutator::Mutate_(op, e);
 }
+
+namespace {
+// The loads of a branch that becomes one side of a select run on every lane. The loads contiguous in the lane
+// are predicated on the guard and stay masked vector loads; the others read the first element of the buffer on the
+// lanes where the guard is false, and are emitted as gathers.
+class GuardBranchLoads : public IRMutator {
+ public:
+  GuardBranchLoads(const Expr &guard, const Var &lane) : guard_(guard), lane_(lane) {}
+  ~GuardBranchLoads() override = default;
+
+  bool Safe() const { return safe_; }
+
+ private:
+  Expr Mutate_(const Load *op, const Expr &e) final {
+    Expr index = Mutate(op->index);
+    if (IsContiguous(index)) {
+      Expr predicate = is_one(op->predicate) ? guard_ : And::make(op->predicate, guard_);
+      return Load::make(op->type, op->buffer_var, index, predicate);
+    }
+    return Load::make(op->type, op->buffer_var, Select::make(guard_, index, make_zero(index.type())), op->predicate);
+  }
+
+  // the index becomes a ramp of stride one when the loop is vectorized
+  bool IsContiguous(const Expr &index) const {
+    Array<Expr> coeffs = air::arith::DetectLinearEquation(index, {lane_});
+    return coeffs.size() == 2 && is_one(Simplify(coeffs[0]));
+  }
+
+  Expr Mutate_(const Call *op, const Expr &e) final {
+    if (!op->is_pure()) {
+      safe_ = false;
+    }
+    return IRMutator::Mutate_(op, e);
+  }
+
+  Expr Mutate_(const Let *op, const Expr &e) final {
+    safe_ = false;
+    return e;
+  }
+
+  // an integer division of a lane whose guard is false may divide by zero
+  Expr Mutate_(const Div *op, const Expr &e) final { return MutateDivision(op, e); }
+  Expr Mutate_(const Mod *op, const Expr &e) final { return MutateDivision(op, e); }
+  Expr Mutate_(const FloorDiv *op, const Expr &e) final { return MutateDivision(op, e); }
+  Expr Mutate_(const FloorMod *op, const Expr &e) final { return MutateDivision(op, e); }
+
+  template <typename T>
+  Expr MutateDivision(const T *op, const Expr &e) {
+    if (!op->b.type().is_float() && !is_const(op->b)) {
+      safe_ = false;
+      return e;
+    }
+    return IRMutator::Mutate_(op, e);
+  }
+
+  Expr guard_;
+  Var lane_;
+  bool safe_{true};
+};
+
+/*
+ * for (j, 0, 8) vectorized {
+ *   if ((0 <= idx[j]) && (idx[j] < 1024)) {
+ *     out[i*8 + j] = data[i*1024 + idx[j]]
+ *   } else {
+ *     out[i*8 + j] = 0f
+ *   }
+ * }
+ * -->
+ * for (j, 0, 8) vectorized {
+ *   out[i*8 + j] = select((0 <= idx[j]) && (idx[j] < 1024),
+ *                         data[select((0 <= idx[j]) && (idx[j] < 1024), i*1024 + idx[j], 0)], 0f)
+ * }
+ *
+ * while a load contiguous in j, e.g. x[i*8 + j], keeps its index and takes the guard as predicate.
+ *
+ * A condition on the vectorized lane makes VectorizeLoop scalarize the whole branch, which is the usual shape of the
+ * bound checks of gather, GatherNd and TensorScatterAdd. When both branches store to the same place, the branch
+ * becomes a select and the loads of each side are guarded, so the loop is vectorized: contiguous loads are emitted as
+ * masked loads and index driven loads as gathers by the llvm codegen. Other branches keep the scalar fallback.
+ */
+class VectorizedBranchSelector : public IRMutator {
+ public:
+  VectorizedBranchSelector() = default;
+  ~VectorizedBranchSelector() override = default;
+
+ private:
+  Stmt Mutate_(const For *op, const Stmt &s) final {
+    if (op->for_type != ForType::Vectorized) {
+      return IRMutator::Mutate_(op, s);
+    }
+    vectorized_vars_.insert(op->loop_var.get());
+    lanes_.push_back(op->loop_var);
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    lanes_.pop_back();
+    vectorized_vars_.erase(op->loop_var.get());
+    return stmt;
+  }
+
+  Stmt Mutate_(const IfThenElse *op, const Stmt &s) final {
+    Stmt stmt = IRMutator::Mutate_(op, s);
+    op = stmt.as<IfThenElse>();
+    if (op == nullptr || vectorized_vars_.empty() || !ExprUseVar(op->condition, vectorized_vars_)) {
+      return stmt;
+    }
+    auto then_store = op->then_case.as<Store>();
+    auto else_store = op->else_case.defined() ? op->else_case.as<Store>() : nullptr;
+    if (then_store == nullptr || else_store == nullptr || then_store->buffer_var.get() != else_store->buffer_var.get() ||
+        !Equal(then_store->index, else_store->index) || !is_one(then_store->predicate) ||
+        !is_one(else_store->predicate)) {
+      return stmt;
+    }
+    GuardBranchLoads then_guard(op->condition, lanes_.back());
+    Expr then_value = then_guard.Mutate(then_store->value);
+    GuardBranchLoads else_guard(Not::make(op->condition), lanes_.back());
+    Expr else_value = else_guard.Mutate(else_store->value);
+    if (!then_guard.Safe() || !else_guard.Safe()) {
+      return stmt;
+    }
+    return Store::make(then_store->buffer_var, Select::make(op->condition, then_value, else_value), then_store->index,
+                       then_store->predicate);
+  }
+
+  std::unordered_set<const Variable *> vectorized_vars_;
+  // the innermost vectorized loop var is the lane of the guarded loads
+  std::vector<Var> lanes_;
+};
+}  // namespace
+
+Stmt SelectVectorizedBranch(const Stmt &stmt) { return VectorizedBranchSelector().Mutate(stmt); }
 }  // namespace ir
 }  // namespace akg
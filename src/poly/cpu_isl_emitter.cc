@@ -60,6 +60,12 @@ Stmt CpuIslEmitter::EmitInfo(const Stmt &stmt) {
     }
   }
 
+  auto op_template = info_.analysis_result_.GetOpTemplate();
+  if (op_template == Template::PURE_ELEM || op_template == Template::BROADCAST_OP ||
+      op_template == Template::TRANSPOSE_OP) {
+    result = AttrStmt::make(Expr("INFO"), AKG_STREAM_OP, Expr(info_.analysis_result_.ShowOpTemplate()), result);
+  }
+
   return result;
 }
 
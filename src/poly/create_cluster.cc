@@ -19,6 +19,8 @@
 #include "poly/scop.h"
 #include "poly/dma_inject.h"
 #include "poly/poly_util.h"
+#include <functional>
+#include <numeric>
 #include <vector>
 
 namespace akg {
@@ -629,11 +631,47 @@ bool CpuCreateCluster::CheckPromotion(const isl::schedule_node &current_node, co
                                       const TensorFootprintCluster &cluster,
                                       const std::pair<isl::id, PromotedTensorType> &tensor_info) {
   auto template_type = scop_info_.analysis_result_.GetOuterBandNode(band_index_)->template_type;
-  bool need_promotion =
-    template_type == Template::MATMUL || template_type == Template::CONV || template_type == Template::TRANSPOSE_OP;
+  if (template_type == Template::BROADCAST_OP || template_type == Template::PARTIAL_ELEM) {
+    return tensor_info.second == PromotedTensorType::CUSTOM || IsReusedInBand(current_node, cluster);
+  }
+  bool need_promotion = template_type == Template::MATMUL || template_type == Template::CONV ||
+                        template_type == Template::TRANSPOSE_OP || template_type == Template::REDUCTION;
   return need_promotion;
 }
 
+// A read-only tensor is worth a local copy only when its footprint is smaller than the tile that is written below the
+// node, i.e. each of its elements is reused across the inner band.
+bool CpuCreateCluster::IsReusedInBand(const isl::schedule_node &current_node, const TensorFootprintCluster &cluster) {
+  if (!cluster.foot_print_.box.is_valid()) {
+    return false;
+  }
+  auto GetVolume = [](const std::vector<size_t> &sizes) -> size_t {
+    return std::accumulate(sizes.begin(), sizes.end(), static_cast<size_t>(1), std::multiplies<size_t>());
+  };
+  auto box_sizes = cluster.GetFixedBoxSizes();
+  if (box_sizes.empty()) {
+    return false;
+  }
+
+  isl::union_map reads = scop_info_.analysis_result_.GetReads();
+  isl::union_map writes = scop_info_.analysis_result_.GetWrites();
+  isl::union_map copyin = scop_info_.analysis_result_.GetCopyin();
+  isl::union_map fake_copyin = scop_info_.analysis_result_.GetFakeCopyin();
+  auto partial_sched = GetPartialSchedule(current_node);
+  size_t write_volume = 0;
+  for (const auto &item : scop_info_.StmtWriteMap()) {
+    for (const auto &write_id : item.second) {
+      auto write_cluster = TensorFootprintCluster::HoistBufferFootprintCluster(partial_sched, write_id, reads, copyin,
+                                                                               writes, fake_copyin);
+      if (write_cluster == nullptr || !write_cluster->foot_print_.box.is_valid()) {
+        continue;
+      }
+      write_volume = std::max(write_volume, GetVolume(write_cluster->GetFixedBoxSizes()));
+    }
+  }
+  return GetVolume(box_sizes) < write_volume;
+}
+
 void CpuCreateCluster::CreateClusterListForGemm(const isl::schedule_node &node,
                                                 const std::unordered_set<std::string> &mark_names) {
   auto configed_tensors = scop_info_.user_config_.GetRegisterTensors();
@@ -687,6 +725,50 @@ void CpuCreateCluster::CreateClusterListForTranspose(const isl::schedule_node &n
     RecordPromotedTensorInfo(node, mark_name, all_tensors_);
   }
 }
+
+void CpuCreateCluster::CreateClusterListForReduce(const isl::schedule_node &node,
+                                                  const std::unordered_set<std::string> &mark_names) {
+  auto configed_tensors = scop_info_.user_config_.GetRegisterTensors();
+  // Initialize the promoted types of all tensors.
+  RecordInitPromotedTensorType(configed_tensors);
+
+  // Only the reduce results are accumulated locally, the inputs are streamed once anyway.
+  std::unordered_set<std::string> reduce_tensors;
+  for (const auto &item : scop_info_.analysis_result_.GetReduceTensorInfoMap()) {
+    reduce_tensors.emplace(item.second.write_tensor_name);
+  }
+  for (auto &tensor : all_tensors_) {
+    if (reduce_tensors.count(tensor.first.get_name()) != 0) {
+      tensor.second = PromotedTensorType::SPECIAL;
+    } else if (tensor.second != PromotedTensorType::CUSTOM) {
+      tensor.second = PromotedTensorType::NONE;
+    }
+  }
+
+  for (auto mark_name : mark_names) {
+    RecordPromotedTensorInfo(node, mark_name, all_tensors_);
+  }
+}
+
+void CpuCreateCluster::CreateClusterListForBroadcast(const isl::schedule_node &node,
+                                                     const std::unordered_set<std::string> &mark_names) {
+  auto configed_tensors = scop_info_.user_config_.GetRegisterTensors();
+  // Initialize the promoted types of all tensors.
+  RecordInitPromotedTensorType(configed_tensors);
+
+  // Remove write tensors from promoted tensors, only the reused operands are hoisted.
+  for (const auto &item : scop_info_.StmtWriteMap()) {
+    for (const auto &item_id : item.second) {
+      if (all_tensors_.count(item_id) != 0) {
+        all_tensors_[item_id] = PromotedTensorType::NONE;
+      }
+    }
+  }
+
+  for (auto mark_name : mark_names) {
+    RecordPromotedTensorInfo(node, mark_name, all_tensors_);
+  }
+}
 }  // namespace poly
 }  // namespace ir
 }  // namespace akg
\ No newline at end of file
@@ -131,8 +131,12 @@ class CpuCreateCluster : public CreateCluster {
   void CreateClusterListForGemm(const isl::schedule_node &orig_node, const std::unordered_set<std::string> &mark_names);
   void CreateClusterListForConv(const isl::schedule_node &node, const std::unordered_set<std::string> &mark_names);
   void CreateClusterListForTranspose(const isl::schedule_node &node, const std::unordered_set<std::string> &mark_names);
+  void CreateClusterListForReduce(const isl::schedule_node &node, const std::unordered_set<std::string> &mark_names);
+  void CreateClusterListForBroadcast(const isl::schedule_node &node, const std::unordered_set<std::string> &mark_names);
 
  private:
+  bool IsReusedInBand(const isl::schedule_node &current_node, const TensorFootprintCluster &cluster);
+
   // Common functions required by shared, register in gpu and cpu.
   isl::union_map GetPartialSchedule(const isl::schedule_node &node) override;
   BufferDefInfo GetPromotedInfo(const isl::id &promoted_id, const std::string &mark_name) override;
@@ -40,6 +40,8 @@ Stmt GpuIslEmitter::EmitSync() {
   return Evaluate::make(Call::make(Int(32), STORAGE_SYNC, {StringImm::make(SYNC_SCOP_SHARED)}, Call::Intrinsic));
 }
 
+Stmt GpuIslEmitter::EmitWarpSync() { return Evaluate::make(Call::make(Int(32), WARP_SYNC_CALL, {}, Call::Extern)); }
+
 Stmt GpuIslEmitter::EmitStmt(const isl::ast_node_user &node) {
   CHECK(node.get_expr().isa<isl::ast_expr_op>());
   isl::ast_expr_op usr_expr = node.get_expr().as<isl::ast_expr_op>();
@@ -63,6 +65,8 @@ Stmt GpuIslEmitter::EmitStmt(const isl::ast_node_user &node) {
     return EmitWrite(node);
   } else if (info_.IsSync(stmt_id)) {
     return EmitSync();
+  } else if (info_.IsWarpSync(stmt_id)) {
+    return EmitWarpSync();
   } else {
     Stmt stmt = EmitUserStmt(node);
     auto tot = info_.analysis_result_.GetTensorOfTensorStmt();
@@ -40,6 +40,8 @@ constexpr auto REDUCE_ATOMIC_FLAG_TYPE_POS = 1;
 constexpr auto REDUCE_LIB_TYPE_FLAG = "reduceLibType";
 constexpr auto REDUCE_INIT_FLAG = "InitStmt";
 
+constexpr auto WARP_SYNC_CALL = "__syncwarp";
+
 class GpuIslEmitter : public IslEmitter {
  public:
   GpuIslEmitter(ScopInfo &info, const NodeInfoRepo &n, const isl::id_list &i) : IslEmitter(info, n, i) {}
@@ -74,6 +76,7 @@ class GpuIslEmitter : public IslEmitter {
   Stmt EmitAccessNodeFromPromoteAcsProvide(isl::id var, const Node *node, Array<Expr> &args);
 
   Stmt EmitSync();
+  Stmt EmitWarpSync();
   Stmt EmitAttr();  // thread_extent, virtual_thread
 
   Expr FindRealizeScope(const isl::id &var);
@@ -523,6 +523,7 @@ constexpr auto SSE_INSTRUCTION_SET = "sse";
 constexpr auto AVX_INSTRUCTION_SET = "avx";
 constexpr auto AVX2_INSTRUCTION_SET = "avx2";
 constexpr auto AVX512_INSTRUCTION_SET = "avx512";
+constexpr auto AVX512VNNI_INSTRUCTION_SET = "avx512vnni";
 constexpr auto NEON_INSTRUCTION_SET = "neon";
 
 const std::unordered_set<std::string> AkgSupportedReduceOp = {AKG_REDUCE_SUM, AKG_REDUCE_MIN, AKG_REDUCE_MAX,
@@ -554,14 +555,16 @@ const std::unordered_map<std::string, int> CpuInstructionSetBits = {{NEON_INSTRU
                                                                     {SSE_INSTRUCTION_SET, VECTORIZED_128_BIT},
                                                                     {AVX_INSTRUCTION_SET, VECTORIZED_256_BIT},
                                                                     {AVX2_INSTRUCTION_SET, VECTORIZED_256_BIT},
-                                                                    {AVX512_INSTRUCTION_SET, VECTORIZED_512_BIT}};
+                                                                    {AVX512_INSTRUCTION_SET, VECTORIZED_512_BIT},
+                                                                    {AVX512VNNI_INSTRUCTION_SET, VECTORIZED_512_BIT}};
 
 static std::unordered_map<std::string, std::vector<int>> CpuPackABBlockSize = {
   {NEON_INSTRUCTION_SET, {BLOCK_SIZE_4, BLOCK_SIZE_12}},
   {SSE_INSTRUCTION_SET, {BLOCK_SIZE_4, BLOCK_SIZE_12}},
   {AVX_INSTRUCTION_SET, {BLOCK_SIZE_4, BLOCK_SIZE_24}},
   {AVX2_INSTRUCTION_SET, {BLOCK_SIZE_4, BLOCK_SIZE_24}},
-  {AVX512_INSTRUCTION_SET, {BLOCK_SIZE_4, BLOCK_SIZE_48}}};
+  {AVX512_INSTRUCTION_SET, {BLOCK_SIZE_4, BLOCK_SIZE_48}},
+  {AVX512VNNI_INSTRUCTION_SET, {BLOCK_SIZE_4, BLOCK_SIZE_48}}};
 
 constexpr auto DEC = 10;
 
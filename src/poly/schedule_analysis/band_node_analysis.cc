@@ -630,7 +630,7 @@ class OperatorInfoCollector {
     }
     auto it = CpuPackABBlockSize.find(feature);
     CHECK(it != CpuPackABBlockSize.end())
-      << "The instruction set supported by the cpu only includes sse, avx, avx2, avx512 and neon.";
+      << "The instruction set supported by the cpu only includes sse, avx, avx2, avx512, avx512vnni and neon.";
 
     PackBlockSize pack_block_size;
     pack_block_size.pack_a_size = it->second[0];
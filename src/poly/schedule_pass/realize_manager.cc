@@ -199,7 +199,7 @@ isl::schedule RealizeManager::InsertPromotionMajor(const isl::schedule &sch) {
 
 isl::schedule RealizeManager::Run(isl::schedule sch) {
   if (scop_info_.user_config_.GetTarget() == TARGET_CUDA) {
-    sch = scop_info_.sync_manager_.InsertPromotionSync(sch);
+    sch = scop_info_.sync_manager_.InsertPromotionSync(sch, scop_info_);
   } else if (scop_info_.user_config_.GetTarget() == TARGET_CPU) {
     sch = InsertPromotionMajor(sch);
   }
@@ -1597,6 +1597,15 @@ isl::schedule_node TileOuterBand::TileElementWiseForCpu(const isl::schedule_node
 
   node = InsertMarkerForReduceY(node, start_depth);
   node = node.ancestor(node.get_tree_depth() - start_depth);
+
+  // with enable_cpu_local_promotion, the operands reused across the inner band are copied into a local buffer once
+  // per tile
+  auto current_outer_bn = scop_info_.analysis_result_.GetOuterBandNode(cur_band_index_);
+  if (scop_info_.user_config_.GetEnableCpuLocalPromotion() && current_outer_bn->use_register_memory &&
+      (current_outer_bn->template_type == Template::BROADCAST_OP ||
+       current_outer_bn->template_type == Template::PARTIAL_ELEM)) {
+    node = InsertPromotionMarkerForCpu(node, PROMOTE_GLOBAL_TO_REGISTER_AB);
+  }
   return node;
 }
 
@@ -1612,6 +1621,13 @@ isl::schedule_node TileOuterBand::TileReduceXForCpu(const isl::schedule_node &or
   node = TileAccordingToTileType(node, TileType::C0);
   node = node.child(0);
 
+  // with enable_cpu_local_promotion, the result of a row stays local across all the tiles of the reduce axis and is
+  // written back once. It is a single scalar per row, not one partial per vector lane.
+  if (scop_info_.user_config_.GetEnableCpuLocalPromotion() &&
+      scop_info_.analysis_result_.GetOuterBandNode(cur_band_index_)->use_register_memory) {
+    node = node.insert_mark(PROMOTE_GLOBAL_TO_REGISTER_C).child(0);
+  }
+
   // tile reduce axis
   start_pos_ = static_cast<int>(band_node.n_member() - 1);
   node = TileAccordingToTileType(node, TileType::LASTC1);
@@ -1652,6 +1668,33 @@ std::vector<int> TileOuterBand::GetTileSizeForCpu(const isl::schedule_node &orig
   return tile_size;
 }
 
+/*
+ * A tile larger than its axis is never full, and a band with no full tile on one axis isolates nothing, leaving
+ * min/max-guarded loops on every axis. Shrink such tiles to the axis, so the isolated part keeps constant trip counts
+ * for vectorization and unrolling, and only the remainder tiles are generated separately.
+ */
+void TileOuterBand::ClampTileSizeToExtent(const isl::schedule_node &orig_node, std::vector<int> &tile_size) {
+  if (!orig_node.isa<isl::schedule_node_band>() || scop_info_.user_config_.GetIsDynamic() ||
+      scop_info_.analysis_result_.GetCsr()) {
+    return;
+  }
+  auto partial_schedule = orig_node.as<isl::schedule_node_band>().get_partial_schedule();
+  auto upa_list = partial_schedule.intersect_domain(orig_node.get_domain()).get_union_pw_aff_list();
+  int n_member = std::min(static_cast<int>(upa_list.size()), static_cast<int>(tile_size.size()));
+  for (int i = 0; i < n_member; ++i) {
+    auto upa = upa_list.get_at(i).floor();
+    auto min_val = upa.min_val();
+    auto max_val = upa.max_val();
+    if (!min_val.is_int() || !max_val.is_int() || min_val.get_num_si() != 0) {
+      continue;
+    }
+    int64_t extent = max_val.get_num_si() + 1;
+    if (tile_size[i] > extent) {
+      tile_size[i] = static_cast<int>(extent);
+    }
+  }
+}
+
 isl::schedule_node TileOuterBand::TileAccordingToTileType(const isl::schedule_node &orig_node,
                                                           const TileType tile_level,
                                                           const std::vector<int> &tile_size) {
@@ -1661,6 +1704,7 @@ isl::schedule_node TileOuterBand::TileAccordingToTileType(const isl::schedule_no
   } else {
     cur_tile_size = GetTileSizeForCpu(orig_node, tile_level);
   }
+  ClampTileSizeToExtent(orig_node, cur_tile_size);
 
   isl::multi_val mutial_val_tile_size = ComputeBandTilesSizes(orig_node, &cur_tile_size[0]);
   int all_tile_size = static_cast<int>(tile_sizes_.size());
@@ -1700,6 +1744,31 @@ isl::schedule_node TileOuterBand::InsertAllMarker(const isl::schedule_node &orig
   return node;
 }
 
+// Insert the marker above the innermost band that still runs outside the unrolled and vectorized loops, so that the
+// promoted footprint covers one c0 tile.
+isl::schedule_node TileOuterBand::InsertPromotionMarkerForCpu(const isl::schedule_node &orig_node,
+                                                              const std::string &marker_name) {
+  auto IsInnerMarker = [](const isl::schedule_node &node) -> bool {
+    if (!node.isa<isl::schedule_node_mark>()) {
+      return false;
+    }
+    std::string name = node.as<isl::schedule_node_mark>().get_id().get_name();
+    return name == FOR_UNROLLED || name == FOR_VECTORIZED;
+  };
+  auto InsertMarker = [&IsInnerMarker, &marker_name](isl::schedule_node node) -> isl::schedule_node {
+    if (!node.isa<isl::schedule_node_band>() || !node.has_children() || !IsInnerMarker(node.child(0))) {
+      return node;
+    }
+    for (auto ancestor = node; ancestor.has_parent(); ancestor = ancestor.parent()) {
+      if (IsInnerMarker(ancestor)) {
+        return node;
+      }
+    }
+    return node.insert_mark(marker_name);
+  };
+  return orig_node.map_descendant_bottom_up(InsertMarker);
+}
+
 isl::schedule_node TileOuterBand::InsertMultiMarker(const isl::schedule_node &orig_node, const std::string &marker_name,
                                                     const bool return_orig_pos, const int insert_marker_num) {
   // Insert corresponding markers for all axes with shape greater than 1 in the current band node.
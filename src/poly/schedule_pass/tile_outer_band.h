@@ -105,6 +105,7 @@ class TileOuterBand : public SchedulePass {
                                              const std::vector<int> &tile_size = {});
   std::vector<int> GetTileSizeForCpu(const isl::schedule_node &orig_node,
                                      const TileType tile_level = TileType::Invalid);
+  void ClampTileSizeToExtent(const isl::schedule_node &orig_node, std::vector<int> &tile_size);
 
   isl::schedule_node TileCsrForCpu(const isl::schedule_node &orig_node);
   isl::schedule_node TileReduceXForCpu(const isl::schedule_node &orig_node);
@@ -117,6 +118,7 @@ class TileOuterBand : public SchedulePass {
   bool IsContainReduceStatement(const isl::schedule_node &orig_node);
   isl::schedule_node SplitReduceStatements(const isl::schedule_node &orig_node);
   isl::schedule_node InsertAllMarker(const isl::schedule_node &orig_node, const bool is_all_reduce);
+  isl::schedule_node InsertPromotionMarkerForCpu(const isl::schedule_node &orig_node, const std::string &marker_name);
   isl::schedule_node InsertMultiMarker(const isl::schedule_node &orig_node, const std::string &marker_name,
                                        const bool return_orig_pos = false, const int insert_marker_num = -1);
   isl::schedule_node InsertMarkerForReduceY(const isl::schedule_node &orig_node, size_t start_depth);
@@ -109,6 +109,17 @@ void CpuMemoryManager::CreateClusterForOperator(const isl::schedule_node &orig_n
     // transpose operator
     mark_names_.emplace(PROMOTE_TRANSPOSE);
     create_cluster.CreateClusterListForTranspose(orig_node, mark_names_);
+  } else if (!scop_info_.user_config_.GetEnableCpuLocalPromotion()) {
+    return;
+  } else if (current_outer_bn_->template_type == Template::REDUCTION) {
+    // reduce operator
+    mark_names_.emplace(PROMOTE_GLOBAL_TO_REGISTER_C);
+    create_cluster.CreateClusterListForReduce(orig_node, mark_names_);
+  } else if (current_outer_bn_->template_type == Template::BROADCAST_OP ||
+             current_outer_bn_->template_type == Template::PARTIAL_ELEM) {
+    // broadcast operator
+    mark_names_.emplace(PROMOTE_GLOBAL_TO_REGISTER_AB);
+    create_cluster.CreateClusterListForBroadcast(orig_node, mark_names_);
   }
 }
 
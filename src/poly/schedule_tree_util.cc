@@ -918,7 +918,7 @@ int GetVectorizationTileSize(ScopInfo &scop_info) {
       }
       auto it = CpuInstructionSetBits.find(feature);
       CHECK(it != CpuInstructionSetBits.end())
-        << "The instruction set supported by the cpu only includes sse, avx, avx2, avx512 and neon.";
+        << "The instruction set supported by the cpu only includes sse, avx, avx2, avx512, avx512vnni and neon.";
 
       vectorized_length = it->second;
     } else {
@@ -822,9 +822,13 @@ bool UserConfig::IsSymbolicTiling(const Stmt &stmt) {
     } else if (!g_attrs.GetBool("enable_symbolic_tiling", 1)) {
       LOG(DEBUG) << "Symbolic tiling disabled: unsupported kernel";
       is_symbolic_tiling_ = false;
-    } else if (GetTarget() != TARGET_CCE) {
-      LOG(DEBUG) << "Symbolic tiling disabled: does not support CPU or GPU yet";
+    } else if (GetTarget() == TARGET_CUDA) {
+      LOG(DEBUG) << "Symbolic tiling disabled: does not support GPU yet";
       is_symbolic_tiling_ = false;
+    } else if (GetTarget() == TARGET_CPU) {
+      // The cpu cache model is opt-in and tiles every band, without the vector IR survey.
+      is_symbolic_tiling_ = !str_ret.empty();
+      is_force_symbolic_tiling_ = is_symbolic_tiling_;
     } else {
       is_force_symbolic_tiling_ = (akg::common::GetIntegerEnv("FORCE_SYMBOLIC_TILING") != 0);
       if (!is_force_symbolic_tiling_) {
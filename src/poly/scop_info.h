@@ -288,6 +288,7 @@ class UserConfig {
   bool GetPragmaAnalyzeMulticore() const { return pragma_analyze_multicore_; }
   int GetEnableMulticore() const { return enable_multicore_; }
   int GetPruneTuningSpaceLevel() const { return prune_tuning_space_level_; }
+  int GetTuningSpaceThreads() const { return tuning_space_threads_; }
   bool GetTileCheckCoincident() const { return tile_check_coincident_; }
   void SetTileCheckCoincident(const bool tile_check_coincident) { tile_check_coincident_ = tile_check_coincident; }
   int GetMaxUnrollLoop() const { return max_unroll_loop_; }
@@ -475,6 +476,7 @@ class UserConfig {
 
   bool GetEnableOneDimThread() { return enable_one_dim_thread_; }
   void SetEnableOneDimThread(bool enable_one_dim_thread) { enable_one_dim_thread_ = enable_one_dim_thread; }
+  bool GetEnableSyncElimination() const { return enable_sync_elimination_; }
 
   void RecordMappingStrategy(MappingStrategyFilterMap &mapping_strategy_map, const int axis_pos,
                              const std::string &mapping_idx, const int filter_pos = 0, const int offset = 0);
@@ -497,6 +499,7 @@ class UserConfig {
 
   bool GetEnableTranspose() { return enable_transpose_; }
   void SetEnableTranspose(bool enable_transpose) { enable_transpose_ = enable_transpose; }
+  bool GetEnableSquareTranspose() const { return enable_square_transpose_; }
 
   bool GetUseRegisterMemory() const { return use_register_memory_; }
   bool GetUseSharedMemory() const { return use_shared_memory_; }
@@ -530,6 +533,7 @@ class UserConfig {
   std::string GetGemmKernelMNK() { return gemm_kernel_mnk_; }
   void SetGemmKernelMNK(std::string gemm_kernel_mnk) { gemm_kernel_mnk_ = gemm_kernel_mnk; }
   bool NeedPackMatrixB() { return pack_matrix_b_; }
+  bool GetEnableCpuLocalPromotion() const { return enable_cpu_local_promotion_; }
 
  private:
   void SetAttrsCommon(const Map<std::string, NodeRef> &attrs) {
@@ -574,6 +578,7 @@ class UserConfig {
     ParseBoolAttr(attrs, "pragma_allow_tail_tiling", &pragma_allow_tail_tiling_);
     ParseBoolAttr(attrs, "pragma_analyze_multicore", &pragma_analyze_multicore_);
     ParseIntAttr(attrs, "prune_tuning_space_level", &prune_tuning_space_level_);
+    ParseIntAttr(attrs, "tuning_space_threads", &tuning_space_threads_);
     ParseBoolAttr(attrs, "pragma_checkcoincident", &tile_check_coincident_);
     ParseIntAttr(attrs, "max_unroll_loop", &max_unroll_loop_);
     ParseBoolAttr(attrs, "unroll_shared", &unroll_shared_);
@@ -639,6 +644,7 @@ class UserConfig {
     ParseBoolAttr(attrs, "use_shared_memory", &use_shared_memory_);
     ParseBoolAttr(attrs, "enable_bank_conflict_opt", &enable_bank_conflict_);
     ParseBoolAttr(attrs, "enable_one_dim_thread", &enable_one_dim_thread_);
+    ParseBoolAttr(attrs, "enable_sync_elimination", &enable_sync_elimination_);
     ParseBoolAttr(attrs, "shared_inversed_thread_map", &shared_inversed_thread_map_);
     ParseBoolAttr(attrs, "enable_stitch_fusion", &enable_stitch_fusion_);
     ParseIntAttr(attrs, "shared_vector_align", &shared_vector_align_);
@@ -653,7 +659,9 @@ class UserConfig {
     ParseBoolAttr(attrs, "pragma_enable_conv2d_direct", &enable_conv2d_direct_);
     ParseStringAttr(attrs, "gemm_kernel_mnk", &gemm_kernel_mnk_);
     ParseBoolAttr(attrs, "pragma_enable_transpose", &enable_transpose_);
+    ParseBoolAttr(attrs, "enable_square_transpose", &enable_square_transpose_);
     ParseBoolAttr(attrs, "pack_matrix_b", &pack_matrix_b_);
+    ParseBoolAttr(attrs, "enable_cpu_local_promotion", &enable_cpu_local_promotion_);
   }
 
   // tools for parsing user config
@@ -784,9 +792,13 @@ class UserConfig {
   // vectorization
   int vector_length_{0};
   bool enable_one_dim_thread_{false};
+  // remove or downgrade the promotion synchronizations that guard no dependence between threads
+  bool enable_sync_elimination_{true};
   bool enable_vectorization_{true};
 
   bool enable_transpose_{true};
+  // square transpose tiles take the register transpose micro-kernels of the llvm codegen
+  bool enable_square_transpose_{true};
 
   // tiling config
   std::string b_dim_;
@@ -805,6 +817,7 @@ class UserConfig {
   bool pragma_analyze_multicore_{true};
   int enable_multicore_{-1};
   int prune_tuning_space_level_{0};  // 0: no_prune; 1: prune mem-exceed; 2: prune aligned_mem-exceed
+  int tuning_space_threads_{1};      // 0: all hardware threads
   bool tile_check_coincident_{true};
   int max_unroll_loop_{1};
   bool unroll_shared_{false};
@@ -893,6 +906,8 @@ class UserConfig {
   std::string feature_{SSE_INSTRUCTION_SET};
   std::string gemm_kernel_mnk_;
   bool pack_matrix_b_{true};
+  // copy reduce results and reused broadcast operands into local buffers
+  bool enable_cpu_local_promotion_{false};
 
   // csr config
   int csr_thread_num_{128};
@@ -1659,6 +1674,7 @@ class ScopInfo {
   static bool IsGMWrite(const isl::id &id) { return id.get_name() == std::string("GMwrite"); }
   static bool IsGMRead(const isl::id &id) { return id.get_name() == std::string("GMread"); }
   static bool IsSync(const isl::id &id) { return IsStartsWith(id.name(), SYNC_FLAG); }
+  static bool IsWarpSync(const isl::id &id) { return IsStartsWith(id.name(), WARP_SYNC_PREFIX); }
   static bool IsRealize(const isl::id &id) { return IsStartsWith(id.get_name(), "REALIZE"); }
   static bool IsCall(const isl::id &id) { return IsStartsWith(id.get_name(), "Call"); }
   static bool IsReduceInit(const isl::id &id) { return IsStartsWith(id.get_name(), "red_init"); }
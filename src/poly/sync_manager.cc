@@ -87,8 +87,124 @@ std::string SyncManager::GetCurrentFilterName(const isl::schedule_node orig_node
   return cur_filter_name;
 }
 
-isl::schedule SyncManager::InsertPromotionSync(const isl::schedule &sch) {
-  auto InsertSyncForSequence = [this](isl::schedule_node node) -> isl::schedule_node {
+bool SyncManager::InitThreadSpace(ScopInfo &scop_info) {
+  auto thread_cfg = scop_info.user_config_.GetThreadConfig();
+  if (thread_cfg == nullptr || thread_cfg->bound == 0) {
+    return false;
+  }
+
+  // threads are numbered with the first dimension varying fastest, as threadIdx.x
+  std::string params, src, dst, bounds, equal, src_linear, dst_linear;
+  for (size_t i = 0; i < thread_cfg->bound; ++i) {
+    auto cfg = thread_cfg->GetAt(i);
+    if (cfg.second <= 0) {
+      return false;
+    }
+    auto sep = i == 0 ? "" : ", ";
+    auto and_sep = i == 0 ? "" : " and ";
+    auto x = "x" + std::to_string(i);
+    auto y = "y" + std::to_string(i);
+    params += sep + cfg.first;
+    src += sep + x;
+    dst += sep + y;
+    bounds += and_sep + x + " = " + cfg.first + " and 0 <= " + x + " < " + std::to_string(cfg.second);
+    equal += and_sep + y + " = " + x;
+  }
+  for (int i = static_cast<int>(thread_cfg->bound) - 1; i >= 0; --i) {
+    auto size = std::to_string(thread_cfg->GetAt(i).second);
+    auto x = "x" + std::to_string(i);
+    auto y = "y" + std::to_string(i);
+    src_linear = src_linear.empty() ? x : "(" + src_linear + ") * " + size + " + " + x;
+    dst_linear = dst_linear.empty() ? y : "(" + dst_linear + ") * " + size + " + " + y;
+  }
+
+  std::string thread = std::string(THREAD_TUPLE);
+  thread_space_.threads = isl::union_set(ctx_, "[" + params + "] -> { " + thread + "[" + src + "] : " + bounds + " }");
+  thread_space_.same_thread =
+    isl::union_map(ctx_, "{ " + thread + "[" + src + "] -> " + thread + "[" + dst + "] : " + equal + " }");
+  thread_space_.same_warp =
+    isl::union_map(ctx_, "{ " + thread + "[" + src + "] -> " + thread + "[" + dst + "] : floor((" + src_linear + ") / " +
+                           std::to_string(WARP_SIZE) + ") = floor((" + dst_linear + ") / " + std::to_string(WARP_SIZE) +
+                           ") }");
+  return true;
+}
+
+ThreadAccess SyncManager::GetThreadAccess(const isl::schedule_node &node, ScopInfo &scop_info) {
+  isl::union_set domain = isl::union_set::empty(ctx_);
+  node.foreach_descendant_top_down([&domain](const isl::schedule_node &sub_node) -> bool {
+    if (sub_node.isa<isl::schedule_node_leaf>()) {
+      domain = domain.unite(sub_node.get_domain());
+    }
+    return true;
+  });
+
+  auto reads = scop_info.analysis_result_.GetReads().domain_factor_domain();
+  auto writes = scop_info.analysis_result_.GetWrites().domain_factor_domain();
+  auto reduce_stmts = scop_info.analysis_result_.GetReduceTensorInfoMap();
+  isl::union_set read_elements = isl::union_set::empty(ctx_);
+  isl::union_set write_elements = isl::union_set::empty(ctx_);
+  ThreadAccess access;
+  domain.foreach_set([&](const isl::set &s) -> void {
+    if (s.is_wrapping()) {
+      // A promotion copy [[prefix -> tensor[origin]] -> buffer[local]], regarded as a write of the element of the
+      // original tensor, so that it conflicts with any other access to it.
+      auto copy = s.unwrap().domain();
+      if (!copy.is_wrapping()) {
+        access.unknown = true;
+        return;
+      }
+      write_elements = write_elements.unite(isl::union_set(copy.unwrap().range()));
+      return;
+    }
+    auto name = s.get_tuple_name();
+    if (IsStartsWith(name, SYNC_PREFIX) || IsStartsWith(name, WARP_SYNC_PREFIX)) {
+      return;
+    }
+    // The reduction of the akg reduce library exchanges data between threads, which the accesses do not show.
+    auto stmt = isl::union_set(s);
+    if (reduce_stmts.count(s.get_tuple_id()) > 0 || writes.intersect_domain(stmt.universe()).is_empty()) {
+      access.unknown = true;
+      return;
+    }
+    read_elements = read_elements.unite(stmt.apply(reads));
+    write_elements = write_elements.unite(stmt.apply(writes));
+  });
+
+  // The elements depend on the thread ids through the parameters of the mapping filters. Bind the parameters to the
+  // thread tuple, then drop every parameter, which only enlarges the elements accessed by each thread.
+  access.reads =
+    isl::union_map::from_domain_and_range(thread_space_.threads, read_elements).project_out_all_params();
+  access.writes =
+    isl::union_map::from_domain_and_range(thread_space_.threads, write_elements).project_out_all_params();
+  return access;
+}
+
+SyncLevel SyncManager::GetSyncLevel(const ThreadAccess &before, const ThreadAccess &after) {
+  if (before.unknown || after.unknown) {
+    return SyncLevel::BLOCK;
+  }
+  // pairs of threads accessing the same element, one of them writing it
+  auto conflict = before.writes.apply_range(after.writes.reverse())
+                    .unite(before.writes.apply_range(after.reads.reverse()))
+                    .unite(before.reads.apply_range(after.writes.reverse()));
+  if (conflict.is_subset(thread_space_.same_thread)) {
+    return SyncLevel::EMPTY;
+  }
+  if (conflict.is_subset(thread_space_.same_warp)) {
+    return SyncLevel::WARP;
+  }
+  return SyncLevel::BLOCK;
+}
+
+isl::schedule SyncManager::InsertPromotionSync(const isl::schedule &sch, ScopInfo &scop_info) {
+  // The tensor core statements are executed by whole warps, their accesses are not those of a single thread.
+  bool eliminate = scop_info.user_config_.GetEnableSyncElimination() && !scop_info.user_config_.GetEnableMatmul() &&
+                   InitThreadSpace(scop_info);
+  int num_sync = 0;
+  int num_removed = 0;
+  int num_warp = 0;
+  auto InsertSyncForSequence = [this, &scop_info, eliminate, &num_sync, &num_removed,
+                                &num_warp](isl::schedule_node node) -> isl::schedule_node {
     if (!node.isa<isl::schedule_node_sequence>()) {
       return node;
     }
@@ -119,6 +235,7 @@ isl::schedule SyncManager::InsertPromotionSync(const isl::schedule &sch) {
 
     std::string cur_filter_name = "";
     std::string next_filter_name = "";
+    std::vector<int> sync_pos;
     for (int i = node.n_children() - 1; i >= 0; --i) {
       auto filter_node = node.child(i).as<isl::schedule_node_filter>();
       cur_filter_name = GetCurrentFilterName(filter_node);
@@ -156,16 +273,54 @@ isl::schedule SyncManager::InsertPromotionSync(const isl::schedule &sch) {
       if (IsRepeatSync(filter_node)) {
         continue;
       }
+      sync_pos.push_back(i);
+    }
+
+    // A synchronization after the child i orders the children up to i before the children after i. The one after the
+    // last child orders all children before those of the next iteration of the enclosing loops.
+    int n_children = static_cast<int>(node.n_children());
+    std::vector<ThreadAccess> accesses;
+    for (int i = 0; eliminate && i < n_children; ++i) {
+      accesses.emplace_back(GetThreadAccess(node.child(i), scop_info));
+    }
+    for (auto i : sync_pos) {
+      ++num_sync;
+      auto level = SyncLevel::BLOCK;
+      if (eliminate) {
+        ThreadAccess before = accesses[0];
+        for (int j = 1; j <= i; ++j) {
+          before.Unite(accesses[j]);
+        }
+        ThreadAccess after = i + 1 < n_children ? accesses[i + 1] : before;
+        for (int j = i + 2; j < n_children; ++j) {
+          after.Unite(accesses[j]);
+        }
+        level = GetSyncLevel(before, after);
+      }
+      if (level == SyncLevel::EMPTY) {
+        ++num_removed;
+        continue;
+      }
 
       // Insert sync after the filter node
-      auto band_node = filter_node.child(0);
-      auto sync_id = MakeUniqueId(SyncLevel::BLOCK);
+      auto band_node = node.child(i).child(0);
+      isl::id sync_id;
+      if (level == SyncLevel::WARP) {
+        sync_id = GetWarpSyncId();
+        ++num_warp;
+      } else {
+        sync_id = MakeUniqueId(SyncLevel::BLOCK);
+      }
       node = InsertExtensionNodeBeforeOrAfter(band_node, sync_id, false);
       node = node.ancestor(2);
     }
     return node;
   };
   auto final_sch = sch.get_root().map_descendant_bottom_up(InsertSyncForSequence).get_schedule();
+  if (eliminate && num_sync > 0) {
+    LOG(INFO) << "Kernel " << scop_info.user_config_.GetKernelName() << ": " << num_removed << " of " << num_sync
+              << " promotion synchronizations removed, " << num_warp << " downgraded to warp level.";
+  }
   return final_sch;
 }
 
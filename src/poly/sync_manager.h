@@ -37,6 +37,7 @@ constexpr auto SYNC_WARP = "warp";
 constexpr auto SYNC_BLOCK = "block";
 constexpr auto SYNC_GRID = "grid";
 constexpr auto WARP_SIZE = 32;
+constexpr auto THREAD_TUPLE = "_thread";
 
 struct SyncCandidate;
 
@@ -155,12 +156,35 @@ struct SyncCandidate {
   }
 };
 
+class ScopInfo;
+
+// Shared memory accesses of a group of statements, as relations from a thread to the elements it touches.
+struct ThreadAccess {
+  isl::union_map reads;
+  isl::union_map writes;
+  bool unknown{false};  // contains statements whose accesses cannot be analyzed
+
+  void Unite(const ThreadAccess &other) {
+    reads = reads.unite(other.reads);
+    writes = writes.unite(other.writes);
+    unknown = unknown || other.unknown;
+  }
+};
+
+// The threads of a block, and the relations between two threads that access the same data without a barrier or with
+// a warp barrier only.
+struct ThreadSpace {
+  isl::union_set threads;
+  isl::union_map same_thread;
+  isl::union_map same_warp;
+};
+
 class SyncManager {
  public:
   explicit SyncManager(isl::ctx ctx) : ctx_(ctx) {}
   ~SyncManager() {}
 
-  isl::schedule InsertPromotionSync(const isl::schedule &sch);
+  isl::schedule InsertPromotionSync(const isl::schedule &sch, ScopInfo &scop_info);
   isl::id MakeUniqueId(SyncLevel level);
 
  private:
@@ -172,6 +196,13 @@ class SyncManager {
   bool IsRepeatSync(const isl::schedule_node orig_node);
 
   std::string GetCurrentFilterName(const isl::schedule_node orig_node);
+
+  // Dependence based elimination of the promotion synchronizations.
+  bool InitThreadSpace(ScopInfo &scop_info);
+  ThreadAccess GetThreadAccess(const isl::schedule_node &node, ScopInfo &scop_info);
+  SyncLevel GetSyncLevel(const ThreadAccess &before, const ThreadAccess &after);
+
+  ThreadSpace thread_space_;
 };
 }  // namespace poly
 }  // namespace ir
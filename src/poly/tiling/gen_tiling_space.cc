@@ -15,7 +15,12 @@
  * limitations under the License.
  */
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 #include "poly/scop_info.h"
@@ -28,6 +33,9 @@ namespace poly {
 
 using namespace air;
 
+// number of values of the outermost axis given to each thread at a time
+constexpr auto SCAN_TASKS_PER_THREAD = 4;
+
 class TileSpaceCollector {
  public:
   TileSpaceCollector(TilingAnalyzer &analyzer, const int level)
@@ -61,7 +69,7 @@ class TileSpaceCollector {
     for (size_t i = 0; i < band_size; ++i) {
       result_.emplace_back(std::vector<Result>());
       CollectTileAxisTopDown(i);
-      static_cast<void>(ScanDown(0, i));
+      ScanBand(i);
       LOG(INFO) << "Band = " << i << ", tiling space size: " << result_.back().size();
     }
 
@@ -235,44 +243,209 @@ class TileSpaceCollector {
     }
   }
 
-  bool ScanDown(size_t axis_idx, size_t band_idx) {
+  struct Result {
+    std::vector<int> tile;
+    int64_t mem_size;
+    int64_t align_size;
+    int process;
+  };
+
+  // The tiles enumerated by one task, kept in the order of enumeration.
+  struct Scan {
+    TileCandidate *cand{nullptr};
+    bool record{false};  // record the tiles at once instead of keeping them in found
+    std::vector<Result> found;
+    int visited{0};
+    bool skipped{false};
+    bool ok{true};
+  };
+
+  bool GetTileRange(const TileAxis *axis, int64_t *tile_min, int64_t *tile_extent) {
+    const TileAxis::Constraint &cons = axis->c1_constraints;
+    const auto min_imm = cons.tile_min_.as<IntImm>();
+    const auto mod_imm = cons.tile_mod_.as<IntImm>();
+    const auto extent_imm = cons.tile_extent_.as<IntImm>();
+    if (min_imm == nullptr || mod_imm == nullptr || extent_imm == nullptr) {
+      return false;
+    }
+    *tile_min = min_imm->value;
+    *tile_extent = extent_imm->value;
+    return true;
+  }
+
+  // Sets the tile of the axis, returns false when the tile breaks the constraints of the axis and is pruned.
+  bool SetTile(TileAxis *axis, int64_t tile, size_t band_idx, TileCandidate *cand) {
+    const TileAxis::Constraint &cons = axis->c1_constraints;
+    const auto tile_min = cons.tile_min_.as<IntImm>()->value;
+    const auto tile_mod = cons.tile_mod_.as<IntImm>()->value;
+    const auto tile_extent = cons.tile_extent_.as<IntImm>()->value;
+    bool prune = analyzer_.scop_info_.user_config_.GetPruneTuningSpaceLevel() != 0;
+    bool break_constraint = ((tile != tile_min) && (tile != tile_extent) && (tile % tile_mod != 0)) ||
+                            (axis->forbid_iso && tile_extent % tile != 0);
+    if (prune && break_constraint) {
+      return false;
+    }
+    cand->UpdateConstTile(axis, tile);
+    return !prune || cand->SpaceVerify(axis, CACHE1, band_idx);
+  }
+
+  bool ScanDown(size_t axis_idx, size_t band_idx, Scan *scan) {
     if (axis_idx == tile_axes_.size()) {
-      return AppendCand(band_idx);
+      return AppendCand(band_idx, scan);
     }
     TileAxis *axis = tile_axes_[axis_idx];
-    TileAxis::Constraint &cons = axis->c1_constraints;
-    const auto tile_min = cons.tile_min_.as<IntImm>();
-    const auto tile_mod = cons.tile_mod_.as<IntImm>();
-    const auto tile_extent = cons.tile_extent_.as<IntImm>();
-    if (tile_min && tile_mod && tile_extent) {
-      bool min_tile_ok = false;
-      for (int64_t tile = tile_min->value; tile <= tile_extent->value; ++tile) {
-        bool break_constraint =
-          ((tile != tile_min->value) && (tile != tile_extent->value) && (tile % tile_mod->value != 0)) ||
-          (axis->forbid_iso && tile_extent->value % tile != 0);
-        if (analyzer_.scop_info_.user_config_.GetPruneTuningSpaceLevel() && break_constraint) {
-          continue;
+    int64_t tile_min;
+    int64_t tile_extent;
+    if (!GetTileRange(axis, &tile_min, &tile_extent)) {
+      LOG(INFO) << "Contain expr in axis, skip.";
+      return false;
+    }
+    bool min_tile_ok = false;
+    for (int64_t tile = tile_min; tile <= tile_extent; ++tile) {
+      if (!SetTile(axis, tile, band_idx, scan->cand)) {
+        continue;
+      }
+      if (!ScanDown(axis_idx + 1, band_idx, scan)) {
+        return min_tile_ok;
+      }
+      if (!min_tile_ok) min_tile_ok = true;
+    }
+    return true;
+  }
+
+  // at most one thread per hardware thread; 0 asks for all of them
+  size_t GetScanThreads() {
+    int threads = analyzer_.scop_info_.user_config_.GetTuningSpaceThreads();
+    int hardware_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    if (threads <= 0 || threads > hardware_threads) {
+      threads = hardware_threads;
+    }
+    return static_cast<size_t>(threads);
+  }
+
+  // Enumerates the tiles of a band. The values of the outermost axis are scanned in batches by several threads, each
+  // with its own candidate, and the tiles of a batch are recorded in order afterwards, so the space is the same as the
+  // serial one. The threads are started once and wait for the next batch.
+  void ScanBand(size_t band_idx) {
+    size_t num_threads = GetScanThreads();
+    int64_t tile_min = 0;
+    int64_t tile_extent = 0;
+    if (num_threads <= 1 || tile_axes_.empty() || !GetTileRange(tile_axes_[0], &tile_min, &tile_extent) ||
+        tile_extent <= tile_min) {
+      Scan scan;
+      scan.cand = &cand_;
+      scan.record = true;
+      scan.visited = process_;
+      static_cast<void>(ScanDown(0, band_idx, &scan));
+      process_ = scan.visited;
+      return;
+    }
+
+    num_threads = std::min(num_threads, static_cast<size_t>(tile_extent - tile_min + 1));
+    std::vector<std::unique_ptr<TileCandidate>> cands;
+    for (size_t i = 0; i < num_threads; ++i) {
+      cands.emplace_back(new TileCandidate(&analyzer_));
+      cands.back()->tile_val_ = cand_.tile_val_;
+      for (auto axis : tile_axes_) {
+        cands.back()->InsertAxisBack(axis);
+      }
+    }
+
+    TileAxis *axis = tile_axes_[0];
+    auto batch_size = static_cast<int64_t>(num_threads * SCAN_TASKS_PER_THREAD);
+    std::vector<Scan> scans;
+    int64_t first = tile_min;
+    std::atomic<size_t> next_task{0};
+    std::vector<std::exception_ptr> errors(num_threads);
+    std::mutex mutex;
+    std::condition_variable batch_ready;
+    std::condition_variable batch_done;
+    size_t batch = 0;
+    size_t running = 0;
+    bool finished = false;
+    auto Work = [&, axis, band_idx](size_t worker, TileCandidate *cand) {
+      for (size_t seen = 0;; ++seen) {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          batch_ready.wait(lock, [&batch, &finished, seen] { return finished || batch != seen; });
+          if (finished) {
+            return;
+          }
         }
-        cand_.UpdateConstTile(axis, tile);
-        if (analyzer_.scop_info_.user_config_.GetPruneTuningSpaceLevel() &&
-            !cand_.SpaceVerify(axis, CACHE1, band_idx)) {
-          continue;
+        try {
+          for (size_t task = next_task++; task < scans.size(); task = next_task++) {
+            Scan &scan = scans[task];
+            scan.cand = cand;
+            if (!SetTile(axis, first + static_cast<int64_t>(task), band_idx, cand)) {
+              scan.skipped = true;
+              continue;
+            }
+            scan.ok = ScanDown(1, band_idx, &scan);
+          }
+        } catch (...) {
+          errors[worker] = std::current_exception();
         }
-        if (!ScanDown(axis_idx + 1, band_idx)) {
-          return min_tile_ok;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0) {
+          batch_done.notify_one();
         }
-        if (!min_tile_ok) min_tile_ok = true;
       }
-      return true;
-    } else {
-      LOG(INFO) << "Contain expr in axis, skip.";
-      return false;
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < num_threads; ++i) {
+      workers.emplace_back(Work, i, cands[i].get());
+    }
+
+    std::exception_ptr error;
+    for (bool stop = false; !stop && !error && first <= tile_extent; first += batch_size) {
+      scans = std::vector<Scan>(static_cast<size_t>(std::min(batch_size, tile_extent - first + 1)));
+      next_task = 0;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        running = num_threads;
+        ++batch;
+        batch_ready.notify_all();
+        batch_done.wait(lock, [&running] { return running == 0; });
+      }
+      for (auto &worker_error : errors) {
+        if (worker_error && !error) {
+          error = worker_error;
+        }
+      }
+
+      for (auto &scan : scans) {
+        if (error) {
+          break;
+        }
+        for (auto &res : scan.found) {
+          res.process += process_;
+          RecordCand(std::move(res));
+        }
+        process_ += scan.visited;
+        // the serial scan stops at the first value of the outermost axis whose smallest inner tile does not fit
+        if (!scan.skipped && !scan.ok) {
+          stop = true;
+          break;
+        }
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      finished = true;
+      batch_ready.notify_all();
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
     }
   }
 
-  bool CheckMemConstraintSize(int64_t &mem_sz, int64_t &align_sz, size_t band_idx) {
+  bool CheckMemConstraintSize(TileCandidate *cand, int64_t &mem_sz, int64_t &align_sz, size_t band_idx) {
     if (analyzer_.scop_info_.user_config_.GetTarget() == TARGET_CCE) {
-      std::tie(mem_sz, align_sz) = cand_.MemInfer(MEM_SCOPE_BUFFER, band_idx);
+      std::tie(mem_sz, align_sz) = cand->MemInfer(MEM_SCOPE_BUFFER, band_idx);
       if (analyzer_.scop_info_.user_config_.GetPruneTuningSpaceLevel() == PRUNE_ALIGNED_MEM_EXCEED &&
           align_sz > mem_limit_[MEM_SCOPE_BUFFER]) {
         return false;
@@ -284,11 +457,11 @@ class TileSpaceCollector {
 
     } else {
       int64_t shared_sz, local_sz;
-      std::tie(shared_sz, std::ignore) = cand_.MemInfer(MEM_SCOPE_SHARED, band_idx);
+      std::tie(shared_sz, std::ignore) = cand->MemInfer(MEM_SCOPE_SHARED, band_idx);
       if (analyzer_.scop_info_.user_config_.GetPruneTuningSpaceLevel() && shared_sz > mem_limit_[MEM_SCOPE_SHARED]) {
         return false;
       }
-      std::tie(local_sz, std::ignore) = cand_.MemInfer(MEM_SCOPE_LOCAL, band_idx);
+      std::tie(local_sz, std::ignore) = cand->MemInfer(MEM_SCOPE_LOCAL, band_idx);
       if (analyzer_.scop_info_.user_config_.GetPruneTuningSpaceLevel() && local_sz > mem_limit_[MEM_SCOPE_LOCAL]) {
         return false;
       }
@@ -298,35 +471,47 @@ class TileSpaceCollector {
     return true;
   }
 
-  void CollecttileSize(std::vector<int> &tile) {
+  void CollecttileSize(TileCandidate *cand, std::vector<int> &tile) {
     for (size_t i = 0; i < tile_axes_.size(); ++i) {
-      auto tile_val = cand_.GetConstTileVal(tile_axes_[i]);
+      auto tile_val = cand->GetConstTileVal(tile_axes_[i]);
       tile[i] = tile_val.first;
     }
   }
 
-  bool AppendCand(size_t band_idx) {
-    process_++;
+  bool AppendCand(size_t band_idx, Scan *scan) {
+    scan->visited++;
 
     // check memory constraint
     int64_t mem_sz, align_sz;
-    bool flag = CheckMemConstraintSize(mem_sz, align_sz, band_idx);
+    bool flag = CheckMemConstraintSize(scan->cand, mem_sz, align_sz, band_idx);
     if (not flag) return false;
 
     // collect tile size
     std::vector<int> tile(tile_axes_.size());
-    CollecttileSize(tile);
+    CollecttileSize(scan->cand, tile);
+    Result res{std::move(tile), mem_sz, align_sz, scan->visited};
+    if (scan->record) {
+      RecordCand(std::move(res));
+    } else {
+      scan->found.emplace_back(std::move(res));
+    }
+    return true;
+  }
 
+  void RecordCand(Result &&res) {
+    std::vector<int> &tile = res.tile;
+    int64_t mem_sz = res.mem_size;
+    int64_t align_sz = res.align_size;
     auto LargerThan = [&tile](std::vector<int> &other) -> bool {
       for (size_t j = 0; j < tile.size(); ++j) {
         if (tile[j] < other[j]) return false;
       }
       return true;
     };
-    auto DumpCand = [&tile, mem_sz, align_sz, this](const std::string &op) {
-      if (this->process_ % DUMP_LINE_BREAK_NUM != 0) return;
+    auto DumpCand = [&tile, mem_sz, align_sz, &res](const std::string &op) {
+      if (res.process % DUMP_LINE_BREAK_NUM != 0) return;
       std::stringstream ss;
-      ss << this->process_ << ": [";
+      ss << res.process << ": [";
       for (size_t i = 0; i < tile.size(); ++i) {
         ss << tile[i];
         if (i < tile.size() - 1) ss << ",";
@@ -344,7 +529,7 @@ class TileSpaceCollector {
           if (level_ >= DUMP_LEVEL_CANDIDATE) {
             DumpCand("skip");
           }
-          return true;
+          return;
         }
         // smaller memory, larger tile, then replace
         if ((mem_sz <= result.mem_size) && (align_sz <= result.align_size) && (LargerThan(result.tile))) {
@@ -354,7 +539,7 @@ class TileSpaceCollector {
           result.tile = std::move(tile);
           result.mem_size = mem_sz;
           result.align_size = align_sz;
-          return true;
+          return;
         }
       }
     }
@@ -363,8 +548,7 @@ class TileSpaceCollector {
     if (level_ >= DUMP_LEVEL_CANDIDATE) {
       DumpCand("new");
     }
-    result_.back().emplace_back(Result{std::move(tile), mem_sz, align_sz});
-    return true;
+    result_.back().emplace_back(std::move(res));
   }
 
   void CollectMemLimit() {
@@ -437,11 +621,6 @@ class TileSpaceCollector {
   std::vector<bool> is_shared_;
   std::unordered_set<std::string> cared_info_;
 
-  struct Result {
-    std::vector<int> tile;
-    int64_t mem_size;
-    int64_t align_size;
-  };
   std::vector<std::vector<Result>> result_;
   int process_{0};
 };
@@ -0,0 +1,261 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <tuple>
+
+#include "poly/tiling/tiling_utils.h"
+#include "poly/tiling/hermes/cpu_tiling.h"
+#include "poly/tiling/hermes/utils.h"
+
+namespace akg {
+namespace ir {
+namespace poly {
+namespace {
+// A buffer of the graph seen from the band: the global axes it is indexed by and the bytes of one element.
+struct CpuBuffer {
+  std::set<size_t> axes;
+  int64_t fixed_elems{1};
+  int64_t data_coef{1};
+  bool has_innermost_axis{false};
+  size_t innermost_axis{0};
+};
+
+struct CpuMoves {
+  double bytes{0.0};
+  int64_t working_set{0};
+  int64_t num_tiles{1};
+};
+
+int GetNodeDataCoef(const Node &node) {
+  if (!node.transformed_output_shape_.empty()) {
+    return node.transformed_output_shape_[0].GetDataTypeCoef();
+  }
+  if (!node.output_tensors_.empty()) {
+    return node.output_tensors_[0]->GetDataTypeCoef();
+  }
+  return Tensor::kFourBytesPerVal;
+}
+
+std::vector<CpuBuffer> GetCpuBuffers(const ModelGraph &model_graph) {
+  std::vector<CpuBuffer> buffers;
+  for (auto const &node : model_graph.nodes_) {
+    CpuBuffer buffer;
+    buffer.data_coef = GetNodeDataCoef(*node);
+    for (auto const &node_axis : node->axis_of_node_) {
+      bool is_global = false;
+      for (size_t i = 0; i < ModelGraph::global_axis_vec_.size(); ++i) {
+        auto const &global_axis = ModelGraph::global_axis_vec_[i];
+        if (!global_axis.is_inner_ && global_axis.dim_axis_ == node_axis.dim_axis_) {
+          buffer.axes.insert(i);
+          buffer.has_innermost_axis = true;
+          buffer.innermost_axis = i;
+          is_global = true;
+        }
+      }
+      if (!is_global) {
+        buffer.fixed_elems *= std::max(node_axis.range_, int64_t{1});
+        buffer.has_innermost_axis = false;
+      }
+    }
+    buffers.push_back(buffer);
+  }
+  return buffers;
+}
+
+int64_t CeilDiv(int64_t a, int64_t b) { return (a + b - 1) / b; }
+
+int64_t GetFootprint(const CpuBuffer &buffer, const std::vector<int64_t> &tiles, int64_t line) {
+  int64_t elems = buffer.fixed_elems;
+  int64_t inner_elems = 1;
+  for (auto a : buffer.axes) {
+    if (buffer.has_innermost_axis && a == buffer.innermost_axis) {
+      inner_elems = tiles[a];
+    } else {
+      elems *= tiles[a];
+    }
+  }
+  // a tile row is fetched as whole cache lines
+  return elems * CeilDiv(inner_elems * buffer.data_coef, line) * line;
+}
+
+// Bytes brought into a cache of the given capacity while iterating the extents with the tiles. A buffer that does
+// not depend on an axis is reused across the tiles of that axis only when the whole working set stays resident.
+CpuMoves GetMoves(const std::vector<CpuBuffer> &buffers, const std::vector<int64_t> &tiles,
+                  const std::vector<int64_t> &extents, size_t capacity, int64_t line) {
+  CpuMoves moves;
+  std::vector<int64_t> num_tiles(tiles.size(), 1);
+  for (size_t a = 0; a < tiles.size(); ++a) {
+    num_tiles[a] = CeilDiv(extents[a], tiles[a]);
+    moves.num_tiles *= num_tiles[a];
+  }
+  for (auto const &buffer : buffers) {
+    moves.working_set += GetFootprint(buffer, tiles, line);
+  }
+  bool is_resident = moves.working_set <= static_cast<int64_t>(capacity);
+  for (auto const &buffer : buffers) {
+    int64_t loads = 1;
+    for (auto a : buffer.axes) {
+      loads *= num_tiles[a];
+    }
+    if (!is_resident) {
+      loads = moves.num_tiles;
+    }
+    moves.bytes += static_cast<double>(GetFootprint(buffer, tiles, line)) * static_cast<double>(loads);
+  }
+  return moves;
+}
+
+double GetCost(const std::vector<CpuBuffer> &buffers, const CpuHardware &hardware, const std::vector<int64_t> &c1,
+               const std::vector<int64_t> &c0) {
+  std::vector<int64_t> ranges;
+  for (auto const &axis : ModelGraph::global_axis_vec_) {
+    ranges.push_back(std::max(axis.range_, int64_t{1}));
+  }
+  auto line = static_cast<int64_t>(hardware.cache_line_size_);
+  CpuMoves from_mem = GetMoves(buffers, c1, ranges, hardware.mem_L2_size_, line);
+  CpuMoves from_l2 = GetMoves(buffers, c0, c1, hardware.mem_L1_size_, line);
+  double cycles = from_mem.bytes / kCpuMemBytesPerCycle +
+                  from_l2.bytes * static_cast<double>(from_mem.num_tiles) / kCpuL2BytesPerCycle +
+                  static_cast<double>(from_mem.num_tiles * from_l2.num_tiles) * kCpuTileOverheadCycles;
+
+  // the c1 tiles of the outermost axis are shared out between the cores
+  int64_t parallel_tiles = 1;
+  for (size_t a = 0; a < c1.size(); ++a) {
+    if (!ModelGraph::global_axis_vec_[a].is_inner_) {
+      parallel_tiles = CeilDiv(ranges[a], c1[a]);
+      break;
+    }
+  }
+  auto num_core = static_cast<int64_t>(std::max(hardware.num_core_, size_t{1}));
+  int64_t rounds = CeilDiv(parallel_tiles, num_core);
+  return cycles * static_cast<double>(rounds) / static_cast<double>(parallel_tiles);
+}
+
+// Double one axis at a time, keeping the move that lowers the cost the most.
+std::vector<int64_t> SearchTiles(const std::vector<int64_t> &lower, const std::vector<int64_t> &upper,
+                                 const std::function<double(const std::vector<int64_t> &)> &cost,
+                                 const std::function<bool(const std::vector<int64_t> &)> &fits) {
+  std::vector<int64_t> tiles = lower;
+  double best_cost = cost(tiles);
+  while (true) {
+    std::vector<int64_t> best_tiles;
+    for (size_t a = 0; a < tiles.size(); ++a) {
+      if (tiles[a] >= upper[a]) {
+        continue;
+      }
+      std::vector<int64_t> cand = tiles;
+      cand[a] = std::min(tiles[a] * kByTwoL, upper[a]);
+      if (!fits(cand)) {
+        continue;
+      }
+      double cand_cost = cost(cand);
+      if (cand_cost < best_cost) {
+        best_cost = cand_cost;
+        best_tiles = cand;
+      }
+    }
+    if (best_tiles.empty()) {
+      break;
+    }
+    tiles = best_tiles;
+  }
+  return tiles;
+}
+}  // namespace
+
+double GetCpuTilingCost(const ModelGraph &model_graph, const CpuHardware &hardware,
+                        const std::vector<int64_t> &c1_tiling, const std::vector<int64_t> &c0_tiling) {
+  return GetCost(GetCpuBuffers(model_graph), hardware, c1_tiling, c0_tiling);
+}
+
+void GetCpuTilingSize(ModelGraph &model_graph, const CpuHardware &hardware, int64_t pack_a, int64_t pack_b) {
+  auto &global_axis_vec = ModelGraph::global_axis_vec_;
+  if (global_axis_vec.empty()) {
+    return;
+  }
+  std::vector<CpuBuffer> buffers = GetCpuBuffers(model_graph);
+
+  int last_axis = -1;
+  for (size_t i = 0; i < global_axis_vec.size(); ++i) {
+    if (!global_axis_vec[i].is_inner_) {
+      last_axis = static_cast<int>(i);
+    }
+  }
+
+  // smallest legal tiles: a full vector on the innermost axis and whole register blocks on gemm axes
+  size_t axis_num = global_axis_vec.size();
+  std::vector<int64_t> ranges(axis_num, 1);
+  std::vector<int64_t> lower(axis_num, 1);
+  std::vector<int64_t> upper(axis_num, 1);
+  for (size_t i = 0; i < axis_num; ++i) {
+    auto const &axis = global_axis_vec[i];
+    ranges[i] = std::max(axis.range_, int64_t{1});
+    upper[i] = ranges[i];
+    if (axis.is_inner_) {
+      lower[i] = ranges[i];
+    } else if (axis.gemm_axis_ == kDsabi) {
+      upper[i] = 1;
+    } else if (axis.gemm_axis_ == kDsami) {
+      lower[i] = std::min(std::max(pack_a, int64_t{1}), ranges[i]);
+    } else if (axis.gemm_axis_ == kDsani) {
+      lower[i] = std::min(std::max(pack_b, int64_t{1}), ranges[i]);
+    } else if (axis.gemm_axis_ == kDsaki) {
+      lower[i] = std::min(kCpuGemmKAlign, ranges[i]);
+    } else if (static_cast<int>(i) == last_axis && !axis.is_reduce_axis_) {
+      int data_coef = 0;
+      std::tie(std::ignore, data_coef) = model_graph.GetMinShapeAndDataCoef(axis);
+      int64_t lanes = static_cast<int64_t>(hardware.vector_bytes_) / std::max(data_coef, 1);
+      lower[i] = std::min(std::max(lanes, int64_t{1}), ranges[i]);
+    }
+  }
+
+  auto line = static_cast<int64_t>(hardware.cache_line_size_);
+  auto c0_for = [&lower](const std::vector<int64_t> &c1) {
+    std::vector<int64_t> c0 = lower;
+    for (size_t i = 0; i < c0.size(); ++i) {
+      c0[i] = std::min(c0[i], c1[i]);
+    }
+    return c0;
+  };
+  std::vector<int64_t> c1 = SearchTiles(
+    lower, upper,
+    [&buffers, &hardware, &c0_for](const std::vector<int64_t> &t) { return GetCost(buffers, hardware, t, c0_for(t)); },
+    [](const std::vector<int64_t> &) { return true; });
+  std::vector<int64_t> c0 = SearchTiles(
+    c0_for(c1), c1,
+    [&buffers, &hardware, &c1](const std::vector<int64_t> &t) { return GetCost(buffers, hardware, c1, t); },
+    [&buffers, &hardware, &c1, line](const std::vector<int64_t> &t) {
+      return GetMoves(buffers, t, c1, hardware.mem_L1_size_, line).working_set <=
+             static_cast<int64_t>(hardware.mem_L1_size_);
+    });
+
+  std::stringstream ss;
+  ss << "cpu tiling = [";
+  for (size_t i = 0; i < axis_num; ++i) {
+    global_axis_vec[i].c1_tiling_ = c1[i];
+    global_axis_vec[i].c0_tiling_ = c0[i];
+    ss << (i == 0 ? "" : ";") << c1[i] << "," << c0[i];
+  }
+  ss << "], modeled cycles = " << GetCost(buffers, hardware, c1, c0);
+  LOG(INFO) << ss.str();
+}
+}  // namespace poly
+}  // namespace ir
+}  // namespace akg
@@ -0,0 +1,51 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef POLY_TILING_HERMES_CPU_TILING_H_
+#define POLY_TILING_HERMES_CPU_TILING_H_
+
+#include <vector>
+
+#include "poly/tiling/hermes/axis.h"
+#include "poly/tiling/hermes/hardware.h"
+#include "poly/tiling/hermes/model_graph.h"
+
+namespace akg {
+namespace ir {
+namespace poly {
+/// \brief Pick c1 (per-thread, L2) and c0 (L1) tiles of the global axes that minimize the modeled data movement
+/// \param[in,out] model_graph Graph whose global axes receive the tiles
+/// \param[in] hardware CPU cache hierarchy
+/// \param[in] pack_a Register block of the gemm m axis
+/// \param[in] pack_b Register block of the gemm n axis
+void GetCpuTilingSize(ModelGraph &model_graph, const CpuHardware &hardware, int64_t pack_a, int64_t pack_b);
+
+/// \brief Modeled cost, in cycles, of running the graph with the given tiles
+/// \param[in] model_graph Graph to evaluate
+/// \param[in] hardware CPU cache hierarchy
+/// \param[in] c1_tiling Outer tile of each global axis
+/// \param[in] c0_tiling Inner tile of each global axis
+/// \return Cycles spent moving data from memory to L2, from L2 to L1, plus the loop overhead per tile
+double GetCpuTilingCost(const ModelGraph &model_graph, const CpuHardware &hardware,
+                        const std::vector<int64_t> &c1_tiling, const std::vector<int64_t> &c0_tiling);
+
+const double kCpuMemBytesPerCycle = 8.0;
+const double kCpuL2BytesPerCycle = 32.0;
+const double kCpuTileOverheadCycles = 32.0;
+const int64_t kCpuGemmKAlign = 8;
+}  // namespace poly
+}  // namespace ir
+}  // namespace akg
+#endif  // POLY_TILING_HERMES_CPU_TILING_H_
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <thread>
+
+#include "poly/poly_util.h"
 #include "poly/tiling/hermes/hardware.h"
 
 namespace akg {
@@ -35,6 +38,29 @@ Hardware::Hardware(size_t num_core, size_t mem_VC_size, size_t mem_C1_size, size
       section_{section} {}
 
 bool Hardware::HasVCFail(const std::string &allocation_error_buf) { return allocation_error_buf == "local.UB"; }
+
+CpuHardware::CpuHardware(size_t num_core, size_t mem_L1_size, size_t mem_L2_size, size_t mem_L3_size,
+                         size_t cache_line_size, size_t vector_bytes)
+    : num_core_{num_core},
+      mem_L1_size_{mem_L1_size},
+      mem_L2_size_{mem_L2_size},
+      mem_L3_size_{mem_L3_size},
+      cache_line_size_{cache_line_size},
+      vector_bytes_{vector_bytes} {}
+
+CpuHardware CpuHardware::HostProfile(const std::string &feature) {
+  size_t num_core = std::thread::hardware_concurrency();
+  if (num_core == 0) {
+    num_core = kCpuNumCore;
+  }
+  int vector_bits = VECTORIZED_128_BIT;
+  auto it = CpuInstructionSetBits.find(feature);
+  if (it != CpuInstructionSetBits.end()) {
+    vector_bits = it->second;
+  }
+  return CpuHardware(num_core, kCpuMemL1Size, kCpuMemL2Size, kCpuMemL3Size, kCpuCacheLineSize,
+                     static_cast<size_t>(vector_bits / ONE_BYTE_TO_BIT));
+}
 }  // namespace poly
 }  // namespace ir
 }  // namespace akg
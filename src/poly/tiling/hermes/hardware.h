@@ -44,6 +44,22 @@ class Hardware {
   static size_t mem_VC_alloc_failed_;
 };
 
+class CpuHardware {
+ public:
+  CpuHardware(size_t, size_t, size_t, size_t, size_t, size_t);
+
+  // Profile of the host for the given instruction set (see CpuInstructionSetBits), with the cache sizes
+  // below and one core per hardware thread.
+  static CpuHardware HostProfile(const std::string &feature);
+
+  size_t num_core_;
+  size_t mem_L1_size_;
+  size_t mem_L2_size_;
+  size_t mem_L3_size_;
+  size_t cache_line_size_;
+  size_t vector_bytes_;
+};
+
 const size_t kNumCore = 32;
 const size_t kMemVCSize = 262144;
 const size_t kMemC1Size = 1048576;
@@ -53,6 +69,12 @@ const size_t kMemC1Align = 512;
 const size_t kVBlockNum = 8;
 const size_t kVBlockSize = 32;
 const std::string k910BSection = "2.1";
+
+const size_t kCpuNumCore = 8;
+const size_t kCpuMemL1Size = 32768;
+const size_t kCpuMemL2Size = 1048576;
+const size_t kCpuMemL3Size = 16777216;
+const size_t kCpuCacheLineSize = 64;
 }  // namespace poly
 }  // namespace ir
 }  // namespace akg
@@ -824,9 +824,14 @@ void SpaceAnalyzer::IdentifyCastAxes() {
 }
 
 void SpaceAnalyzer::IdentifyDynamicShape() {
+  auto params = analyzer_->scop_info_.user_config_.GetParams();
   for (auto node : analyzer_->scop_info_.user_config_.GetDynamicShape()) {
     if (auto dsn = node.as<air::DynamicShapeNode>()) {
       CHECK(dsn->tensor_name != "") << "Parse dynamic shape failed. Tensor name must be set.";
+      // the limit of a shape var only bounds the params of the schedule
+      if (params.count(dsn->tensor_name) != 0) {
+        continue;
+      }
       SetAttrForTensor(dsn->tensor_name, dsn->pos, "DYN_SHAPE_LIMIT", std::to_string(dsn->dyn_shape_limit));
     }
   }
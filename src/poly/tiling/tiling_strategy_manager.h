@@ -490,6 +490,8 @@ class GpuStrategy : public TilingStrategy {
 
   void HandleShrinkThreadToBlock(int64_t &shrinked_threads, bool thread_to_block, std::stringstream &ss);
   void InjectiveSpeedup();
+  // Reject injective mappings whose modeled occupancy is clearly bad by moving threads to blocks.
+  void RejectLowOccupancyMapping();
 
   void BroadcastSpeedup();
   std::unordered_set<int> broadcast_idx_;
@@ -570,6 +572,8 @@ class GpuStrategy : public TilingStrategy {
   int min_buf_size_to_enable_vectorization_ = 8;
   int double_{2};
   bool use_shared_mem_{false};
+  double min_occupancy_{0.25};
+  int64_t bytes_per_local_elem_{4};
 
   friend class VectorizedStrategy;
 };
@@ -588,6 +592,7 @@ class CpuStrategy : public TilingStrategy {
   bool SetReduceYTileValue();
   void SetCsrTileValue();
   void SetElementWiseTileValue();
+  int64_t GetSquareTransposeSize(const std::unordered_set<std::string> &write_tensor_name);
   void SetTransposeTileValue();
   void SetMultiLevelTileValue();
   void SetUnrollTileValue(TileAxis *axis, const int64_t axis_size, int64_t &tile_left);
@@ -91,6 +91,17 @@ void CpuStrategy::SetParallelTileValue(TileAxis *axis, const int64_t axis_size,
     tile_size = tile_left;
   }
   int64_t evaluate_num = data_size / min_exec_num_per_thread_;
+  auto direction = analyzer_->scop_info_.analysis_result_.GetOuterBandNode(current_band_)->reduce_direction;
+  if (direction == ReduceDirection::ALL) {
+    // each parallel tile of an all reduce keeps its own partial result, so the axis is cut in ceil-divided tiles of
+    // whole c0 tiles and only the guarded last tile is shorter, whatever the divisors of the axis
+    int64_t c0_tiles = (axis_size + c0_tile_value - 1) / c0_tile_value;
+    int64_t tiles = std::max(std::min({evaluate_num, static_cast<int64_t>(best_parallel_num_), c0_tiles}), int64_t{1});
+    int64_t tile_value = (c0_tiles + tiles - 1) / tiles * c0_tile_value;
+    axis->TileRestrainToSingleValue(Expr(tile_value), TileLevel::CACHE1);
+    axis->TileRestrainToSingleValue(Expr(c0_tile_value), TileLevel::CACHE0);
+    return;
+  }
   if (evaluate_num >= best_parallel_num_) {
     parallel_num = std::min(axis_size, static_cast<int64_t>(best_parallel_num_));
   } else if (evaluate_num > 1) {
@@ -104,8 +115,7 @@ void CpuStrategy::SetParallelTileValue(TileAxis *axis, const int64_t axis_size,
     parallel_num = evaluate_num;
   }
   int64_t tile_value = axis_size / parallel_num;
-  auto direction = analyzer_->scop_info_.analysis_result_.GetOuterBandNode(current_band_)->reduce_direction;
-  if (direction == ReduceDirection::Y || direction == ReduceDirection::ALL) {
+  if (direction == ReduceDirection::Y) {
     if (axis_size % parallel_num != 0) {
       tile_value = axis_size;
     }
@@ -292,6 +302,28 @@ void CpuStrategy::SetElementWiseTileValue() {
   }
 }
 
+// The side of the square tile whose rows fill one vector register, 8 or 16, or 0 for the 8x4 tile.
+int64_t CpuStrategy::GetSquareTransposeSize(const std::unordered_set<std::string> &write_tensor_name) {
+  const int64_t min_square = 8;
+  const int64_t max_square = 16;
+  if (!analyzer_->scop_info_.user_config_.GetEnableSquareTranspose()) {
+    return 0;
+  }
+  auto it = CpuInstructionSetBits.find(analyzer_->scop_info_.user_config_.GetFeature());
+  if (it == CpuInstructionSetBits.end()) {
+    return 0;
+  }
+  int64_t data_bytes = 0;
+  for (const auto &name : write_tensor_name) {
+    data_bytes = std::max<int64_t>(data_bytes, analyzer_->scop_info_.user_config_.GetDataBytes(name));
+  }
+  if (data_bytes <= 0) {
+    return 0;
+  }
+  int64_t lanes = it->second / (data_bytes * ONE_BYTE_TO_BIT);
+  return lanes < min_square ? 0 : std::min(lanes, max_square);
+}
+
 void CpuStrategy::SetTransposeTileValue() {
   std::unordered_set<std::string> write_tensor_name;
   auto current_outer_bn = analyzer_->scop_info_.analysis_result_.GetOuterBandNode(current_band_);
@@ -334,6 +366,15 @@ void CpuStrategy::SetTransposeTileValue() {
   const size_t transpose_size = 2;
   const int64_t transpose_row = 8;
   const int64_t transpose_col = 4;
+  int64_t transpose_square = 0;
+  if (transpose_axis_pos.size() == transpose_size) {
+    transpose_square = GetSquareTransposeSize(write_tensor_name);
+    for (auto pos : transpose_axis_pos) {
+      if (pending_axes_[current_band_][pos].second < transpose_square) {
+        transpose_square = 0;
+      }
+    }
+  }
   if (transpose_axis_pos.size() == transpose_size) {
     current_outer_bn->enable_transpose = true;
     for (int i = static_cast<int>(ori_size - 1); i >= 0; i--) {
@@ -350,7 +391,9 @@ void CpuStrategy::SetTransposeTileValue() {
 
       tile_val = 1;
       if (transpose_axis_pos.count(i) != 0) {
-        if (transpose_write_axis_pos == i) {
+        if (transpose_square != 0) {
+          tile_val = transpose_square;
+        } else if (transpose_write_axis_pos == i) {
           tile_val = shape < transpose_row ? shape : transpose_row;
         } else {
           tile_val = shape < transpose_col ? shape : transpose_col;
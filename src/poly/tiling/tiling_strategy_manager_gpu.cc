@@ -21,6 +21,7 @@
 #include <build_module.h>
 #include "../../src/include/build_module.h"
 #include "./tiling_analyzer.h"
+#include "pass/gpu_kernel_analyzer.h"
 #include "poly/schedule_pass_gpu/register_memory_manager.h"
 #include "poly/tiling/tiling_utils.h"
 
@@ -967,6 +968,7 @@ void GpuStrategy::AddGpuConstraint() {
          template_ == Template::EXTERN_CALL) &&
         need_injective_speed_up) {
       InjectiveSpeedup();
+      RejectLowOccupancyMapping();
     }
 
     is_first = false;
@@ -1783,6 +1785,54 @@ void GpuStrategy::InjectiveSpeedup() {
   analyzer_->GetTileLogger().AppendLog(GPU_MAPPING, ss);
 }
 
+void GpuStrategy::RejectLowOccupancyMapping() {
+  if (injective_axes_.empty() || thread_cfg_.empty() || block_cfg_.empty()) {
+    return;
+  }
+  std::stringstream ss;
+  auto sm = GetGpuSmConfig(analyzer_->scop_info_.user_config_.GetDeviceType());
+  int64_t total_threads = 1;
+  int64_t elem_per_thread = 1;
+  for (auto axis : injective_axes_) {
+    auto thread_size = axis->thread_constraints.map_extent_;
+    CHECK(axis->c1_constraints.tile_extent_.as<IntImm>());
+    auto tile_size = axis->c1_constraints.tile_extent_.as<IntImm>()->value;
+    total_threads *= thread_size;
+    elem_per_thread *= std::max<int64_t>(1, tile_size / SafeDivisor(thread_size));
+  }
+  // Shrinking threads into blocks keeps the elements processed by each thread, so the register estimate is fixed.
+  int64_t local_bytes = GetLocalAllocBufCount() * elem_per_thread * bytes_per_local_elem_;
+  int64_t regs = EstimateRegsPerThread(local_bytes, static_cast<int64_t>(injective_axes_.size()) * binary_factor_);
+  auto SharedBytes = [this](int64_t threads) { return use_shared_mem_ ? threads * bytes_per_local_elem_ : 0; };
+
+  auto current = ComputeGpuOccupancy(sm, total_threads, regs, SharedBytes(total_threads));
+  ss << "[Occupancy] threads = " << total_threads << ", regs = " << regs << " -> occupancy = " << current.occupancy
+     << " (limited by " << current.limiter << ")";
+  analyzer_->GetTileLogger().AppendLog(GPU_MAPPING, ss);
+  bool changed = false;
+  while (current.occupancy < min_occupancy_ && total_threads > warp_sizes_) {
+    auto next_threads = total_threads / binary_factor_;
+    auto next = ComputeGpuOccupancy(sm, next_threads, regs, SharedBytes(next_threads));
+    if (next.occupancy <= current.occupancy) {
+      break;
+    }
+    int64_t shrinked_threads = binary_factor_;
+    HandleShrinkThreadToBlock(shrinked_threads, true, ss);
+    if (shrinked_threads != 1) {
+      break;
+    }
+    ss << "\n[Occupancy] reject threads = " << total_threads << ", use " << next_threads
+       << " -> occupancy = " << next.occupancy;
+    total_threads = next_threads;
+    current = next;
+    changed = true;
+  }
+  analyzer_->GetTileLogger().AppendLog(GPU_MAPPING, ss);
+  if (changed) {
+    WriteConfigBackInjective();
+  }
+}
+
 const void GpuStrategy::TransposeSpeedup() {
   analyzer_->GetTileLogger().AppendLine(GPU_MAPPING, "TransposeSpeedup");
   if (!analyzer_->scop_info_.user_config_.EnableStitchFusion()) {
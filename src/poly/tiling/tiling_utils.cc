@@ -36,6 +36,7 @@ int GetCoreNumConf() {
 }
 
 void TileLogger::AppendLine(LogStage stage, const std::string &line) {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (stage == ANA_SCHETREE) {
     analyze_schedule_tree_stage_.emplace_back(line);
   } else if (stage == ANA_BUF_LIVE_EXTENT) {
@@ -18,6 +18,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <mutex>
 
 #include <tvm/target_info.h>
 #include <tvm/ir.h>
@@ -160,6 +161,7 @@ class TileLogger {
  private:
   std::string log_file_name_;
   bool enable_dump_{true};
+  std::mutex mutex_;  // the tiling space is collected by several threads
   LogFile analyze_schedule_tree_stage_;
   LogFile analyze_buffer_live_extent_stage_;
   LogFile analyze_tiling_space_stage_;
@@ -15,21 +15,212 @@
  */
 
 #include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
 #include <exception>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <tuple>
 #if AKG_USE_OPENMP
 #include <omp.h>
 #endif
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
 #include <dmlc/logging.h>
+#include <tvm/runtime/registry.h>
 #include "thread_pool.h"
 
 namespace mindspore {
 namespace common {
+namespace {
+#ifdef __linux__
+constexpr auto kSysCpuDir = "/sys/devices/system/cpu/cpu";
+constexpr auto kSysNodeDir = "/sys/devices/system/node";
+
+int ReadSysInt(const std::string &path, int dft_value) {
+  std::ifstream in(path);
+  int value = dft_value;
+  if (!(in >> value)) {
+    return dft_value;
+  }
+  return value;
+}
+
+// Parse a sysfs cpu list such as "0-3,8-11".
+std::vector<int> ParseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    auto dash = range.find('-');
+    int first = std::atoi(range.substr(0, dash).c_str());
+    int last = dash == std::string::npos ? first : std::atoi(range.substr(dash + 1).c_str());
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::map<int, int> ReadCpuNumaNodes() {
+  std::map<int, int> cpu_node;
+  DIR *dir = opendir(kSysNodeDir);
+  if (dir == nullptr) {
+    return cpu_node;
+  }
+  while (auto entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, 4, "node") != 0 || name.size() == 4 || !std::isdigit(name[4])) {
+      continue;
+    }
+    int node = std::atoi(name.c_str() + 4);
+    std::ifstream in(std::string(kSysNodeDir) + "/" + name + "/cpulist");
+    std::string list;
+    std::getline(in, list);
+    for (auto cpu : ParseCpuList(list)) {
+      cpu_node[cpu] = node;
+    }
+  }
+  closedir(dir);
+  return cpu_node;
+}
+#endif
+
+// Logical cpus grouped by physical core, cores ordered by numa node, package and core id.
+std::vector<std::vector<int>> PhysicalCores(const std::vector<LogicalCpu> &cpus) {
+  std::map<std::tuple<int, int, int>, std::vector<int>> cores;
+  for (const auto &cpu : cpus) {
+    cores[std::make_tuple(cpu.numa_node, cpu.package, cpu.core)].push_back(cpu.id);
+  }
+  std::vector<std::vector<int>> res;
+  for (auto &it : cores) {
+    res.push_back(it.second);
+  }
+  return res;
+}
+}  // namespace
+
+AffinityPolicy ParseAffinityPolicy(const std::string &policy) {
+  if (policy == "compact") {
+    return AffinityPolicy::COMPACT;
+  }
+  if (policy == "scatter") {
+    return AffinityPolicy::SCATTER;
+  }
+  if (policy == "numa") {
+    return AffinityPolicy::NUMA;
+  }
+  return AffinityPolicy::NONE;
+}
+
+CpuTopology::CpuTopology() {
+#ifdef __linux__
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  bool has_mask = sched_getaffinity(0, sizeof(mask), &mask) == 0;
+  auto cpu_node = ReadCpuNumaNodes();
+  int cpu_num = static_cast<int>(std::thread::hardware_concurrency());
+  for (int id = 0; id < std::max(cpu_num, CPU_SETSIZE); ++id) {
+    if (has_mask ? !CPU_ISSET(id, &mask) : id >= cpu_num) {
+      continue;
+    }
+    LogicalCpu cpu;
+    cpu.id = id;
+    std::string topology = std::string(kSysCpuDir) + std::to_string(id) + "/topology/";
+    cpu.core = ReadSysInt(topology + "core_id", id);
+    cpu.package = ReadSysInt(topology + "physical_package_id", 0);
+    cpu.numa_node = cpu_node.count(id) ? cpu_node[id] : 0;
+    cpus_.push_back(cpu);
+  }
+#endif
+}
+
+const CpuTopology &CpuTopology::GetInstance() {
+  static CpuTopology instance{};
+  return instance;
+}
+
+size_t CpuTopology::PhysicalCoreNum() const { return PhysicalCores(cpus_).size(); }
+
+size_t CpuTopology::NumaNodeNum() const {
+  std::set<int> nodes;
+  for (const auto &cpu : cpus_) {
+    nodes.insert(cpu.numa_node);
+  }
+  return nodes.size();
+}
+
+std::vector<std::vector<int>> CpuTopology::WorkerCpuSets(AffinityPolicy policy, size_t worker_num) const {
+  std::vector<std::vector<int>> sets(worker_num);
+  auto cores = PhysicalCores(cpus_);
+  if (policy == AffinityPolicy::NONE || cores.empty()) {
+    return sets;
+  }
+  std::map<int, std::vector<size_t>> node_cores;
+  for (size_t i = 0; i < cores.size(); ++i) {
+    for (const auto &cpu : cpus_) {
+      if (cpu.id == cores[i][0]) {
+        node_cores[cpu.numa_node].push_back(i);
+        break;
+      }
+    }
+  }
+
+  if (policy == AffinityPolicy::NUMA) {
+    // workers [k * worker_num / nodes, (k + 1) * worker_num / nodes) share the cpus of node k
+    std::vector<std::vector<int>> node_cpus;
+    for (const auto &it : node_cores) {
+      std::vector<int> node_set;
+      for (auto core : it.second) {
+        node_set.insert(node_set.end(), cores[core].begin(), cores[core].end());
+      }
+      node_cpus.push_back(node_set);
+    }
+    for (size_t w = 0; w < worker_num; ++w) {
+      sets[w] = node_cpus[w * node_cpus.size() / worker_num];
+    }
+    return sets;
+  }
+
+  // one logical cpu per worker, first hyper-thread of every core before the second ones
+  std::vector<size_t> order;
+  if (policy == AffinityPolicy::COMPACT) {
+    for (size_t i = 0; i < cores.size(); ++i) {
+      order.push_back(i);
+    }
+  } else {
+    for (size_t k = 0; order.size() < cores.size(); ++k) {
+      for (const auto &it : node_cores) {
+        if (k < it.second.size()) {
+          order.push_back(it.second[k]);
+        }
+      }
+    }
+  }
+  for (size_t w = 0; w < worker_num; ++w) {
+    const auto &core = cores[order[w % order.size()]];
+    sets[w] = {core[(w / order.size()) % core.size()]};
+  }
+  return sets;
+}
 
 size_t MaxThreadNumber() {
-  size_t process_core_num = std::thread::hardware_concurrency();
+  size_t process_core_num = CpuTopology::GetInstance().PhysicalCoreNum();
+  if (process_core_num < 1) {
+    process_core_num = std::thread::hardware_concurrency();
 #if defined(_M_X64) || defined(__x86_64__)
     process_core_num /= 2;  // ignore hyper-threading
 #endif
+  }
 
   if (process_core_num < 1) {
     process_core_num = 1;
@@ -46,62 +237,176 @@ size_t MaxThreadNumber() {
 
 ThreadPool::ThreadPool() {
   max_thread_num_ = MaxThreadNumber();
+  const char *policy = getenv("AKG_THREAD_AFFINITY");
+  policy_ = ParseAffinityPolicy(policy == nullptr ? "" : policy);
+  worker_cpus_ = CpuTopology::GetInstance().WorkerCpuSets(policy_, max_thread_num_);
+}
+
+void ThreadPool::SetAffinityPolicy(AffinityPolicy policy) {
+  ClearThreadPool();
+  std::lock_guard<std::mutex> lock(pool_mtx_);
+  std::lock_guard<std::mutex> affinity_lock(affinity_mtx_);
+  policy_ = policy;
+  worker_cpus_ = CpuTopology::GetInstance().WorkerCpuSets(policy_, max_thread_num_);
+  ++policy_version_;
 }
 
-void ThreadPool::SyncRunLoop() {
+size_t ThreadPool::TaskWorker(size_t task_id, size_t task_num) const {
+  // spread short launches over all the workers, so they use every node as well
+  if (task_num == 0 || task_num >= max_thread_num_) {
+    return task_id % max_thread_num_;
+  }
+  return task_id * max_thread_num_ / task_num;
+}
+
+void ThreadPool::PinCurrentThread(size_t worker) {
+  thread_local size_t pinned_worker = SIZE_MAX;
+  thread_local size_t pinned_version = SIZE_MAX;
+  std::vector<int> cpus;
+  {
+    std::lock_guard<std::mutex> lock(affinity_mtx_);
+    size_t version = policy_version_;
+    if (pinned_worker == worker && pinned_version == version) {
+      return;
+    }
+    pinned_worker = worker;
+    pinned_version = version;
+    if (worker < worker_cpus_.size()) {
+      cpus = worker_cpus_[worker];
+    }
+  }
+#ifdef __linux__
+  // the affinity the embedder gave the thread, saved before the first pinning and given back without a policy
+  thread_local bool has_origin = false;
+  thread_local cpu_set_t origin;
+  if (cpus.empty()) {
+    if (has_origin && pthread_setaffinity_np(pthread_self(), sizeof(origin), &origin) != 0) {
+      LOG(WARNING) << "Failed to restore the affinity of worker " << worker;
+    }
+    return;
+  }
+  if (!has_origin) {
+    CPU_ZERO(&origin);
+    has_origin = pthread_getaffinity_np(pthread_self(), sizeof(origin), &origin) == 0;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+    LOG(WARNING) << "Failed to set the affinity of worker " << worker;
+  }
+#endif
+}
+
+int LaunchEvent::Wait() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  cond_var_.wait(lock, [this] { return remaining_ == 0; });
+  return status_;
+}
+
+bool LaunchEvent::Done() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return remaining_ == 0;
+}
+
+bool LaunchEvent::TaskDone(int ret) {
+  bool last = false;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (ret != SUCCESS) {
+      status_ = FAIL;
+    }
+    last = --remaining_ == 0;
+  }
+  if (last) {
+    cond_var_.notify_all();
+  }
+  return last;
+}
+
+std::queue<ThreadPool::QueuedTask> *ThreadPool::NextQueue(size_t worker) {
+  if (!worker_queues_[worker].empty()) {
+    return &worker_queues_[worker];
+  }
+  // a single launch keeps its task to worker mapping, the queues of the others are only empty in the meantime
+  if (launches_in_flight_ > 1) {
+    for (size_t k = 1; k < worker_queues_.size(); ++k) {
+      auto &queue = worker_queues_[(worker + k) % worker_queues_.size()];
+      if (!queue.empty()) {
+        return &queue;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void ThreadPool::SyncRunLoop(size_t worker) {
+  PinCurrentThread(worker);
   while (true) {
-    Task task;
+    QueuedTask item;
     {
       std::unique_lock<std::mutex> lock(task_mutex_);
-      task_cond_var_.wait(lock, [this] { return !task_queue_.empty() || exit_run_; });
-      if (exit_run_) {
+      std::queue<QueuedTask> *queue = nullptr;
+      task_cond_var_.wait(lock, [this, worker, &queue] {
+        queue = NextQueue(worker);
+        return queue != nullptr || exit_run_;
+      });
+      // tasks queued before the pool is cleared still run, someone waits for their launch
+      if (queue == nullptr) {
         return;
       }
-      task = task_queue_.front();
-      task_queue_.pop();
+      item = std::move(queue->front());
+      queue->pop();
     }
+    int ret = FAIL;
     try {
-      task();
+      ret = item.task();
     } catch (std::exception &e) {
       LOG(ERROR) << "Have exception in run loop of thread";
     }
-    {
-      std::unique_lock<std::mutex> task_lock(task_mutex_);
-      task_finished_count_ = task_finished_count_ + 1;
+    if (item.event->TaskDone(ret)) {
+      std::lock_guard<std::mutex> task_lock(task_mutex_);
+      --launches_in_flight_;
     }
-    finished_cond_var_.notify_one();
   }
 }
 
-bool ThreadPool::SyncRun(const std::vector<Task> &tasks) {
-  if (tasks.size() == 1) {
-    auto ret = tasks[0]();
-    return ret;
+LaunchEventPtr ThreadPool::AsyncRun(const std::vector<Task> &tasks) {
+  auto event = std::make_shared<LaunchEvent>(tasks.size());
+  if (tasks.empty()) {
+    return event;
   }
-  std::unique_lock<std::mutex> lock(pool_mtx_);
-  exit_run_ = false;
-  size_t task_num = tasks.size();
-  size_t thread_num = sync_run_threads_.size();
-  if (thread_num < max_thread_num_ && thread_num < task_num) {
-    auto new_thread_num = max_thread_num_;
-    if (task_num < max_thread_num_) {
-      new_thread_num = task_num;
-    }
-    for (size_t i = thread_num; i < new_thread_num; ++i) {
-      sync_run_threads_.emplace_back(std::thread(&ThreadPool::SyncRunLoop, this));
+  {
+    std::lock_guard<std::mutex> lock(pool_mtx_);
+    exit_run_ = false;
+    size_t task_num = tasks.size();
+    // all workers are started together, so the task to worker mapping stays the same between launches
+    if (sync_run_threads_.empty()) {
+      worker_queues_.assign(max_thread_num_, std::queue<QueuedTask>());
+      for (size_t i = 0; i < max_thread_num_; ++i) {
+        sync_run_threads_.emplace_back(std::thread(&ThreadPool::SyncRunLoop, this, i));
+      }
     }
-  }
 
-  for (auto &task : tasks) {
     std::lock_guard<std::mutex> task_lock(task_mutex_);
-    task_queue_.push(task);
-    task_cond_var_.notify_one();
+    ++launches_in_flight_;
+    for (size_t i = 0; i < task_num; ++i) {
+      worker_queues_[TaskWorker(i, task_num)].push(QueuedTask{tasks[i], event});
+    }
   }
-  {
-    std::unique_lock<std::mutex> task_lock(task_mutex_);
-    finished_cond_var_.wait(task_lock, [this, task_num] { return task_num == task_finished_count_; });
-    task_finished_count_ = 0;
+  task_cond_var_.notify_all();
+  return event;
+}
+
+bool ThreadPool::SyncRun(const std::vector<Task> &tasks) {
+  if (tasks.size() == 1) {
+    auto ret = tasks[0]();
+    return ret;
   }
+  // the pool is not held while waiting, so launches from other threads run alongside this one
+  (void)AsyncRun(tasks)->Wait();
   return SUCCESS;
 }
 
@@ -123,6 +428,7 @@ void ThreadPool::ClearThreadPool() {
     }
   }
   sync_run_threads_.clear();
+  worker_queues_.clear();
 }
 
 ThreadPool::~ThreadPool() {
@@ -131,6 +437,158 @@ ThreadPool::~ThreadPool() {
   } catch (...) {
   }
 }
+
+LaunchStream::LaunchStream() : thread_(&LaunchStream::Loop, this) {}
+
+LaunchStream::~LaunchStream() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    exit_ = true;
+  }
+  cond_var_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+LaunchEventPtr LaunchStream::Enqueue(Task job, const std::vector<LaunchEventPtr> &deps) {
+  auto event = std::make_shared<LaunchEvent>(1);
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    calls_.push(PendingCall{std::move(job), deps, event});
+    last_ = event;
+  }
+  cond_var_.notify_one();
+  return event;
+}
+
+int LaunchStream::Synchronize() {
+  LaunchEventPtr last;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    last = last_;
+  }
+  return last == nullptr ? SUCCESS : last->Wait();
+}
+
+void LaunchStream::Loop() {
+  while (true) {
+    PendingCall call;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cond_var_.wait(lock, [this] { return !calls_.empty() || exit_; });
+      if (calls_.empty()) {
+        return;
+      }
+      call = std::move(calls_.front());
+      calls_.pop();
+    }
+    int ret = SUCCESS;
+    for (const auto &dep : call.deps) {
+      if (dep->Wait() != SUCCESS) {
+        ret = FAIL;
+      }
+    }
+    if (ret == SUCCESS) {
+      try {
+        ret = call.job();
+      } catch (std::exception &e) {
+        LOG(ERROR) << "Have exception in launch stream: " << e.what();
+        ret = FAIL;
+      }
+    }
+    call.event->TaskDone(ret);
+  }
+}
+
+namespace {
+using air::runtime::NDArray;
+using air::runtime::PackedFunc;
+using air::runtime::TVMArgs;
+using air::runtime::TVMRetValue;
+
+// Arguments of a call that runs after LaunchAsync returned. NDArrays are held by the call, the data behind raw
+// DLTensor handles must stay valid until the launch is waited for.
+class HeldArgs {
+ public:
+  HeldArgs(const TVMArgs &args, int begin) {
+    for (int i = begin; i < args.size(); ++i) {
+      int code = args.type_codes[i];
+      if (code == kNDArrayContainer) {
+        arrays_.push_back(args[i].operator NDArray());
+      } else {
+        CHECK(code == kArrayHandle || code == kDLInt || code == kDLFloat || code == kHandle || code == kNull)
+          << "LaunchAsync takes tensors and numbers, but argument " << i - begin << " is "
+          << air::runtime::TypeCode2Str(code);
+      }
+      values_.push_back(args.values[i]);
+      codes_.push_back(code);
+    }
+  }
+  TVMArgs Args() const { return TVMArgs(values_.data(), codes_.data(), static_cast<int>(values_.size())); }
+
+ private:
+  std::vector<TVMValue> values_;
+  std::vector<int> codes_;
+  std::vector<NDArray> arrays_;
+};
+
+LaunchStream *StreamHandle(const TVMArgs &args) {
+  auto stream = static_cast<LaunchStream *>(args[0].operator void *());
+  CHECK(stream != nullptr) << "Launch stream is null";
+  return stream;
+}
+
+LaunchEventPtr *EventHandle(const TVMArgs &args, int i) {
+  auto event = static_cast<LaunchEventPtr *>(args[i].operator void *());
+  CHECK(event != nullptr) << "Launch event is null";
+  return event;
+}
+}  // namespace
+
+void SetThreadAffinity(const std::string &policy) {
+  ThreadPool::GetInstance().SetAffinityPolicy(ParseAffinityPolicy(policy));
+}
+
+TVM_REGISTER_GLOBAL("akg.runtime.SetThreadAffinity").set_body_typed(SetThreadAffinity);
+
+TVM_REGISTER_GLOBAL("akg.runtime.CreateLaunchStream").set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = static_cast<void *>(new LaunchStream());
+});
+
+TVM_REGISTER_GLOBAL("akg.runtime.DestroyLaunchStream").set_body([](TVMArgs args, TVMRetValue *rv) {
+  delete StreamHandle(args);
+});
+
+// LaunchAsync(stream, func, args...) queues func(args...) on the stream and returns the handle of the call, every
+// handle is released by one WaitLaunch.
+TVM_REGISTER_GLOBAL("akg.runtime.LaunchAsync").set_body([](TVMArgs args, TVMRetValue *rv) {
+  CHECK_GE(args.size(), 2) << "LaunchAsync takes a stream, a function and the arguments of the function";
+  auto stream = StreamHandle(args);
+  PackedFunc func = args[1];
+  auto call_args = std::make_shared<HeldArgs>(args, 2);
+  auto event = stream->Enqueue([func, call_args]() {
+    TVMRetValue ret;
+    func.CallPacked(call_args->Args(), &ret);
+    return static_cast<int>(SUCCESS);
+  });
+  *rv = static_cast<void *>(new LaunchEventPtr(event));
+});
+
+// StreamWaitLaunch(stream, event): the calls queued on the stream afterwards start once the call of event, which may
+// be on another stream, has finished.
+TVM_REGISTER_GLOBAL("akg.runtime.StreamWaitLaunch").set_body([](TVMArgs args, TVMRetValue *rv) {
+  StreamHandle(args)->Enqueue([]() { return static_cast<int>(SUCCESS); }, {*EventHandle(args, 1)});
+});
+
+TVM_REGISTER_GLOBAL("akg.runtime.WaitLaunch").set_body([](TVMArgs args, TVMRetValue *rv) {
+  std::unique_ptr<LaunchEventPtr> event(EventHandle(args, 0));
+  *rv = (*event)->Wait();
+});
+
+TVM_REGISTER_GLOBAL("akg.runtime.SynchronizeStream").set_body([](TVMArgs args, TVMRetValue *rv) {
+  *rv = StreamHandle(args)->Synchronize();
+});
 }  // namespace common
 }  // namespace mindspore
 
@@ -149,34 +607,65 @@ extern "C" {
 typedef int (*FAKGParallelLambda)(
     int task_id, int num_task, void* cdata);
 
-int AKGBackendParallelLaunch(
-    FAKGParallelLambda flambda,
-    void* cdata,
-    int num_task) {
 #if !AKG_USE_OPENMP
-  auto& thread_pool = mindspore::common::ThreadPool::GetInstance();
+static std::vector<std::function<int()>> ParallelTasks(FAKGParallelLambda flambda, void* cdata, int num_task) {
   std::vector<std::function<int()>> tasks;
-  int max_task_num = static_cast<int>(thread_pool.GetSyncRunThreadNum());
+  int max_task_num = static_cast<int>(mindspore::common::ThreadPool::GetInstance().GetSyncRunThreadNum());
   max_task_num = std::min(num_task, max_task_num);
   for (int i = 0; i < max_task_num; ++i) {
-    auto block = [&, i]() {
-        flambda(i, max_task_num, cdata);
-        return 0;
-    };
-    tasks.emplace_back(block);
+    tasks.emplace_back([flambda, cdata, i, max_task_num]() { return flambda(i, max_task_num, cdata); });
   }
-  thread_pool.SyncRun(tasks);
+  return tasks;
+}
+#endif
+
+int AKGBackendParallelLaunch(
+    FAKGParallelLambda flambda,
+    void* cdata,
+    int num_task) {
+  auto& thread_pool = mindspore::common::ThreadPool::GetInstance();
+#if !AKG_USE_OPENMP
+  thread_pool.SyncRun(ParallelTasks(flambda, cdata, num_task));
 #else
   int num_workers = std::min(static_cast<int>(mindspore::common::MaxThreadNumber()), num_task);
   omp_set_num_threads(num_workers);
   #pragma omp parallel num_threads(num_workers)
   {
-    flambda(omp_get_thread_num(), num_workers, cdata);
+    int task_id = omp_get_thread_num();
+    thread_pool.PinCurrentThread(thread_pool.TaskWorker(task_id, num_workers));
+    flambda(task_id, num_workers, cdata);
   }
 #endif
   return 0;
 }
 
+/*!
+ * \brief Queue a parallel lambda on the akg runtime and return without waiting for it.
+ *  cdata must stay valid until the launch is waited for, with OpenMP the lambda has already run on return.
+ * \return The handle of the launch, released by AKGBackendLaunchWait.
+ */
+void* AKGBackendParallelLaunchAsync(
+    FAKGParallelLambda flambda,
+    void* cdata,
+    int num_task) {
+#if !AKG_USE_OPENMP
+  auto event = mindspore::common::ThreadPool::GetInstance().AsyncRun(ParallelTasks(flambda, cdata, num_task));
+#else
+  AKGBackendParallelLaunch(flambda, cdata, num_task);
+  auto event = std::make_shared<mindspore::common::LaunchEvent>(0);
+#endif
+  return new mindspore::common::LaunchEventPtr(event);
+}
+
+/*!
+ * \brief Wait for a launch of AKGBackendParallelLaunchAsync and release its handle.
+ * \return 0 when every task returned 0, -1 otherwise.
+ */
+int AKGBackendLaunchWait(void* handle) {
+  std::unique_ptr<mindspore::common::LaunchEventPtr> event(static_cast<mindspore::common::LaunchEventPtr*>(handle));
+  return (*event)->Wait();
+}
+
 #ifdef __cplusplus
 }
 #endif
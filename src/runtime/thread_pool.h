@@ -33,29 +33,130 @@ enum Status { FAIL = -1, SUCCESS = 0 };
 using Task = std::function<int()>;
 using CTask = std::function<void(size_t, size_t)>;
 
+// How workers are pinned, read from AKG_THREAD_AFFINITY: "compact" fills the physical cores of one node before the
+// next, "scatter" deals the cores round robin over the nodes, "numa" binds a contiguous block of workers to all the
+// cpus of each node, and anything else leaves placement to the OS.
+enum class AffinityPolicy { NONE, COMPACT, SCATTER, NUMA };
+AffinityPolicy ParseAffinityPolicy(const std::string &policy);
+
+struct LogicalCpu {
+  int id{0};
+  int core{0};
+  int package{0};
+  int numa_node{0};
+};
+
+// Cpus the process may run on, discovered from sysfs and the affinity mask it was started with.
+class CpuTopology {
+ public:
+  static const CpuTopology &GetInstance();
+  const std::vector<LogicalCpu> &Cpus() const { return cpus_; }
+  size_t PhysicalCoreNum() const;
+  size_t NumaNodeNum() const;
+  // One cpu set per worker, empty when the worker is not pinned.
+  std::vector<std::vector<int>> WorkerCpuSets(AffinityPolicy policy, size_t worker_num) const;
+
+ private:
+  CpuTopology();
+  std::vector<LogicalCpu> cpus_;
+};
+
+size_t MaxThreadNumber();
+
+// Completion of one launch, shared by the caller and the tasks of the launch.
+class LaunchEvent {
+ public:
+  explicit LaunchEvent(size_t task_num) : remaining_(task_num) {}
+  // Block until every task has finished, FAIL when one of them failed or threw.
+  int Wait();
+  bool Done();
+  // Returns true for the last task of the launch.
+  bool TaskDone(int ret);
+
+ private:
+  std::mutex mtx_;
+  std::condition_variable cond_var_;
+  size_t remaining_;
+  int status_{SUCCESS};
+};
+using LaunchEventPtr = std::shared_ptr<LaunchEvent>;
+
 class ThreadPool {
  public:
   ~ThreadPool();
   ThreadPool(const ThreadPool &) = delete;
   ThreadPool &operator=(const ThreadPool &) = delete;
   static ThreadPool &GetInstance();
+  // Task i always goes to the same worker, so repeated launches touch the same data from the same cpus.
   bool SyncRun(const std::vector<Task> &tasks);
+  // Queue the tasks and return at once. Launches from several threads may be in flight together: every worker runs
+  // its tasks in arrival order, and while more than one launch is in flight an idle worker takes the next task queued
+  // on another worker, so no launch waits behind another while a worker is free.
+  LaunchEventPtr AsyncRun(const std::vector<Task> &tasks);
   size_t GetSyncRunThreadNum() { return max_thread_num_; }
   void ClearThreadPool();
+  void SetAffinityPolicy(AffinityPolicy policy);
+  // Worker that runs task task_id of a launch of task_num tasks.
+  size_t TaskWorker(size_t task_id, size_t task_num) const;
+  // Pin the calling thread to the cpus of the worker, once per worker and policy. Without a policy the thread keeps
+  // the affinity it had before the runtime first pinned it.
+  void PinCurrentThread(size_t worker);
 
  private:
+  struct QueuedTask {
+    Task task;
+    LaunchEventPtr event;
+  };
+
   ThreadPool();
-  void SyncRunLoop();
+  void SyncRunLoop(size_t worker);
+  // Queue of the task worker runs next, nullptr when it has none. Called with task_mutex_ held.
+  std::queue<QueuedTask> *NextQueue(size_t worker);
 
   size_t max_thread_num_{1};
+  // policy_ and worker_cpus_ are read by threads outside the pool as well, they are guarded by affinity_mtx_
+  mutable std::mutex affinity_mtx_;
+  AffinityPolicy policy_{AffinityPolicy::NONE};
+  std::vector<std::vector<int>> worker_cpus_;
+  std::atomic<size_t> policy_version_{0};
   std::mutex pool_mtx_;
   std::atomic_bool exit_run_ = {false};
-  std::queue<Task> task_queue_;
+  std::vector<std::queue<QueuedTask>> worker_queues_;
   std::mutex task_mutex_;
   std::condition_variable task_cond_var_;
-  size_t task_finished_count_{0};
-  std::condition_variable finished_cond_var_;
+  size_t launches_in_flight_{0};
   std::vector<std::thread> sync_run_threads_{};
 };
+
+// In order queue of kernel calls, run by a host thread of its own so the caller does not block. The parallel tasks of
+// the kernels of every stream share the workers of the ThreadPool.
+class LaunchStream {
+ public:
+  LaunchStream();
+  // Finishes the calls already queued.
+  ~LaunchStream();
+  LaunchStream(const LaunchStream &) = delete;
+  LaunchStream &operator=(const LaunchStream &) = delete;
+  // Run job after the earlier calls of the stream and after deps, it is skipped and fails when a dependency failed.
+  LaunchEventPtr Enqueue(Task job, const std::vector<LaunchEventPtr> &deps = {});
+  // Block until every call queued so far has finished.
+  int Synchronize();
+
+ private:
+  struct PendingCall {
+    Task job;
+    std::vector<LaunchEventPtr> deps;
+    LaunchEventPtr event;
+  };
+
+  void Loop();
+
+  std::mutex mtx_;
+  std::condition_variable cond_var_;
+  std::queue<PendingCall> calls_;
+  LaunchEventPtr last_;
+  bool exit_{false};
+  std::thread thread_;
+};
 }  // namespace common
 }  // namespace mindspore
\ No newline at end of file
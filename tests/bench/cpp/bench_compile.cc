@@ -0,0 +1,339 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Compile time benchmark of the composite lower for the llvm target.
+ *
+ * Built with -DBUILD_BENCH=ON, usage: bench_compile [--json] [--no-fork] [--output FILE] PATH...
+ *
+ * Every composite json (*.json, *.info with an "op_desc") found under the paths is retargeted to cpu and lowered as
+ * a Normal[P0] tree, one stage of the StageManager at a time, then built to a module. For each stage the wall time,
+ * the peak RSS of the process and the number of IR nodes are reported. Kernels are compiled in forked processes, so
+ * the peak RSS is per kernel and a crash only loses its own kernel.
+ */
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <experimental/filesystem>
+
+#include "build_module.h"
+#include "codegen/stage_lower.h"
+#include "composite/lower_tree/json_leaf.h"
+#include "composite/utils/util.h"
+
+namespace akg {
+namespace bench {
+namespace fs = std::experimental::filesystem;
+using Clock = std::chrono::steady_clock;
+// ends the stage records that a child sends back, the error of the kernel follows
+constexpr char kErrorSeparator = '\x1e';
+
+struct StageRecord {
+  std::string name;
+  double seconds{0.0};
+  int64_t peak_rss_kb{0};
+  int64_t ir_nodes{0};
+};
+
+struct KernelRecord {
+  std::string path;
+  std::string error;
+  std::vector<StageRecord> stages;
+};
+
+int64_t PeakRssKb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<int64_t>(usage.ru_maxrss);
+}
+
+int64_t CountIrNodes(const NodeRef &node) {
+  if (!node.defined()) {
+    return 0;
+  }
+  Stmt stmt;
+  if (auto func = node.as<air::LoweredFuncNode>()) {
+    stmt = func->body;
+  } else if (node->IsInstance<StmtNode>()) {
+    stmt = Downcast<Stmt>(node);
+  } else {
+    return 0;
+  }
+  int64_t count = 0;
+  PostOrderVisit(stmt, [&count](const NodeRef &) { ++count; });
+  return count;
+}
+
+bool IsCompositeJson(const fs::path &path, std::string *json_str) {
+  auto ext = path.extension().string();
+  if (ext != ".json" && ext != ".info") {
+    return false;
+  }
+  std::ifstream in(path.string());
+  std::stringstream ss;
+  ss << in.rdbuf();
+  picojson::value v;
+  if (!picojson::parse(v, ss.str()).empty() || !v.is<picojson::object>() || !v.contains("op_desc")) {
+    return false;
+  }
+  // the corpus mixes every backend, they are all measured on the cpu flow
+  auto &obj = v.get<picojson::object>();
+  obj["process"] = picojson::value("cpu");
+  obj.erase("target_info");
+  *json_str = v.serialize();
+  return true;
+}
+
+std::vector<std::pair<std::string, std::string>> CollectCorpus(const std::vector<std::string> &roots) {
+  std::vector<std::pair<std::string, std::string>> corpus;
+  auto add = [&corpus](const fs::path &path) {
+    std::string json_str;
+    if (IsCompositeJson(path, &json_str)) {
+      corpus.emplace_back(path.string(), json_str);
+    }
+  };
+  for (const auto &root : roots) {
+    if (fs::is_directory(root)) {
+      for (const auto &entry : fs::recursive_directory_iterator(root)) {
+        if (fs::is_regular_file(entry.path())) {
+          add(entry.path());
+        }
+      }
+    } else {
+      add(root);
+    }
+  }
+  std::sort(corpus.begin(), corpus.end());
+  return corpus;
+}
+
+void CompileKernel(const std::string &json_str, std::vector<StageRecord> *records) {
+  auto stage_start = Clock::now();
+  auto record = [&records, &stage_start](const std::string &name, const NodeRef &node) {
+    StageRecord r;
+    r.name = name;
+    r.seconds = std::chrono::duration<double>(Clock::now() - stage_start).count();
+    r.peak_rss_kb = PeakRssKb();
+    r.ir_nodes = CountIrNodes(node);
+    records->push_back(r);
+    stage_start = Clock::now();
+  };
+
+  // same flow as a Normal[P0] lower tree under a Module node
+  lower::JsonLowerLeaf leaf(lower::kLlvm, json_str, Map<std::string, NodeRef>());
+  leaf.Lower(lower::StageType::Begin);
+  record("Parse", NodeRef());
+
+  lower::StageLower stage_lower(leaf.Data());
+  auto stages = lower::StageManager::Instance().GetStages(leaf.Data(), lower::StageType::Begin, lower::StageType::End);
+  for (const auto &stage : stages) {
+    stage_lower.RunTo(stage.type);
+    record(stage.name, stage_lower.Node());
+  }
+
+  auto build_rst = BuildRstNode::make(stage_lower.Node(), stage_lower.Data()->name);
+  auto module = BuildToModule(build_rst, stage_lower.Data()->target);
+  CHECK(module.defined()) << "no function was lowered";
+  record("BuildToModule", NodeRef());
+}
+
+std::string Serialize(const std::vector<StageRecord> &records) {
+  std::ostringstream os;
+  os << std::setprecision(9);
+  for (const auto &r : records) {
+    os << r.name << '\t' << r.seconds << '\t' << r.peak_rss_kb << '\t' << r.ir_nodes << '\n';
+  }
+  return os.str();
+}
+
+std::vector<StageRecord> Deserialize(const std::string &text) {
+  std::vector<StageRecord> records;
+  std::istringstream is(text);
+  std::string line;
+  while (std::getline(is, line)) {
+    std::istringstream ls(line);
+    StageRecord r;
+    if (std::getline(ls, r.name, '\t') && ls >> r.seconds >> r.peak_rss_kb >> r.ir_nodes) {
+      records.push_back(r);
+    }
+  }
+  return records;
+}
+
+KernelRecord RunInProcess(const std::string &path, const std::string &json_str) {
+  KernelRecord kernel;
+  kernel.path = path;
+  try {
+    CompileKernel(json_str, &kernel.stages);
+  } catch (const std::exception &e) {
+    kernel.error = e.what();
+  }
+  return kernel;
+}
+
+KernelRecord RunInChild(const std::string &path, const std::string &json_str) {
+  int fds[2];
+  CHECK_EQ(pipe(fds), 0) << "Failed to create a pipe";
+  pid_t pid = fork();
+  CHECK_GE(pid, 0) << "Failed to fork";
+  if (pid == 0) {
+    close(fds[0]);
+    KernelRecord kernel = RunInProcess(path, json_str);
+    std::string text = Serialize(kernel.stages) + kErrorSeparator + kernel.error;
+    size_t offset = 0;
+    while (offset < text.size()) {
+      ssize_t n = write(fds[1], text.data() + offset, text.size() - offset);
+      if (n <= 0) {
+        break;
+      }
+      offset += static_cast<size_t>(n);
+    }
+    _exit(kernel.error.empty() ? 0 : 1);
+  }
+  close(fds[1]);
+  std::string text;
+  char buf[4096];
+  ssize_t n;
+  while ((n = read(fds[0], buf, sizeof(buf))) > 0) {
+    text.append(buf, static_cast<size_t>(n));
+  }
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+
+  KernelRecord kernel;
+  kernel.path = path;
+  auto split = text.find(kErrorSeparator);
+  kernel.stages = Deserialize(text.substr(0, split));
+  if (split != std::string::npos) {
+    kernel.error = text.substr(split + 1);
+  }
+  if (WIFSIGNALED(status)) {
+    kernel.error = "killed by signal " + std::to_string(WTERMSIG(status));
+  } else if (WEXITSTATUS(status) != 0 && kernel.error.empty()) {
+    kernel.error = "exited with status " + std::to_string(WEXITSTATUS(status));
+  }
+  return kernel;
+}
+
+std::string JsonEscape(const std::string &s) { return picojson::value(s).serialize(); }
+
+void PrintJson(const std::vector<KernelRecord> &kernels, std::ostream &os) {
+  os << std::setprecision(9) << "{\"target\": \"llvm\", \"kernels\": [";
+  for (size_t i = 0; i < kernels.size(); ++i) {
+    const auto &k = kernels[i];
+    os << (i == 0 ? "\n" : ",\n") << "  {\"path\": " << JsonEscape(k.path) << ", \"ok\": " << std::boolalpha
+       << k.error.empty();
+    if (!k.error.empty()) {
+      os << ", \"error\": " << JsonEscape(k.error);
+    }
+    os << ", \"stages\": [";
+    for (size_t j = 0; j < k.stages.size(); ++j) {
+      const auto &s = k.stages[j];
+      os << (j == 0 ? "" : ", ") << "{\"name\": " << JsonEscape(s.name) << ", \"seconds\": " << s.seconds
+         << ", \"peak_rss_kb\": " << s.peak_rss_kb << ", \"ir_nodes\": " << s.ir_nodes << "}";
+    }
+    os << "]}";
+  }
+  os << "\n]}\n";
+}
+
+void PrintTable(const std::vector<KernelRecord> &kernels, std::ostream &os) {
+  std::vector<std::string> names;
+  std::vector<double> totals;
+  size_t failed = 0;
+  for (const auto &k : kernels) {
+    os << k.path << (k.error.empty() ? "" : "  FAILED: " + k.error.substr(0, k.error.find('\n'))) << "\n";
+    for (const auto &s : k.stages) {
+      os << "  " << std::left << std::setw(20) << s.name << std::right << std::fixed << std::setprecision(4)
+         << std::setw(10) << s.seconds << " s" << std::setw(10) << s.peak_rss_kb / 1024 << " MB" << std::setw(10)
+         << s.ir_nodes << " nodes\n";
+      auto it = std::find(names.begin(), names.end(), s.name);
+      if (it == names.end()) {
+        names.push_back(s.name);
+        totals.push_back(s.seconds);
+      } else {
+        totals[it - names.begin()] += s.seconds;
+      }
+    }
+    failed += k.error.empty() ? 0 : 1;
+  }
+  os << "\n" << kernels.size() << " kernels, " << failed << " failed\n";
+  for (size_t i = 0; i < names.size(); ++i) {
+    os << "  " << std::left << std::setw(20) << names[i] << std::right << std::setw(10) << totals[i] << " s\n";
+  }
+}
+}  // namespace bench
+}  // namespace akg
+
+int main(int argc, char **argv) {
+  bool json = false;
+  bool use_fork = true;
+  std::string output;
+  std::vector<std::string> roots;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--json") {
+      json = true;
+    } else if (arg == "--no-fork") {
+      use_fork = false;
+    } else if (arg == "--output" && i + 1 < argc) {
+      output = argv[++i];
+    } else if (arg == "-h" || arg == "--help") {
+      std::cout << "Usage: " << argv[0] << " [--json] [--no-fork] [--output FILE] PATH...\n";
+      return 0;
+    } else {
+      roots.push_back(arg);
+    }
+  }
+  if (roots.empty()) {
+    std::cerr << "No corpus given, try " << argv[0] << " tests/st/composite\n";
+    return 1;
+  }
+
+  std::vector<akg::bench::KernelRecord> kernels;
+  for (const auto &it : akg::bench::CollectCorpus(roots)) {
+    kernels.push_back(use_fork ? akg::bench::RunInChild(it.first, it.second)
+                               : akg::bench::RunInProcess(it.first, it.second));
+    std::cerr << "[" << kernels.size() << "] " << it.first << (kernels.back().error.empty() ? "" : " FAILED") << "\n";
+  }
+
+  std::ofstream file;
+  if (!output.empty()) {
+    file.open(output);
+    if (!file.is_open()) {
+      std::cerr << "Failed to open " << output << "\n";
+      return 1;
+    }
+  }
+  std::ostream &os = output.empty() ? std::cout : file;
+  if (json) {
+    akg::bench::PrintJson(kernels, os);
+  } else {
+    akg::bench::PrintTable(kernels, os);
+  }
+  return 0;
+}
@@ -0,0 +1,486 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Runtime benchmark of compiled cpu kernels, without the python launch path.
+ *
+ * Built with -DBUILD_BENCH=ON, usage:
+ *   bench_kernel [options] SPEC.json...
+ *   bench_kernel [options] --module MOD.so --func NAME --arg float32:1024x1024 --arg ... [--flops N]
+ *
+ * A spec lists the kernels of a batch, module paths are relative to the spec:
+ *   {"kernels": [{"module": "add.so", "func": "add", "flops": 1048576,
+ *                 "args": [{"dtype": "float32", "shape": [1024, 1024]}, ...]}]}
+ *
+ * Every kernel gets 64 byte aligned random arguments, runs the warm-up iterations and then the timed ones, each timed
+ * separately. With --flush-cache a buffer larger than the last level cache is written before every timed run, so
+ * the inputs come from memory. The report gives the median and p99 latency, and GFLOP/s and GB/s where the bytes are
+ * the compulsory traffic of the arguments and the flops default to one per element of the last argument. With
+ * --peak-gflops and --peak-gbps the roofline bound min(peak_gflops, intensity * peak_gbps) is reported as well.
+ */
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "picojson.h"
+#include "tvm.h"
+
+namespace akg {
+namespace bench {
+using Clock = std::chrono::steady_clock;
+using air::runtime::NDArray;
+
+constexpr int64_t kDefaultFlushBytes = 256LL << 20;
+constexpr int64_t kCacheLineBytes = 64;
+
+struct ArgSpec {
+  std::string dtype;
+  std::vector<int64_t> shape;
+};
+
+struct KernelSpec {
+  std::string module;
+  std::string func;
+  std::vector<ArgSpec> args;
+  double flops{-1.0};
+};
+
+struct Options {
+  int warmup{10};
+  int repeat{100};
+  bool flush_cache{false};
+  int64_t flush_bytes{0};
+  int threads{0};
+  std::string affinity;
+  bool pin{false};
+  std::string format{"table"};
+  std::string output;
+  double peak_gflops{0.0};
+  double peak_gbps{0.0};
+};
+
+struct KernelResult {
+  KernelSpec spec;
+  std::string error;
+  double median_us{0.0};
+  double p99_us{0.0};
+  double min_us{0.0};
+  double mean_us{0.0};
+  double bytes{0.0};
+  double flops{0.0};
+};
+
+ArgSpec ParseArg(const std::string &text) {
+  // dtype:d0xd1x...
+  ArgSpec arg;
+  auto colon = text.find(':');
+  CHECK(colon != std::string::npos) << "argument " << text << " should be dtype:shape, e.g. float32:1024x1024";
+  arg.dtype = text.substr(0, colon);
+  std::istringstream is(text.substr(colon + 1));
+  std::string dim;
+  while (std::getline(is, dim, 'x')) {
+    arg.shape.push_back(std::stoll(dim));
+  }
+  return arg;
+}
+
+std::string DirName(const std::string &path) {
+  auto pos = path.find_last_of('/');
+  return pos == std::string::npos ? "" : path.substr(0, pos + 1);
+}
+
+std::vector<KernelSpec> LoadSpec(const std::string &path) {
+  std::ifstream in(path);
+  CHECK(in.is_open()) << "Failed to open " << path;
+  std::stringstream ss;
+  ss << in.rdbuf();
+  picojson::value v;
+  std::string err = picojson::parse(v, ss.str());
+  CHECK(err.empty()) << "Failed to parse " << path << ": " << err;
+  CHECK(v.contains("kernels") && v.get("kernels").is<picojson::array>()) << path << " has no kernels list";
+
+  std::vector<KernelSpec> kernels;
+  for (const auto &k : v.get("kernels").get<picojson::array>()) {
+    KernelSpec spec;
+    spec.module = k.get("module").to_str();
+    if (!spec.module.empty() && spec.module[0] != '/') {
+      spec.module = DirName(path) + spec.module;
+    }
+    spec.func = k.get("func").to_str();
+    if (k.contains("flops")) {
+      spec.flops = k.get("flops").get<double>();
+    }
+    for (const auto &a : k.get("args").get<picojson::array>()) {
+      ArgSpec arg;
+      arg.dtype = a.get("dtype").to_str();
+      for (const auto &d : a.get("shape").get<picojson::array>()) {
+        arg.shape.push_back(static_cast<int64_t>(d.get<double>()));
+      }
+      spec.args.push_back(arg);
+    }
+    kernels.push_back(spec);
+  }
+  return kernels;
+}
+
+int64_t NumElements(const ArgSpec &arg) {
+  int64_t n = 1;
+  for (auto d : arg.shape) {
+    n *= d;
+  }
+  return n;
+}
+
+template <typename T>
+void FillRandom(T *data, int64_t n, std::mt19937 &gen) {
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for (int64_t i = 0; i < n; ++i) {
+    data[i] = static_cast<T>(dist(gen));
+  }
+}
+
+NDArray AllocArg(const ArgSpec &arg, std::mt19937 &gen) {
+  DLDataType dtype = air::runtime::String2TVMType(arg.dtype);
+  DLContext ctx{kDLCPU, 0};
+  // the cpu device api aligns every allocation to kAllocAlignment (64) bytes
+  NDArray arr = NDArray::Empty(arg.shape, dtype, ctx);
+  void *data = arr->data;
+  int64_t n = NumElements(arg);
+  if (dtype.code == kDLFloat && dtype.bits == 32) {
+    FillRandom(static_cast<float *>(data), n, gen);
+  } else if (dtype.code == kDLFloat && dtype.bits == 64) {
+    FillRandom(static_cast<double *>(data), n, gen);
+  } else if (dtype.code == kDLFloat && dtype.bits == 16) {
+    // 1.0 in half precision, enough to keep the kernels away from denormals and nans
+    std::fill_n(static_cast<uint16_t *>(data), n, static_cast<uint16_t>(0x3c00));
+  } else {
+    // small integers, so that indices and shifts stay in range
+    auto bytes = static_cast<uint8_t *>(data);
+    int64_t size = n * ((dtype.bits * dtype.lanes + 7) / 8);
+    std::fill_n(bytes, size, 0);
+    int64_t elem_bytes = (dtype.bits + 7) / 8;
+    for (int64_t i = 0; i < n; ++i) {
+      bytes[i * elem_bytes] = static_cast<uint8_t>(i % 2);
+    }
+  }
+  return arr;
+}
+
+class CacheFlusher {
+ public:
+  explicit CacheFlusher(int64_t bytes) : buffer_(static_cast<size_t>(bytes / sizeof(int64_t)), 0) {}
+  void Flush() {
+    // writing every line evicts dirty output lines as well as inputs
+    const size_t step = kCacheLineBytes / sizeof(int64_t);
+    for (size_t i = 0; i < buffer_.size(); i += step) {
+      buffer_[i] += 1;
+    }
+    sink_ = buffer_[buffer_.size() / 2];
+  }
+
+ private:
+  std::vector<int64_t> buffer_;
+  volatile int64_t sink_{0};
+};
+
+int64_t LastLevelCacheBytes() {
+  for (int index = 4; index >= 0; --index) {
+    std::ifstream in("/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/size");
+    std::string size;
+    if (in >> size && !size.empty()) {
+      int64_t value = std::stoll(size);
+      char unit = size.back();
+      return unit == 'K' ? value << 10 : unit == 'M' ? value << 20 : value;
+    }
+  }
+  return 0;
+}
+
+double Percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+  return sorted[std::min(std::max(rank, size_t{1}), sorted.size()) - 1];
+}
+
+void PinCallingThread() {
+  // the calling thread reads the clock around every launch, keep it on the first cpu it may use so that it does not
+  // migrate between the timestamps. It runs task 0 only under the OpenMP and tvm launchers, the akg runtime pool runs
+  // every task on its workers and the calling thread just waits.
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+    return;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &mask)) {
+      cpu_set_t one;
+      CPU_ZERO(&one);
+      CPU_SET(cpu, &one);
+      sched_setaffinity(0, sizeof(one), &one);
+      return;
+    }
+  }
+}
+
+KernelResult RunKernel(const KernelSpec &spec, const Options &opt, CacheFlusher *flusher) {
+  KernelResult result;
+  result.spec = spec;
+  try {
+    Module mod = Module::LoadFromFile(spec.module);
+    PackedFunc func = mod.GetFunction(spec.func);
+    CHECK(func != nullptr) << "no function " << spec.func << " in " << spec.module;
+
+    std::mt19937 gen(0);
+    std::vector<NDArray> arrays;
+    std::vector<TVMValue> values(spec.args.size());
+    std::vector<int> codes(spec.args.size(), kArrayHandle);
+    for (size_t i = 0; i < spec.args.size(); ++i) {
+      arrays.push_back(AllocArg(spec.args[i], gen));
+      values[i].v_handle = const_cast<DLTensor *>(arrays.back().operator->());
+      DLDataType t = arrays.back()->dtype;
+      result.bytes += static_cast<double>(NumElements(spec.args[i]) * ((t.bits * t.lanes + 7) / 8));
+    }
+    result.flops = spec.flops >= 0 ? spec.flops
+                                   : static_cast<double>(spec.args.empty() ? 0 : NumElements(spec.args.back()));
+    air::runtime::TVMArgs args(values.data(), codes.data(), static_cast<int>(values.size()));
+    air::runtime::TVMRetValue rv;
+
+    for (int i = 0; i < opt.warmup; ++i) {
+      func.CallPacked(args, &rv);
+    }
+    if (opt.pin) {
+      // the runtime pool takes its cpus from the affinity of the calling thread when it is built by the first launch
+      if (opt.warmup == 0) {
+        func.CallPacked(args, &rv);
+      }
+      PinCallingThread();
+    }
+    std::vector<double> times;
+    for (int i = 0; i < opt.repeat; ++i) {
+      if (flusher != nullptr) {
+        flusher->Flush();
+      }
+      auto start = Clock::now();
+      func.CallPacked(args, &rv);
+      times.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    result.median_us = Percentile(times, 0.5);
+    result.p99_us = Percentile(times, 0.99);
+    result.min_us = times.empty() ? 0.0 : times.front();
+    result.mean_us = times.empty() ? 0.0 : std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+  } catch (const std::exception &e) {
+    result.error = e.what();
+  }
+  return result;
+}
+
+struct Derived {
+  double gflops{0.0};
+  double gbps{0.0};
+  double intensity{0.0};
+  double roofline_gflops{0.0};
+};
+
+Derived Derive(const KernelResult &r, const Options &opt) {
+  Derived d;
+  if (r.median_us > 0.0) {
+    // bytes per microsecond is 1e-3 GB/s
+    d.gflops = r.flops / r.median_us * 1e-3;
+    d.gbps = r.bytes / r.median_us * 1e-3;
+  }
+  d.intensity = r.bytes > 0.0 ? r.flops / r.bytes : 0.0;
+  if (opt.peak_gflops > 0.0 && opt.peak_gbps > 0.0) {
+    d.roofline_gflops = std::min(opt.peak_gflops, d.intensity * opt.peak_gbps);
+  }
+  return d;
+}
+
+std::string Quote(const std::string &s) { return picojson::value(s).serialize(); }
+
+void Report(const std::vector<KernelResult> &results, const Options &opt, std::ostream &os) {
+  bool roofline = opt.peak_gflops > 0.0 && opt.peak_gbps > 0.0;
+  if (opt.format == "json") {
+    os << std::setprecision(9) << "{\"warmup\": " << opt.warmup << ", \"repeat\": " << opt.repeat
+       << ", \"flush_cache\": " << std::boolalpha << opt.flush_cache << ", \"kernels\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+      const auto &r = results[i];
+      auto d = Derive(r, opt);
+      os << (i == 0 ? "\n" : ",\n") << "  {\"module\": " << Quote(r.spec.module) << ", \"func\": " << Quote(r.spec.func)
+         << ", \"ok\": " << r.error.empty();
+      if (!r.error.empty()) {
+        os << ", \"error\": " << Quote(r.error) << "}";
+        continue;
+      }
+      os << ", \"median_us\": " << r.median_us << ", \"p99_us\": " << r.p99_us << ", \"min_us\": " << r.min_us
+         << ", \"mean_us\": " << r.mean_us << ", \"flops\": " << r.flops << ", \"bytes\": " << r.bytes
+         << ", \"gflops\": " << d.gflops << ", \"gbps\": " << d.gbps << ", \"intensity\": " << d.intensity;
+      if (roofline) {
+        os << ", \"roofline_gflops\": " << d.roofline_gflops;
+      }
+      os << "}";
+    }
+    os << "\n]}\n";
+  } else if (opt.format == "csv") {
+    os << "module,func,median_us,p99_us,min_us,mean_us,gflops,gbps,intensity" << (roofline ? ",roofline_gflops" : "")
+       << ",error\n";
+    for (const auto &r : results) {
+      auto d = Derive(r, opt);
+      os << r.spec.module << "," << r.spec.func << "," << r.median_us << "," << r.p99_us << "," << r.min_us << ","
+         << r.mean_us << "," << d.gflops << "," << d.gbps << "," << d.intensity;
+      if (roofline) {
+        os << "," << d.roofline_gflops;
+      }
+      os << "," << Quote(r.error) << "\n";
+    }
+  } else {
+    os << std::left << std::setw(32) << "func" << std::right << std::setw(12) << "median us" << std::setw(12)
+       << "p99 us" << std::setw(12) << "GFLOP/s" << std::setw(12) << "GB/s" << (roofline ? "  of roofline" : "")
+       << "\n";
+    for (const auto &r : results) {
+      os << std::left << std::setw(32) << r.spec.func << std::right;
+      if (!r.error.empty()) {
+        os << "  FAILED: " << r.error.substr(0, r.error.find('\n')) << "\n";
+        continue;
+      }
+      auto d = Derive(r, opt);
+      os << std::fixed << std::setprecision(2) << std::setw(12) << r.median_us << std::setw(12) << r.p99_us
+         << std::setw(12) << d.gflops << std::setw(12) << d.gbps;
+      if (roofline && d.roofline_gflops > 0.0) {
+        os << std::setw(12) << 100.0 * d.gflops / d.roofline_gflops << " %";
+      }
+      os << "\n";
+    }
+  }
+}
+
+}  // namespace bench
+}  // namespace akg
+
+int main(int argc, char **argv) {
+  using akg::bench::KernelSpec;
+  akg::bench::Options opt;
+  KernelSpec inline_kernel;
+  std::vector<std::string> specs;
+  auto next = [&argc, &argv](int &i) -> std::string {
+    if (i + 1 >= argc) {
+      std::cerr << argv[i] << " needs a value\n";
+      exit(1);
+    }
+    return argv[++i];
+  };
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--warmup") {
+      opt.warmup = std::stoi(next(i));
+    } else if (arg == "--repeat") {
+      opt.repeat = std::stoi(next(i));
+    } else if (arg == "--flush-cache") {
+      opt.flush_cache = true;
+    } else if (arg == "--flush-bytes") {
+      opt.flush_bytes = std::stoll(next(i));
+    } else if (arg == "--threads") {
+      opt.threads = std::stoi(next(i));
+    } else if (arg == "--affinity") {
+      opt.affinity = next(i);
+    } else if (arg == "--pin") {
+      opt.pin = true;
+    } else if (arg == "--format") {
+      opt.format = next(i);
+    } else if (arg == "--output") {
+      opt.output = next(i);
+    } else if (arg == "--peak-gflops") {
+      opt.peak_gflops = std::stod(next(i));
+    } else if (arg == "--peak-gbps") {
+      opt.peak_gbps = std::stod(next(i));
+    } else if (arg == "--module") {
+      inline_kernel.module = next(i);
+    } else if (arg == "--func") {
+      inline_kernel.func = next(i);
+    } else if (arg == "--arg") {
+      inline_kernel.args.push_back(akg::bench::ParseArg(next(i)));
+    } else if (arg == "--flops") {
+      inline_kernel.flops = std::stod(next(i));
+    } else if (arg == "-h" || arg == "--help") {
+      std::cout << "Usage: " << argv[0]
+                << " [--warmup N] [--repeat N] [--flush-cache] [--flush-bytes N] [--threads N]"
+                   " [--affinity compact|scatter|numa] [--pin] [--format table|csv|json] [--output FILE]"
+                   " [--peak-gflops X --peak-gbps Y] (SPEC.json... | --module MOD --func NAME --arg dtype:shape...)\n";
+      return 0;
+    } else {
+      specs.push_back(arg);
+    }
+  }
+
+  // the runtime thread pool reads these when it is first used
+  if (opt.threads > 0) {
+    setenv("AKG_NUM_THREADS", std::to_string(opt.threads).c_str(), 1);
+  }
+  if (!opt.affinity.empty()) {
+    setenv("AKG_THREAD_AFFINITY", opt.affinity.c_str(), 1);
+  }
+
+  std::vector<KernelSpec> kernels;
+  if (!inline_kernel.module.empty()) {
+    kernels.push_back(inline_kernel);
+  }
+  for (const auto &spec : specs) {
+    auto loaded = akg::bench::LoadSpec(spec);
+    kernels.insert(kernels.end(), loaded.begin(), loaded.end());
+  }
+  if (kernels.empty()) {
+    std::cerr << "No kernel given, see " << argv[0] << " --help\n";
+    return 1;
+  }
+
+  std::unique_ptr<akg::bench::CacheFlusher> flusher;
+  if (opt.flush_cache) {
+    int64_t bytes = opt.flush_bytes > 0 ? opt.flush_bytes : 2 * akg::bench::LastLevelCacheBytes();
+    flusher = std::make_unique<akg::bench::CacheFlusher>(bytes > 0 ? bytes : akg::bench::kDefaultFlushBytes);
+  }
+  std::vector<akg::bench::KernelResult> results;
+  for (const auto &kernel : kernels) {
+    results.push_back(akg::bench::RunKernel(kernel, opt, flusher.get()));
+  }
+
+  std::ofstream file;
+  if (!opt.output.empty()) {
+    file.open(opt.output);
+    if (!file.is_open()) {
+      std::cerr << "Failed to open " << opt.output << "\n";
+      return 1;
+    }
+  }
+  akg::bench::Report(results, opt, opt.output.empty() ? std::cout : file);
+  bool failed = std::any_of(results.begin(), results.end(), [](const akg::bench::KernelResult &r) {
+    return !r.error.empty();
+  });
+  return failed ? 1 : 0;
+}
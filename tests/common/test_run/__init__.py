@@ -75,11 +75,14 @@ from .reshape_run import reshape_run
 from .round_run import round_run
 from .rsqrt_run import rsqrt_run
 from .select_run import select_run
+from .shared_pipeline_run import shared_pipeline_run
 from .sqrt_run import sqrt_run
 from .standard_normal_run import standard_normal_run
 from .sub_run import sub_run
+from .sync_elimination_run import sync_elimination_run, sync_elimination_lower_run
 from .tensor_scatter_add_run import tensor_scatter_add_run
 from .tile_run import tile_run
 from .transpose_run import transpose_run
+from .tuning_space_run import tuning_space_run
 from .unsorted_segment_max_run import unsorted_segment_max_run
 from .unsorted_segment_sum_run import unsorted_segment_sum_run
\ No newline at end of file
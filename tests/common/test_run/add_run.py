@@ -81,6 +81,28 @@ def add_run(shape1, shape2, dtype, kernel_name="add", scale=1.0, attrs_op=None,
         return (input1, input2), output, expect, compare_tensor(output, expect, rtol=rtol, atol=atol, equal_nan=True)
 
 
+def add_vectorized_run(shape1, shape2, dtype, vector_type, attrs=None):
+    """
+    Runs add on shapes that leave a partial tile on every axis. On the cpu, also checks that the full tiles are still
+    vectorized, with vector_type in the llvm source.
+    """
+    attrs = {} if attrs is None else attrs
+    args, expect, input1, input2 = gen_data(shape1, shape2, dtype, 1.0)
+    mod = utils.op_build_test(add, [shape1, shape2], [dtype, dtype], [1.0], kernel_name="add_vectorized", attrs=attrs,
+                              polyhedral=True)
+    if attrs.get("target", "").split()[0] == "llvm" and vector_type not in mod.get_source():
+        raise AssertionError("add of {} is not vectorized: no {} in the llvm source".format(shape1, vector_type))
+    output = utils.mod_launch(mod, args, outputs=(2,), expect=expect)
+
+    if attrs.get("profiling", False):
+        target_name = attrs["target"].split()[0]
+        data = to_tvm_nd_array(args, akg.tvm.context(target_name, 0))
+        target_profiling(mod, *data, target=target_name, repeat_time=attrs["repeat_times"])
+
+    rtol, atol = get_rtol_atol("add", dtype)
+    return (input1, input2), output, expect, compare_tensor(output, expect, rtol=rtol, atol=atol, equal_nan=True)
+
+
 def gen_data(shape1, shape2, dtype, scale):
     input1 = random_gaussian(shape1, miu=1, sigma=0.1)
     input2 = random_gaussian(shape2, miu=1, sigma=0.1)
@@ -11,6 +11,7 @@
 # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 # See the License for the specific language governing permissions and
 # limitations under the License
+import re
 import numpy as np
 import akg
 from akg.ops.math.gpu import BatchMatMul
@@ -20,6 +21,24 @@ from akg.utils.result_analysis import target_profiling
 from akg.utils.format_transform import to_tvm_nd_array
 
 
+def parallel_lambdas(mod):
+    """number of parallel loops of an llvm module, each is launched as a lambda"""
+    return len(re.findall(r"^define .*_lambda(\.\d+)?\"?\(", mod.get_source(), re.M))
+
+
+def check_gemm_epilogue_fused(mod, op_func, input_shapes, input_types, op_attrs, attrs, poly_sch, inputs, output):
+    """the epilogue of the cpu gemm in mod must be folded into it and match the separate pass over C"""
+    unfused_attrs = dict(attrs, enable_cpu_gemm_epilogue=False)
+    unfused_mod = utils.op_build_test(op_func, input_shapes, input_types, op_attrs=op_attrs, attrs=unfused_attrs,
+                                      polyhedral=poly_sch, kernel_name="batch_matmul_unfused")
+    if parallel_lambdas(mod) >= parallel_lambdas(unfused_mod):
+        print("The epilogue is not fused into the gemm")
+        return False
+    unfused_output = np.full(output.shape, np.nan, output.dtype)
+    unfused_output = utils.mod_launch(unfused_mod, (*inputs, unfused_output), expect=output)
+    return np.allclose(output, unfused_output, rtol=1e-05, atol=1.e-8)
+
+
 def gen_data(shape1, shape2, dtype, out_dtype="float32", layout1="NHDT", layout2="NHDT", layout_out="NHDT", shape_bias=None, add_bias=False):
     support_list = {"float16": np.float16, "float32": np.float32}
     lhs = random_gaussian(shape1, miu=1, sigma=0.1).astype(support_list[dtype])
@@ -98,8 +117,11 @@ def batch_matmul_run(shape1, shape2, dtype, out_dtype="float32", layout1="NHDT",
     args = (lhs, rhs, bias, output)
     output = utils.mod_launch(mod, args, expect=expect)
     res = np.allclose(output, expect, rtol=5e-03, atol=1.e-8)
-    print("Test {}".format("Pass" if res else "Fail"))
     target_name = default_attrs["target"].split()[0]
+    if res and target_name == "llvm" and add_bias:
+        res = check_gemm_epilogue_fused(mod, BatchMatMul, (shape1, shape2, shape_bias), (dtype, dtype, out_dtype),
+                                        op_attrs, default_attrs, poly_sch, (lhs, rhs, bias), output)
+    print("Test {}".format("Pass" if res else "Fail"))
     if not res:
         mod_source = mod
         if target_name != "llvm":
@@ -16,4 +16,14 @@ from .conv2d_run import conv2d_run
 from .depthwise_conv2d_run import depthwise_conv2d_run
 from .layout_transform_run import layout_transform_run
 from .pooling_run import pooling_run
-from .global_pooling_run import global_pooling_run
\ No newline at end of file
+from .global_pooling_run import global_pooling_run
+from .elemwise_bandwidth_run import elemwise_bandwidth_run
+from .stream_bandwidth_run import stream_bandwidth_run
+from .fused_reduce_broadcast_run import fused_reduce_broadcast_run
+from .quantized_run import quantized_matmul_run, quantized_conv2d_run
+from .vector_math_run import vector_math_run
+from .all_reduce_run import all_reduce_run
+from .async_launch_run import async_launch_run
+from .autodiff_recompute_run import autodiff_recompute_run
+from .shape_bucket_run import shape_bucket_run
+from .batch_matmul_epilogue_run import batch_matmul_epilogue_run
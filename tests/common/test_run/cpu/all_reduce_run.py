@@ -0,0 +1,98 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import os
+import subprocess
+import sys
+import tempfile
+import akg
+import numpy as np
+from akg.utils import kernel_exec as utils
+from akg.utils.format_transform import to_tvm_nd_array
+from akg.utils.result_analysis import target_profiling
+
+support_list = {"float32": np.float32, "float16": np.float16}
+
+
+def all_reduce(data, kind):
+    axis = list(range(len(data.shape)))
+    if kind == "sum":
+        return akg.topi.sum(data, axis=axis, keepdims=True)
+    square = akg.tvm.compute(data.shape, lambda *i: data(*i) * data(*i), name="square")
+    square_sum = akg.topi.sum(square, axis=axis, keepdims=True)
+    return akg.tvm.compute(square_sum.shape, lambda *i: akg.tvm.sqrt(square_sum(*i)), name="norm")
+
+
+def build_all_reduce(shape, dtype, kind, poly_sch, attrs):
+    attrs = dict(attrs)
+    attrs["target"] = attrs.get("target", "llvm")
+    return utils.op_build_test(all_reduce, (shape,), (dtype,), op_attrs=[kind], attrs=attrs,
+                               kernel_name="all_reduce_" + kind, polyhedral=poly_sch)
+
+
+def launch_saved(shape, dtype, kind, poly_sch, attrs, data_file, output_file):
+    """Builds and launches the kernel on saved data, run in a child process with its own AKG_NUM_THREADS"""
+    mod = build_all_reduce(shape, dtype, kind, poly_sch, attrs)
+    data = np.load(data_file)
+    output = np.full([1] * len(shape), np.nan, dtype)
+    np.save(output_file, utils.mod_launch(mod, (data, output)))
+
+
+def launch_with_threads(num_threads, shape, dtype, kind, poly_sch, attrs, data_file, tmp_dir):
+    output_file = os.path.join(tmp_dir, "output_{}.npy".format(num_threads))
+    script = ("from tests.common.test_run.cpu.all_reduce_run import launch_saved\n"
+              "launch_saved({!r}, {!r}, {!r}, {!r}, {!r}, {!r}, {!r})\n").format(
+                  tuple(shape), dtype, kind, poly_sch, attrs, data_file, output_file)
+    env = dict(os.environ, AKG_NUM_THREADS=str(num_threads))
+    subprocess.run([sys.executable, "-c", script], env=env, check=True)
+    return np.load(output_file)
+
+
+def all_reduce_run(shape, dtype="float32", kind="sum", thread_nums=(1, 4), poly_sch=True, attrs=None):
+    """
+    Sum or l2 norm of every element of a large tensor. Checks the result against a float64 reference, checks that it
+    is bit-identical under each count of runtime threads. With profiling, reports the achieved bandwidth.
+    """
+    attrs = {} if attrs is None else attrs
+    mod = build_all_reduce(shape, dtype, kind, poly_sch, attrs)
+
+    data = np.random.uniform(-1.0, 1.0, size=shape).astype(support_list[dtype])
+    data64 = data.astype(np.float64)
+    expect = np.sum(data64) if kind == "sum" else np.sqrt(np.sum(data64 * data64))
+    expect = np.full([1] * len(shape), expect)
+    output = np.full([1] * len(shape), np.nan, dtype)
+    output = utils.mod_launch(mod, (data, output), expect=expect)
+    if kind == "sum":
+        # the summands cancel, bound the error by their magnitude rather than by the small result
+        tolerance = np.finfo(np.float32).eps * np.sum(np.abs(data64))
+        res = bool(np.all(np.abs(output.astype(np.float64) - expect) <= tolerance))
+    else:
+        res = np.allclose(output, expect, rtol=1e-4, atol=0)
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        data_file = os.path.join(tmp_dir, "data.npy")
+        np.save(data_file, data)
+        for num_threads in thread_nums:
+            thread_output = launch_with_threads(num_threads, shape, dtype, kind, poly_sch, attrs, data_file, tmp_dir)
+            same = thread_output.tobytes() == output.tobytes()
+            print("{} threads: {}".format(num_threads, "bit-identical" if same else "differs"))
+            res = res and same
+
+    if attrs.get("profiling", False):
+        target_name = attrs.get("target", "llvm").split()[0]
+        args = to_tvm_nd_array([data, output], akg.tvm.context(target_name, 0))
+        tcost = target_profiling(mod, *args, target=target_name, repeat_time=attrs["repeat_times"])
+        print("all reduce {} of {} {}: bandwidth={:.2f} GB/s".format(kind, data.size, dtype, data.nbytes / tcost / 1e9))
+    if not res:
+        raise AssertionError("Test fail")
+    return data, output, expect, res
@@ -0,0 +1,121 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import time
+import akg
+import numpy as np
+from akg.ops.math import add
+from akg.utils import kernel_exec as utils
+from akg.utils.format_transform import to_tvm_nd_array
+from tests.common.gen_random import random_gaussian
+
+support_list = {"float32": np.float32, "float16": np.float16}
+
+
+class LaunchStreams(object):
+    """The launch streams of the cpu runtime, a call returns at once and the calls of one stream run in order"""
+
+    def __init__(self, num_streams):
+        self._create = akg.tvm.get_global_func("akg.runtime.CreateLaunchStream")
+        self._destroy = akg.tvm.get_global_func("akg.runtime.DestroyLaunchStream")
+        self._launch = akg.tvm.get_global_func("akg.runtime.LaunchAsync")
+        self._wait_launch = akg.tvm.get_global_func("akg.runtime.StreamWaitLaunch")
+        self._wait = akg.tvm.get_global_func("akg.runtime.WaitLaunch")
+        self.streams = [self._create() for _ in range(num_streams)]
+
+    def launch(self, stream_id, func, *args):
+        return self._launch(self.streams[stream_id], func, *args)
+
+    def depend(self, stream_id, event):
+        """Later calls on the stream start after the call of event"""
+        self._wait_launch(self.streams[stream_id], event)
+
+    def wait(self, event):
+        return self._wait(event)
+
+    def destroy(self):
+        for stream in self.streams:
+            self._destroy(stream)
+        self.streams = []
+
+
+def check_chain(func, streams, ctx, shape, dtype):
+    """c = a + b on stream 0, then d = c + b on stream 1 once the first call is done"""
+    input1 = random_gaussian(shape, miu=1, sigma=0.1).astype(support_list[dtype])
+    input2 = random_gaussian(shape, miu=1, sigma=0.1).astype(support_list[dtype])
+    a, b, c, d = to_tvm_nd_array([input1, input2, np.full(shape, np.nan, dtype), np.full(shape, np.nan, dtype)], ctx)
+    first = streams.launch(0, func, a, b, c)
+    streams.depend(1, first)
+    second = streams.launch(1, func, c, b, d)
+    ok = streams.wait(second) == 0 and streams.wait(first) == 0
+    expect = input1 + input2 + input2
+    return ok and np.allclose(d.asnumpy(), expect, rtol=1e-3, atol=1e-3)
+
+
+def async_launch_run(shape, dtype="float32", num_kernels=8, num_streams=4, rounds=100, poly_sch=True, attrs=None):
+    """
+    Runs num_kernels independent small adds, serially with blocking calls and concurrently on num_streams launch
+    streams, checks the results and a dependency between two streams, and reports the throughput of both.
+    """
+    attrs = {} if attrs is None else attrs
+    attrs["target"] = attrs.get("target", "llvm")
+    mod = utils.op_build_test(add, (shape, shape), (dtype, dtype), op_attrs=[1.0], attrs=attrs,
+                              kernel_name="async_launch", polyhedral=poly_sch)
+    func = mod.get_function(mod.entry_name)
+    ctx = akg.tvm.context("cpu", 0)
+
+    inputs, outputs, expects = [], [], []
+    for _ in range(num_kernels):
+        input1 = random_gaussian(shape, miu=1, sigma=0.1).astype(support_list[dtype])
+        input2 = random_gaussian(shape, miu=1, sigma=0.1).astype(support_list[dtype])
+        inputs.append(to_tvm_nd_array([input1, input2], ctx))
+        outputs.append(to_tvm_nd_array([np.full(shape, np.nan, dtype)], ctx)[0])
+        expects.append(np.add(input1, input2))
+
+    def serial():
+        for k in range(num_kernels):
+            func(inputs[k][0], inputs[k][1], outputs[k])
+
+    streams = LaunchStreams(num_streams)
+
+    def concurrent():
+        events = [streams.launch(k % num_streams, func, inputs[k][0], inputs[k][1], outputs[k])
+                  for k in range(num_kernels)]
+        return all(streams.wait(event) == 0 for event in events)
+
+    try:
+        res = concurrent()
+        res = res and all(np.allclose(out.asnumpy(), expect, rtol=1e-4, atol=1e-4)
+                          for out, expect in zip(outputs, expects))
+        res = res and check_chain(func, streams, ctx, shape, dtype)
+
+        serial()
+        start = time.perf_counter()
+        for _ in range(rounds):
+            serial()
+        serial_cost = time.perf_counter() - start
+        concurrent()
+        start = time.perf_counter()
+        for _ in range(rounds):
+            res = concurrent() and res
+        concurrent_cost = time.perf_counter() - start
+    finally:
+        streams.destroy()
+
+    launches = rounds * num_kernels
+    print("{} kernels of {} {}: serial {:.0f} kernels/s, {} streams {:.0f} kernels/s, speedup {:.2f}x".format(
+        num_kernels, shape, dtype, launches / serial_cost, num_streams, launches / concurrent_cost,
+        serial_cost / concurrent_cost))
+    if not res:
+        raise AssertionError("Test fail")
+    return inputs, outputs, expects, res
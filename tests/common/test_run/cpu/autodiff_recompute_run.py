@@ -0,0 +1,72 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import akg
+import numpy as np
+from akg.utils import kernel_exec as utils
+from tests.common.gen_random import random_gaussian
+
+
+def square_square_forward(data):
+    square = akg.tvm.compute(data.shape, lambda *i: data(*i) * data(*i), name="square")
+    return akg.tvm.compute(data.shape, lambda *i: square(*i) * square(*i), name="square_square")
+
+
+def square_square_ad(head, data, recompute=0):
+    """Gradient of (x * x) ** 2, whose adjoint reads back the forward tensor x * x."""
+    output = square_square_forward(data)
+    return list(akg.differentiate(output, [data], head, ad_attrs={"recompute": recompute}))[0]
+
+
+def check_recompute_stats(shape, dtype):
+    head = akg.tvm.placeholder(shape, name="head", dtype=dtype)
+    data = akg.tvm.placeholder(shape, name="data", dtype=dtype)
+    output = square_square_forward(data)
+    res = akg.differentiate(output, [data], head, ad_attrs={"recompute": 1})
+    stats = res.recompute_stats
+    if "recomputed" not in stats or "saved_bytes" not in stats:
+        return False
+    recomputed = [t.op.name for t in stats["recomputed"]]
+    elems = 1
+    for dim in shape:
+        elems *= dim
+    expect_bytes = elems * np.dtype(dtype).itemsize
+    return "square" in recomputed and stats["saved_bytes"].value >= expect_bytes
+
+
+def autodiff_recompute_run(shape, dtype, attrs=None):
+    attrs = {} if attrs is None else attrs
+    attrs["target"] = attrs.get("target", "llvm")
+    shapes = [shape, shape]
+    dtypes = [dtype, dtype]
+    mod = utils.op_build_test(square_square_ad, shapes, dtypes, op_attrs=[0], attrs=attrs,
+                              kernel_name="square_square_ad")
+    mod_recompute = utils.op_build_test(square_square_ad, shapes, dtypes, op_attrs=[1], attrs=attrs,
+                                        kernel_name="square_square_ad_recompute")
+
+    head = random_gaussian(shape, miu=1, sigma=0.1).astype(dtype)
+    data = random_gaussian(shape, miu=1, sigma=0.1).astype(dtype)
+    expect = head * 4 * data ** 3
+    output = utils.mod_launch(mod, (head, data, np.full(shape, np.nan, dtype)), expect=expect)
+    output_recompute = utils.mod_launch(mod_recompute, (head, data, np.full(shape, np.nan, dtype)), expect=expect)
+
+    res = np.allclose(output, expect, rtol=1e-4, atol=1e-4)
+    # recomputation only moves where x * x is evaluated, the gradients stay the same up to fma contraction
+    res = res and np.allclose(output, output_recompute, rtol=1e-6, atol=0)
+    res = res and check_recompute_stats(shape, dtype)
+    print("Test {}".format("Pass" if res else "Fail"))
+    if not res:
+        print("Error llvm:========================")
+        print(mod_recompute.get_source())
+        raise AssertionError("Test fail")
+    return (head, data), output_recompute, expect, res
@@ -0,0 +1,76 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import akg
+import numpy as np
+from akg.ops.math.gpu import BatchMatMul
+from akg.utils import kernel_exec as utils
+from akg.utils.format_transform import to_tvm_nd_array
+from akg.utils.result_analysis import target_profiling
+from tests.common.gen_random import random_gaussian
+from tests.common.test_run.batch_matmul_run import gen_data, check_gemm_epilogue_fused
+
+LAYOUT = "NHDT"
+
+
+def batch_matmul_epilogue_run(shape1, shape2, shape_bias, epilogue, dtype="float32", poly_sch=True, attrs=None):
+    """
+    Runs a cpu batch_matmul with a bias-add followed by a relu, a residual-add or a cast to float16, and checks that
+    the epilogue is applied to C in the gemm.
+    """
+    attrs = {} if attrs is None else attrs
+    attrs["target"] = attrs.get("target", "llvm")
+    attrs["pragma_enable_matmul"] = attrs.get("pragma_enable_matmul", True)
+    attrs["feature"] = attrs.get("feature", "avx")
+    target_name = attrs["target"].split()[0]
+
+    def batch_matmul_epilogue(x, y, bias, *residual):
+        res = BatchMatMul(x, y, bias, dtype, LAYOUT, LAYOUT, LAYOUT, False, True)
+        if epilogue == "relu":
+            return akg.tvm.compute(res.shape, lambda *i: akg.tvm.max(res(*i), akg.tvm.const(0, res.dtype)),
+                                   name="relu")
+        if epilogue == "residual":
+            return akg.tvm.compute(res.shape, lambda *i: res(*i) + residual[0](*i), name="residual_add")
+        return akg.tvm.compute(res.shape, lambda *i: res(*i).astype("float16"), name="cast")
+
+    lhs, rhs, bias, _, expect = gen_data(shape1, shape2, dtype, dtype, LAYOUT, LAYOUT, LAYOUT, shape_bias, False)
+    inputs = [lhs, rhs, bias]
+    shapes = [shape1, shape2, shape_bias]
+    if epilogue == "relu":
+        # about half of C + bias is negative
+        inputs[2] = (bias - np.mean(expect)).astype(bias.dtype)
+        expect = np.maximum(expect + inputs[2], 0)
+    elif epilogue == "residual":
+        residual = random_gaussian(expect.shape, miu=1, sigma=0.1).astype(expect.dtype)
+        inputs.append(residual)
+        shapes.append(expect.shape)
+        expect = expect + bias + residual
+    else:
+        expect = (expect + bias).astype(np.float16)
+
+    mod = utils.op_build_test(batch_matmul_epilogue, shapes, [dtype] * len(shapes), attrs=attrs,
+                              kernel_name="batch_matmul_" + epilogue, polyhedral=poly_sch)
+    output = np.full(expect.shape, np.nan, expect.dtype)
+    output = utils.mod_launch(mod, tuple(inputs) + (output,), expect=expect)
+    res = np.allclose(output, expect, rtol=5e-03, atol=1.e-8)
+    if res:
+        res = check_gemm_epilogue_fused(mod, batch_matmul_epilogue, shapes, [dtype] * len(shapes), None, attrs,
+                                        poly_sch, inputs, output)
+    print("Test {}".format("Pass" if res else "Fail"))
+    if not res:
+        raise AssertionError("Test fail")
+
+    if attrs.get("profiling", False):
+        args = to_tvm_nd_array(inputs + [output], akg.tvm.context(target_name, 0))
+        target_profiling(mod, *args, target=target_name, repeat_time=attrs["repeat_times"])
+    return tuple(inputs), output, expect, res
@@ -1,4 +1,8 @@
+import akg
 import numpy as np
+from akg.utils import kernel_exec as utils
+from akg.utils.format_transform import to_tvm_nd_array
+from akg.utils.result_analysis import target_profiling
 
 
 def unpack_nchwc_to_nchw_python(data, dtype):
@@ -45,4 +49,54 @@ def pack_nchw_to_nchwc_python(data, c_inner, dtype):
                     for cc_in in range(target_shape[4]):
                         packed_res[nn][cc_out][hh][ww][cc_in] = data[nn][cc_out * c_inner + cc_in][hh][ww]
 
-    return packed_res
\ No newline at end of file
+    return packed_res
+
+
+def cpu_has_flag(flag):
+    """Whether the host cpu reports flag in /proc/cpuinfo"""
+    try:
+        with open("/proc/cpuinfo") as cpuinfo:
+            for line in cpuinfo:
+                if line.startswith("flags"):
+                    return flag in line.split()
+    except IOError:
+        pass
+    return False
+
+
+def run_with_attr_toggle(op, shapes, dtypes, inputs, expect, toggle, kernel_name, attrs, compare, op_attrs=None,
+                         poly_sch=True, check=None):
+    """
+    Builds op with the bool attr toggle off and then on and runs both builds on inputs.
+
+    compare(output, expect) checks each output. check(mod, build_attrs, enabled), when given, raises unless the build
+    has the feature of toggle exactly when it is enabled. With profiling, reports the time of both builds and the
+    speedup of the toggle.
+
+    Returns the output of the enabled build, whether both outputs compare equal and the times by enabled, which are
+    empty without profiling.
+    """
+    target_name = attrs["target"].split()[0]
+    fill = np.nan if np.issubdtype(expect.dtype, np.floating) else 0
+    res = True
+    tcost = {}
+    output = None
+    for enabled in (False, True):
+        build_attrs = dict(attrs)
+        build_attrs[toggle] = enabled
+        mod = utils.op_build_test(op, shapes, dtypes, op_attrs=op_attrs, attrs=build_attrs,
+                                  kernel_name="{}_{}".format(kernel_name, "on" if enabled else "off"),
+                                  polyhedral=poly_sch)
+        if check is not None:
+            check(mod, build_attrs, enabled)
+        output = np.full(expect.shape, fill, expect.dtype)
+        output = utils.mod_launch(mod, tuple(inputs) + (output,), expect=expect)
+        res = res and compare(output, expect)
+
+        if attrs.get("profiling", False):
+            args = to_tvm_nd_array(list(inputs) + [output], akg.tvm.context(target_name, 0))
+            tcost[enabled] = target_profiling(mod, *args, target=target_name, repeat_time=attrs["repeat_times"])
+    if tcost:
+        print("{} with {} off={:.3f} ms, on={:.3f} ms, speedup={:.2f}x".format(
+            kernel_name, toggle, tcost[False] * 1e3, tcost[True] * 1e3, tcost[False] / tcost[True]))
+    return output, res, tcost
@@ -0,0 +1,60 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import akg
+import numpy as np
+from akg.ops.math import add
+from akg.utils import kernel_exec as utils
+from akg.utils.format_transform import to_tvm_nd_array
+from akg.utils.result_analysis import target_profiling
+from tests.common.gen_random import random_gaussian
+
+support_list = {"float32": np.float32, "float16": np.float16}
+affinity_policies = ("none", "compact", "scatter", "numa")
+
+
+def gen_data(shape, dtype):
+    input1 = random_gaussian(shape, miu=1, sigma=0.1).astype(support_list[dtype])
+    input2 = random_gaussian(shape, miu=1, sigma=0.1).astype(support_list[dtype])
+    expect = np.add(input1, input2)
+    output = np.full(shape, np.nan, dtype)
+    return input1, input2, output, expect
+
+
+def elemwise_bandwidth_run(shape, dtype="float32", poly_sch=True, attrs=None):
+    """
+    Streams a large add through memory. With profiling, reports the bandwidth achieved under every thread affinity
+    policy of the cpu runtime, counting two reads and one write per element.
+    """
+    attrs = {} if attrs is None else attrs
+    attrs["target"] = attrs.get("target", "llvm")
+    mod = utils.op_build_test(add, (shape, shape), (dtype, dtype), op_attrs=[1.0], attrs=attrs,
+                              kernel_name="elemwise_bandwidth", polyhedral=poly_sch)
+
+    input1, input2, output, expect = gen_data(shape, dtype)
+    output = utils.mod_launch(mod, (input1, input2, output), expect=expect)
+    res = np.allclose(output, expect, rtol=1e-4, atol=1e-4)
+    if not res:
+        raise AssertionError("Test fail")
+
+    if attrs.get("profiling", False):
+        target_name = attrs["target"].split()[0]
+        set_affinity = akg.tvm.get_global_func("akg.runtime.SetThreadAffinity")
+        args = to_tvm_nd_array([input1, input2, output], akg.tvm.context(target_name, 0))
+        moved_bytes = 3 * expect.nbytes
+        for policy in attrs.get("affinity_policies", affinity_policies):
+            set_affinity(policy)
+            tcost = target_profiling(mod, *args, target=target_name, repeat_time=attrs["repeat_times"])
+            print("affinity={}: bandwidth={:.2f} GB/s".format(policy, moved_bytes / tcost / 1e9))
+        set_affinity("none")
+    return (input1, input2), output, expect, res
@@ -0,0 +1,99 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import akg
+import numpy as np
+from tests.common.gen_random import random_gaussian
+from tests.common.test_run.cpu.cpu_test_utils import run_with_attr_toggle
+
+support_list = {"float32": np.float32, "float16": np.float16}
+EPSILON = 1e-5
+
+
+def bias_add(data, bias):
+    return akg.tvm.compute(data.shape, lambda i, j: data[i, j] + bias[j], name="bias_add")
+
+
+def softmax(data):
+    rows, cols = data.shape
+    k = akg.tvm.reduce_axis((0, cols), name="k")
+    row_max = akg.tvm.compute((rows,), lambda i: akg.tvm.max(data[i, k], axis=k), name="row_max")
+    exp = akg.tvm.compute(data.shape, lambda i, j: akg.tvm.exp(data[i, j] - row_max[i]), name="exp")
+    r = akg.tvm.reduce_axis((0, cols), name="r")
+    row_sum = akg.tvm.compute((rows,), lambda i: akg.tvm.sum(exp[i, r], axis=r), name="row_sum")
+    return akg.tvm.compute(data.shape, lambda i, j: exp[i, j] / row_sum[i], name="softmax")
+
+
+def layer_norm(data, gamma, beta):
+    rows, cols = data.shape
+    k = akg.tvm.reduce_axis((0, cols), name="k")
+    mean = akg.tvm.compute((rows,), lambda i: akg.tvm.sum(data[i, k] / cols, axis=k), name="mean")
+    r = akg.tvm.reduce_axis((0, cols), name="r")
+    var = akg.tvm.compute((rows,), lambda i: akg.tvm.sum((data[i, r] - mean[i]) * (data[i, r] - mean[i]) / cols,
+                                                          axis=r), name="var")
+    return akg.tvm.compute(
+        data.shape, lambda i, j: (data[i, j] - mean[i]) / akg.tvm.sqrt(var[i] + akg.tvm.const(EPSILON, data.dtype)) *
+        gamma[j] + beta[j], name="layer_norm")
+
+
+def np_softmax(data):
+    exp = np.exp(data - np.max(data, axis=-1, keepdims=True))
+    return exp / np.sum(exp, axis=-1, keepdims=True)
+
+
+def np_layer_norm(data, gamma, beta):
+    mean = np.mean(data, axis=-1, keepdims=True)
+    var = np.var(data, axis=-1, keepdims=True)
+    return (data - mean) / np.sqrt(var + EPSILON) * gamma + beta
+
+
+# kernel, input shapes from the (rows, cols) shape, reference
+fused_kernels = {
+    "bias_add": (bias_add, lambda s: [s, s[-1:]], lambda x, b: x + b),
+    "softmax": (softmax, lambda s: [s], np_softmax),
+    "layer_norm": (layer_norm, lambda s: [s, s[-1:], s[-1:]], np_layer_norm),
+}
+
+
+def check_local_promotion(op, shapes, dtype, poly_sch, build_attrs, enabled):
+    """The promoted tensors get a local copy, which the lowered ir names with a _local suffix."""
+    placeholders = [akg.tvm.placeholder(s, dtype, "input_{}".format(i)) for i, s in enumerate(shapes)]
+    out = op(*placeholders)
+    sch = akg.tvm.create_schedule(out.op)
+    stmt = akg.lower(sch, placeholders + [out], attrs=build_attrs, simple_mode=True, polyhedral=poly_sch,
+                     target=build_attrs["target"].split()[0])
+    if ("_local" in str(stmt)) != enabled:
+        raise AssertionError("{} with enable_cpu_local_promotion={}: local buffer {} in the lowered ir".format(
+            out.op.name, enabled, "missing" if enabled else "found"))
+
+
+def fused_reduce_broadcast_run(kernel, shape, dtype="float32", poly_sch=True, attrs=None):
+    """
+    Runs a fused reduce and broadcast kernel with and without the local promotion of the cpu memory manager. With
+    profiling, reports the time of both. A promoted reduce keeps one scalar accumulator per row, not one per vector
+    lane, so the reduce kernels gain from the single write-back only.
+    """
+    attrs = {} if attrs is None else attrs
+    attrs["target"] = attrs.get("target", "llvm")
+    op, get_shapes, ref = fused_kernels[kernel]
+    shapes = [tuple(s) for s in get_shapes(tuple(shape))]
+    inputs = [random_gaussian(s, miu=1, sigma=0.1).astype(support_list[dtype]) for s in shapes]
+    expect = ref(*inputs)
+
+    output, res, _ = run_with_attr_toggle(
+        op, shapes, [dtype] * len(shapes), inputs, expect, "enable_cpu_local_promotion", kernel, attrs,
+        lambda out, exp: np.allclose(out, exp, rtol=1e-3, atol=1e-3), poly_sch=poly_sch,
+        check=lambda _, build_attrs, enabled: check_local_promotion(op, shapes, dtype, poly_sch, build_attrs, enabled))
+    if not res:
+        raise AssertionError("Test fail")
+    return tuple(inputs), output, expect, res
@@ -0,0 +1,119 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import numpy as np
+from akg.ops.nn.cpu import quantized_matmul, quantized_conv2d_nchwc
+from akg.ops.nn.cpu.quantize import QUANTIZED_RANGE
+from tests.common.test_run.cpu.cpu_test_utils import run_with_attr_toggle
+
+# the llvm cpu that has the int8 dot product of each feature
+feature_targets = {
+    "avx2": "llvm -mcpu=core-avx2",
+    "avx512": "llvm -mcpu=skylake-avx512",
+    "avx512vnni": "llvm -mcpu=cascadelake",
+}
+# vpdpbusd, and the vpmaddwd of the widening sequences
+DOT_INTRINSICS = ("@llvm.x86.avx512.vpdpbusd", "@llvm.x86.avx512.pmaddw.d", "@llvm.x86.avx2.pmadd.wd")
+
+
+def gen_quantized_data(data_shape, weight_shape):
+    # the full uint8 and int8 ranges, the dot products of every feature are exact
+    data = np.random.randint(0, 256, size=data_shape).astype(np.uint8)
+    weight = np.random.randint(-128, 128, size=weight_shape).astype(np.int8)
+    return data, weight
+
+
+def requantize_np(acc, scale, zero_point, out_dtype):
+    if out_dtype == "int32":
+        return acc
+    q_min, q_max = QUANTIZED_RANGE[out_dtype]
+    return np.clip(np.round(acc.astype(np.float32) * scale) + zero_point, q_min, q_max).astype(out_dtype)
+
+
+def conv2d_nchwc_np(data, weight, stride, pad, dilation):
+    pad_top, pad_bottom, pad_left, pad_right = pad
+    s_h, s_w = stride
+    d_h, d_w = dilation
+    data = np.pad(data.astype(np.int32), ((0, 0), (0, 0), (pad_top, pad_bottom), (pad_left, pad_right), (0, 0)))
+    _, _, i_h, i_w, _ = data.shape
+    oc_outer, _, k_h, k_w, _, oc_inner = weight.shape
+    o_h = (i_h - (k_h - 1) * d_h - 1) // s_h + 1
+    o_w = (i_w - (k_w - 1) * d_w - 1) // s_w + 1
+    out = np.zeros((data.shape[0], oc_outer, o_h, o_w, oc_inner), np.int32)
+    for kh in range(k_h):
+        for kw in range(k_w):
+            patch = data[:, :, kh * d_h: kh * d_h + o_h * s_h: s_h, kw * d_w: kw * d_w + o_w * s_w: s_w, :]
+            out += np.einsum("ncyxi,ocip->noyxp", patch, weight[:, :, kh, kw].astype(np.int32))
+    return out
+
+
+def check_int8_dot(name, mod, enabled):
+    """The dot product of every feature calls an x86 intrinsic, which the plain widening multiply never does."""
+    source = mod.get_source()
+    found = [intrin for intrin in DOT_INTRINSICS if intrin in source]
+    if bool(found) != enabled:
+        raise AssertionError("{} with enable_cpu_int8_dot={}: {} in the llvm source".format(
+            name, enabled, "found " + ", ".join(found) if found else "no dot product intrinsic"))
+
+
+def build_and_compare(op, shapes, dtypes, op_attrs, inputs, expect, out_dtype, name, poly_sch, attrs):
+    """Builds with the int8 dot product on and off and checks both. With profiling, reports the speedup of the dot
+    product"""
+    # round half away from zero in the kernel, to even in numpy
+    atol = 0 if out_dtype == "int32" else 1
+    output, res, _ = run_with_attr_toggle(
+        op, shapes, dtypes, inputs, expect, "enable_cpu_int8_dot", name, attrs,
+        lambda out, exp: np.allclose(out.astype(np.int64), exp.astype(np.int64), rtol=0, atol=atol),
+        op_attrs=op_attrs, poly_sch=poly_sch, check=lambda mod, _, enabled: check_int8_dot(name, mod, enabled))
+    return output, res
+
+
+def quantized_matmul_run(shape_data, shape_weight, out_dtype="int32", feature="avx2", poly_sch=True, attrs=None):
+    """uint8 x int8 matmul, requantized to out_dtype when it is 8 bits"""
+    attrs = {} if attrs is None else attrs
+    attrs["feature"] = attrs.get("feature", feature)
+    attrs["target"] = attrs.get("target", feature_targets[feature])
+    attrs["pragma_enable_matmul"] = True
+    scale, zero_point = 0.0005, 64
+    data, weight = gen_quantized_data(shape_data, shape_weight)
+    acc = np.matmul(data.astype(np.int32), weight.astype(np.int32))
+    expect = requantize_np(acc, scale, zero_point, out_dtype)
+
+    op_attrs = [scale, zero_point, out_dtype]
+    output, res = build_and_compare(quantized_matmul, [shape_data, shape_weight], ["uint8", "int8"], op_attrs,
+                                    (data, weight), expect, out_dtype, "quantized_matmul_" + feature, poly_sch,
+                                    attrs)
+    if not res:
+        raise AssertionError("Test fail")
+    return (data, weight), output, expect, res
+
+
+def quantized_conv2d_run(shape_data, shape_weight, stride=(1, 1), padding=(0, 0, 0, 0), dilation=(1, 1),
+                         out_dtype="int32", feature="avx2", poly_sch=True, attrs=None):
+    """uint8 NCHWc x int8 KCRSxy conv2d, requantized to out_dtype when it is 8 bits"""
+    attrs = {} if attrs is None else attrs
+    attrs.update({"enable_auto_fuse": False, "pragma_enable_conv2d_direct": True, "polytops_enable_skewing": False})
+    attrs["feature"] = attrs.get("feature", feature)
+    attrs["target"] = attrs.get("target", feature_targets[feature])
+    scale, zero_point = 0.001, 0
+    data, weight = gen_quantized_data(shape_data, shape_weight)
+    acc = conv2d_nchwc_np(data, weight, stride, padding, dilation)
+    expect = requantize_np(acc, scale, zero_point, out_dtype)
+
+    op_attrs = [stride, padding, dilation, scale, zero_point, out_dtype]
+    output, res = build_and_compare(quantized_conv2d_nchwc, [shape_data, shape_weight], ["uint8", "int8"], op_attrs,
+                                    (data, weight), expect, out_dtype, "quantized_conv2d_" + feature, poly_sch,
+                                    attrs)
+    if not res:
+        raise AssertionError("Test fail")
+    return (data, weight), output, expect, res
@@ -0,0 +1,56 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import akg
+import numpy as np
+from akg.utils import kernel_exec as utils
+from tests.common.gen_random import random_gaussian
+
+
+def add_relu(data1, data2):
+    return akg.tvm.compute(data1.shape, lambda *i: akg.tvm.max(data1(*i) + data2(*i), akg.tvm.const(0, data1.dtype)),
+                           name="add_relu")
+
+
+def shape_bucket_run(cols, buckets, run_rows, dtype, attrs=None):
+    """Build add_relu over (rows, cols) with shape buckets bounding rows and run it for each of run_rows."""
+    attrs = {} if attrs is None else attrs
+    target = attrs.get("target", "llvm")
+    rows = akg.tvm.var("rows")
+    data1 = akg.tvm.placeholder((rows, cols), dtype, "input_1")
+    data2 = akg.tvm.placeholder((rows, cols), dtype, "input_2")
+    output = add_relu(data1, data2)
+    s = akg.tvm.create_schedule(output.op)
+    build_attrs = {k: v for k, v in attrs.items() if k not in ("target", "profiling", "repeat_times")}
+    mod = akg.build_shape_buckets(s, [data1, data2, output], buckets, [rows], target=target,
+                                  name="shape_bucket_add_relu", attrs=build_attrs)
+
+    res = True
+    inputs, outputs, expects = [], [], []
+    for row in run_rows:
+        shape = (row, cols)
+        lhs = random_gaussian(shape, miu=0, sigma=1).astype(dtype)
+        rhs = random_gaussian(shape, miu=0, sigma=1).astype(dtype)
+        expect = np.maximum(lhs + rhs, 0)
+        out = utils.mod_launch(mod, (lhs, rhs, np.full(shape, np.nan, dtype)), expect=expect)
+        # a bucket variant and the symbolic kernel must agree with numpy alike
+        res = res and np.allclose(out, expect, rtol=1e-5, atol=1e-6)
+        inputs.append((lhs, rhs))
+        outputs.append(out)
+        expects.append(expect)
+    print("Test {}".format("Pass" if res else "Fail"))
+    if not res:
+        print("Error llvm:========================")
+        print(mod.get_source())
+        raise AssertionError("Test fail")
+    return inputs, outputs, expects, res
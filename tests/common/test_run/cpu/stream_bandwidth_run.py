@@ -0,0 +1,80 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import akg
+import numpy as np
+from tests.common.gen_random import random_gaussian
+from tests.common.test_run.cpu.cpu_test_utils import run_with_attr_toggle
+
+support_list = {"float32": np.float32, "float16": np.float16}
+SCALAR = 3.0
+
+
+def stream_copy(a):
+    return akg.tvm.compute(a.shape, lambda *i: a(*i), name="stream_copy")
+
+
+def stream_scale(a):
+    return akg.tvm.compute(a.shape, lambda *i: a(*i) * akg.tvm.const(SCALAR, a.dtype), name="stream_scale")
+
+
+def stream_add(a, b):
+    return akg.tvm.compute(a.shape, lambda *i: a(*i) + b(*i), name="stream_add")
+
+
+def stream_triad(a, b):
+    return akg.tvm.compute(a.shape, lambda *i: a(*i) + b(*i) * akg.tvm.const(SCALAR, a.dtype), name="stream_triad")
+
+
+# kernel, number of inputs, reference
+stream_kernels = {
+    "copy": (stream_copy, 1, lambda a: a),
+    "scale": (stream_scale, 1, lambda a: a * SCALAR),
+    "add": (stream_add, 2, np.add),
+    "triad": (stream_triad, 2, lambda a, b: a + b * SCALAR),
+}
+
+
+def check_stream_hints(name, mod, enabled):
+    """The outputs are far beyond the thresholds of the pass, so a hinted kernel has both hints."""
+    source = mod.get_source()
+    for hint in ("!nontemporal", "@llvm.prefetch"):
+        if (hint in source) != enabled:
+            raise AssertionError("stream_{} with enable_cpu_stream_hint={}: {} {} in the llvm source".format(
+                name, enabled, hint, "missing" if enabled else "found"))
+
+
+def stream_bandwidth_run(shape, dtype="float32", poly_sch=True, attrs=None):
+    """
+    Runs the STREAM kernels on large tensors with and without the cpu prefetch and non-temporal store hints. With
+    profiling, reports the achieved bandwidth of each, counting every array read or written once as STREAM does.
+    """
+    attrs = {} if attrs is None else attrs
+    attrs["target"] = attrs.get("target", "llvm")
+    inputs = [random_gaussian(shape, miu=1, sigma=0.1).astype(support_list[dtype]) for _ in range(2)]
+    res = True
+    for name in attrs.get("stream_kernels", stream_kernels.keys()):
+        op, input_num, ref = stream_kernels[name]
+        expect = ref(*inputs[:input_num])
+        moved_bytes = (input_num + 1) * expect.nbytes
+        output, kernel_res, tcost = run_with_attr_toggle(
+            op, [shape] * input_num, [dtype] * input_num, inputs[:input_num], expect, "enable_cpu_stream_hint",
+            "stream_" + name, attrs, lambda out, exp: np.allclose(out, exp, rtol=1e-4, atol=1e-4), poly_sch=poly_sch,
+            check=lambda mod, _, enabled: check_stream_hints(name, mod, enabled))
+        res = res and kernel_res
+        if tcost:
+            print("{}: base={:.2f} GB/s, hint={:.2f} GB/s".format(
+                name, moved_bytes / tcost[False] / 1e9, moved_bytes / tcost[True] / 1e9))
+    if not res:
+        raise AssertionError("Test fail")
+    return tuple(inputs), output, expect, res
@@ -0,0 +1,86 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import math
+import akg
+import numpy as np
+from akg.utils import kernel_exec as utils
+from akg.utils.format_transform import to_tvm_nd_array
+from akg.utils.result_analysis import target_profiling
+
+support_list = {"float32": np.float32, "float16": np.float16}
+
+# func: (reference, input range, magnitude below which the error is counted in ulp of that magnitude,
+#        max ulp in precise mode, max ulp in fast mode)
+math_funcs = {
+    # up to the largest float32 argument with a finite result
+    "exp": (np.exp, (-87.0, 88.72), 0.0, 2, 2048),
+    "log": (np.log, (1e-3, 1e4), 0.0, 4, 4),
+    "tanh": (np.tanh, (-10.0, 10.0), 0.0, 4, 8),
+    "sigmoid": (lambda x: 1.0 / (1.0 + np.exp(-x)), (-20.0, 20.0), 0.0, 4, 2048),
+    "erf": (np.vectorize(math.erf), (-5.0, 5.0), 0.0, 4, 4),
+    "rsqrt": (lambda x: 1.0 / np.sqrt(x), (1e-3, 1e4), 0.0, 2, 128),
+    # the reduction is accurate to the ulp of 1, not of the result near the zeros
+    "sin": (np.sin, (-100.0, 100.0), 1.0, 4, 4),
+    "cos": (np.cos, (-100.0, 100.0), 1.0, 4, 4),
+}
+
+
+def unary_math(data, func_name):
+    func = getattr(akg.tvm, func_name)
+    return akg.tvm.compute(data.shape, lambda *i: func(data(*i)), name=func_name)
+
+
+def max_ulp_error(output, expect, floor):
+    """The largest error of the float32 output in units in the last place of the float64 expect"""
+    magnitude = np.maximum(np.abs(expect), max(floor, np.finfo(np.float32).tiny))
+    ulp = np.spacing(magnitude.astype(np.float32)).astype(np.float64)
+    return float(np.max(np.abs(output.astype(np.float64) - expect) / ulp))
+
+
+def vector_math_run(func_name, shape, dtype="float32", accuracy="precise", data_range=None, poly_sch=True,
+                    attrs=None):
+    """
+    Checks the accuracy of a vectorized math function in ulp over data_range, the default range of the function
+    when it is None. With profiling, reports its throughput.
+    """
+    attrs = {} if attrs is None else attrs
+    attrs["target"] = attrs.get("target", "llvm")
+    attrs["cpu_math_accuracy"] = accuracy
+    reference, (low, high), floor, precise_ulp, fast_ulp = math_funcs[func_name]
+    if data_range is not None:
+        low, high = data_range
+    mod = utils.op_build_test(unary_math, (shape,), (dtype,), op_attrs=[func_name], attrs=attrs,
+                              kernel_name="vector_math_{}_{}".format(func_name, accuracy), polyhedral=poly_sch)
+
+    data = np.random.uniform(low, high, size=shape).astype(support_list[dtype])
+    expect = reference(data.astype(np.float64))
+    output = np.full(shape, np.nan, dtype)
+    output = utils.mod_launch(mod, (data, output), expect=expect)
+    if dtype == "float16":
+        res = np.allclose(output, expect.astype(np.float16), rtol=2e-3, atol=2e-3)
+        error = "max abs error {:.3e}".format(float(np.max(np.abs(output.astype(np.float64) - expect))))
+    else:
+        ulp = max_ulp_error(output, expect, floor)
+        res = ulp <= (fast_ulp if accuracy == "fast" else precise_ulp)
+        error = "max error {:.1f} ulp".format(ulp)
+
+    print("{} {} {}: {}".format(func_name, dtype, accuracy, error))
+    if attrs.get("profiling", False):
+        target_name = attrs["target"].split()[0]
+        args = to_tvm_nd_array([data, output], akg.tvm.context(target_name, 0))
+        tcost = target_profiling(mod, *args, target=target_name, repeat_time=attrs["repeat_times"])
+        print("{} {} {}: throughput={:.2f} Gelem/s".format(func_name, dtype, accuracy, data.size / tcost / 1e9))
+    if not res:
+        raise AssertionError("Test fail")
+    return data, output, expect, res
@@ -22,8 +22,14 @@ from akg.composite import cumprod as cumprod_ir_builder
 from scipy.ndimage.interpolation import shift
 
 def gen_data(shape, dtype, axis, exclusive, reverse):
-    support_list = {"float16": np.float16, "float32": np.float32}
-    data = random_gaussian(shape, miu=1, sigma=0.1).astype(support_list[dtype])
+    support_list = {"float16": np.float16, "float32": np.float32, "int32": np.int32}
+    if dtype == "int32":
+        # odd factors never wrap to zero, so long products stay exact modulo 2^32
+        data = np.random.choice([-3, -1, 1, 3], size=shape).astype(np.int32)
+    else:
+        # the log of the product walks by sigma per element, so a long axis neither underflows nor overflows
+        sigma = min(0.1, 1.0 / np.sqrt(shape[axis]))
+        data = random_gaussian(shape, miu=1, sigma=sigma).astype(support_list[dtype])
     if reverse:
         expect = np.flip(data, axis)
         expect = np.cumprod(expect, axis)
@@ -32,10 +38,10 @@ def gen_data(shape, dtype, axis, exclusive, reverse):
     if exclusive:
         shift_axis = [0] * len(data.shape)
         shift_axis[axis] = 1
-        expect = shift(expect, shift_axis, cval=1)
+        expect = shift(expect, shift_axis, cval=1, order=0)
     if reverse:
         expect = np.flip(expect, axis)
-    output = np.full(shape, np.nan, dtype)
+    output = np.full(shape, np.nan if dtype.startswith("float") else 0, dtype)
     return data, output, expect
 
 def cumprod_run(shape, dtype, axis=0, exclusive=False, reverse=False, poly_sch=True, attrs=None):
@@ -48,7 +54,9 @@ def cumprod_run(shape, dtype, axis=0, exclusive=False, reverse=False, poly_sch=T
 
     data, output, expect = gen_data(shape, dtype, axis, exclusive, reverse)
     output = utils.mod_launch(mod, (data, output), expect = expect)
-    ret = compare_tensor(output, expect, rtol=5e-03, atol=1.e-8, equal_nan=True)
+    # the blocked cpu scan reassociates float products, integer results must stay exact
+    rtol, atol = (5e-03, 1.e-8) if dtype.startswith("float") else (0, 0)
+    ret = compare_tensor(output, expect, rtol=rtol, atol=atol, equal_nan=True)
     print("Test {}".format("Pass" if ret else "Failed"))
     target_name = attrs["target"].split()[0]
     if not ret:
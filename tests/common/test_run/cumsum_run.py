@@ -22,8 +22,11 @@ from akg.composite import cumsum as cumsum_ir_builder
 from scipy.ndimage.interpolation import shift
 
 def gen_data(shape, dtype, axis, exclusive, reverse):
-    support_list = {"float16": np.float16, "float32": np.float32}
-    data = random_gaussian(shape, miu=1, sigma=0.1).astype(support_list[dtype])
+    support_list = {"float16": np.float16, "float32": np.float32, "int32": np.int32}
+    if dtype == "int32":
+        data = np.random.randint(-100, 100, size=shape).astype(np.int32)
+    else:
+        data = random_gaussian(shape, miu=1, sigma=0.1).astype(support_list[dtype])
     if reverse:
         expect = np.flip(data, axis)
         expect = np.cumsum(expect, axis)
@@ -32,10 +35,10 @@ def gen_data(shape, dtype, axis, exclusive, reverse):
     if exclusive:
         shift_axis = [0] * len(data.shape)
         shift_axis[axis] = 1
-        expect = shift(expect, shift_axis, cval=0)
+        expect = shift(expect, shift_axis, cval=0, order=0)
     if reverse:
         expect = np.flip(expect, axis)
-    output = np.full(shape, np.nan, dtype)
+    output = np.full(shape, np.nan if dtype.startswith("float") else 0, dtype)
     return data, output, expect
 
 def cumsum_run(shape, dtype, axis=0, exclusive=False, reverse=False, poly_sch=True, attrs=None):
@@ -48,7 +51,9 @@ def cumsum_run(shape, dtype, axis=0, exclusive=False, reverse=False, poly_sch=Tr
 
     data, output, expect = gen_data(shape, dtype, axis, exclusive, reverse)
     output = utils.mod_launch(mod, (data, output), expect = expect)
-    ret = compare_tensor(output, expect, rtol=5e-03, atol=1.e-8, equal_nan=True)
+    # the blocked cpu scan reassociates float sums, integer results must stay exact
+    rtol, atol = (5e-03, 1.e-8) if dtype.startswith("float") else (0, 0)
+    ret = compare_tensor(output, expect, rtol=rtol, atol=atol, equal_nan=True)
     print("Test {}".format("Pass" if ret else "Failed"))
     target_name = attrs["target"].split()[0]
     if not ret:
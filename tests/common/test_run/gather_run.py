@@ -30,12 +30,20 @@ def gen_data(shape1, dtype1, shape2, dtype2, axis):
     expect = gather_np(params, indices, axis)
     return params, indices, expect
 
-def gather_run(shape1, dtype1, shape2, dtype2, axis, poly_sch=True, attrs=None):
+def check_vector_gather(mod):
+    """The bound checked lanes of a gather along the last axis load through one vector gather."""
+    if "@llvm.masked.gather" not in mod.get_source():
+        raise AssertionError("gather is not vectorized: no llvm.masked.gather in the llvm source")
+
+
+def gather_run(shape1, dtype1, shape2, dtype2, axis, vector_gather=False, poly_sch=True, attrs=None):
     if not attrs:
         attrs = {"target": "cuda"}
     op_attrs = [axis]
     mod = utils.op_build_test(gather, [shape1, shape2], [dtype1, dtype2], op_attrs=op_attrs,
                                   polyhedral=poly_sch, attrs=attrs, kernel_name="gather")
+    if vector_gather and attrs["target"].split()[0] == "llvm":
+        check_vector_gather(mod)
 
     # gen data
     params, indices, expect = gen_data(shape1, dtype1, shape2, dtype2, axis)
@@ -0,0 +1,70 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import numpy as np
+from akg.ops.math.gpu import BatchMatMul
+from akg.ops.nn.gpu import TensorcoreConv
+from akg.utils import kernel_exec as utils
+from tests.common.test_run import batch_matmul_run as matmul
+from tests.common.test_run import conv_run as conv
+
+
+def build_matmul(shape1, shape2, dtype, attrs):
+    op_attrs = [dtype, "NHDT", "NHTD", "NHDT", True, False]
+    attrs.update({"pragma_enable_matmul": True, "enable_auto_inline": False})
+    mod = utils.op_build_test(BatchMatMul, (shape1, shape2, (1, )), (dtype, dtype, dtype), op_attrs=op_attrs,
+                              attrs=attrs, kernel_name="batch_matmul_pipeline")
+    lhs, rhs, bias, output, expect = matmul.gen_data(shape1, shape2, dtype, dtype, "NHDT", "NHTD", "NHDT", (1, ))
+    return mod, (lhs, rhs, bias, output), expect
+
+
+def build_conv(shape_data, shape_weight, dtype, attrs):
+    stride, padding, dilation = (1, 1), (0, 0, 0, 0), (1, 1)
+    attrs.update({"enable_auto_fuse": False, "pragma_enable_matmul": True, "pragma_enable_conv_tensor_core": True,
+                  "polytops_enable_skewing": False})
+    mod = utils.op_build_test(TensorcoreConv, (shape_data, shape_weight), (dtype, dtype),
+                              op_attrs=[stride, padding, dilation, dtype], attrs=attrs,
+                              kernel_name="tensorcore_conv_pipeline")
+    data, weight, output, expect = conv.gen_data(shape_data, shape_weight, "NHWC", stride, padding, dilation, dtype,
+                                                 dtype)
+    return mod, (data, weight, output), expect
+
+
+def shared_pipeline_run(op_name, shape1, shape2, stages, dtype="float16", poly_sch=True, attrs=None):
+    """
+    Builds a tensor core matmul or conv whose shared memory tiles are prefetched over the given number of stages,
+    checks the asynchronous copies and the waits in the generated cuda source, then checks the result.
+    """
+    attrs = {} if attrs is None else attrs
+    build_attrs = {"target": attrs.get("target", "cuda"), "enable_double_buffer": True,
+                   "shared_pipeline_stages": stages}
+    if op_name == "matmul":
+        mod, args, expect = build_matmul(shape1, shape2, dtype, build_attrs)
+    else:
+        mod, args, expect = build_conv(shape1, shape2, dtype, build_attrs)
+
+    source = mod.imported_modules[0].get_source()
+    res = True
+    if stages > 2:
+        res = "__pipeline_memcpy_async(" in source and "#include <cuda_pipeline.h>" in source
+        res = res and "__pipeline_commit()" in source and "__pipeline_wait_prior(" in source
+        print("asynchronous copies of {} stages: {}".format(stages, "found" if res else "missing"))
+
+    output = utils.mod_launch(mod, args, expect=expect)
+    res = res and np.allclose(output, expect, rtol=5e-03, atol=1.e-8)
+    print("Test {}".format("Pass" if res else "Fail"))
+    if not res:
+        print("Error cuda:========================")
+        print(source)
+        raise AssertionError("Test fail")
+    return args[:-1], output, expect, res
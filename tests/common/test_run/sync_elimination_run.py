@@ -0,0 +1,115 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import akg
+import numpy as np
+from akg.utils import kernel_exec as utils
+from tests.common.gen_random import random_gaussian
+
+
+def square_add(data):
+    # every thread reads back the elements of the shared buffer it has copied itself
+    return akg.tvm.compute(data.shape, lambda *i: data(*i) * data(*i) + data(*i), name="square_add")
+
+
+def transpose(data):
+    # the threads read the elements of the shared buffer copied by the other threads
+    return akg.topi.transpose(data, (1, 0))
+
+
+def swap_pairs(data):
+    # the threads read the elements of the shared buffer copied by the neighbour thread, within one warp
+    return akg.tvm.compute(data.shape, lambda i, j: data[i, j + 1 - j % 2 * 2], name="swap_pairs")
+
+
+def swap_pairs_np(data):
+    return data.reshape(data.shape[0], -1, 2)[:, :, ::-1].reshape(data.shape)
+
+
+op_list = {
+    "square_add": (square_add, lambda data: data * data + data),
+    "transpose": (transpose, lambda data: data.transpose(1, 0)),
+    "swap_pairs": (swap_pairs, swap_pairs_np),
+}
+
+
+def build_kernel(op_name, shape, dtype, attrs, enable):
+    attrs = dict(attrs)
+    attrs.update({"enable_sync_elimination": enable, "shared_memory_tensors": "input_1"})
+    kernel_name = "{}_sync_elimination_{}".format(op_name, "on" if enable else "off")
+    return utils.op_build_test(op_list[op_name][0], (shape, ), (dtype, ), attrs=attrs, kernel_name=kernel_name)
+
+
+def launch(mod, data, expect, dtype):
+    output = np.full(expect.shape, np.nan, dtype)
+    output = utils.mod_launch(mod, (data, output), expect=expect)
+    return output, np.allclose(output, expect, rtol=1e-4, atol=1e-4)
+
+
+def sync_elimination_run(op_name, shape, expect_removed, dtype="float32", poly_sch=True, attrs=None):
+    """
+    Builds the kernel with and without the elimination of the redundant synchronizations, compares the count of
+    barriers in the generated cuda source, then checks both results.
+    """
+    attrs = {} if attrs is None else attrs
+    build_attrs = {"target": attrs.get("target", "cuda")}
+    mod_on = build_kernel(op_name, shape, dtype, build_attrs, True)
+    mod_off = build_kernel(op_name, shape, dtype, build_attrs, False)
+    source_on = mod_on.imported_modules[0].get_source()
+    source_off = mod_off.imported_modules[0].get_source()
+    sync_on = source_on.count("__syncthreads()")
+    sync_off = source_off.count("__syncthreads()")
+    warp_on = source_on.count("__syncwarp()")
+    print("__syncthreads: {} -> {}, __syncwarp: {}".format(sync_off, sync_on, warp_on))
+    res = sync_on < sync_off if expect_removed else sync_on + warp_on == sync_off
+
+    data = random_gaussian(shape, miu=1, sigma=0.3).astype(dtype)
+    expect = op_list[op_name][1](data)
+    output, res_on = launch(mod_on, data, expect, dtype)
+    _, res_off = launch(mod_off, data, expect, dtype)
+    res = res and res_on and res_off
+    print("Test {}".format("Pass" if res else "Fail"))
+    if not res:
+        print("Error cuda:========================")
+        print(source_on)
+        raise AssertionError("Test fail")
+    return data, output, expect, res
+
+
+def lower_sync_counts(op_name, shape, dtype, enable):
+    """Counts the block and the warp barriers of the lowered ir, which needs no gpu."""
+    data = akg.tvm.placeholder(shape, dtype, "input_1")
+    out = op_list[op_name][0](data)
+    sch = akg.tvm.create_schedule(out.op)
+    attrs = {"target": "cuda", "enable_sync_elimination": enable, "shared_memory_tensors": "input_1"}
+    stmt = str(akg.lower(sch, [data, out], attrs=attrs, simple_mode=True, polyhedral=True, target="cuda"))
+    return stmt.count('tvm_storage_sync("shared")'), stmt.count("__syncwarp()")
+
+
+def sync_elimination_lower_run(op_name, shape, expect, dtype="float32", attrs=None):
+    """
+    Lowers the kernel with and without the elimination of the redundant synchronizations and checks that each block
+    barrier is kept, removed or downgraded to a warp barrier as expected, without launching it.
+    """
+    sync_off, warp_off = lower_sync_counts(op_name, shape, dtype, False)
+    sync_on, warp_on = lower_sync_counts(op_name, shape, dtype, True)
+    print("{}: __syncthreads: {} -> {}, __syncwarp: {} -> {}".format(op_name, sync_off, sync_on, warp_off, warp_on))
+    checks = {
+        "kept": sync_on == sync_off and warp_on == 0,
+        "removed": sync_on < sync_off and warp_on == 0,
+        "warp": warp_on > 0 and sync_on + warp_on == sync_off,
+    }
+    res = sync_off > 0 and warp_off == 0 and checks[expect]
+    if not res:
+        raise AssertionError("{}: expected the barriers to be {}".format(op_name, expect))
+    return shape, None, None, res
@@ -25,7 +25,12 @@ def transpose_data(shape, axes, dtype):
     bench_mark = data_input.transpose(axes)
     return data_input, bench_mark
 
-def transpose_run(shape, axes, dtype, attrs):
+def transpose_run(shape, axes, dtype, attrs_op=None, attrs=None):
+    if attrs_op is not None:
+        if attrs is not None:
+            attrs.update(attrs_op)
+        else:
+            attrs = attrs_op
     if 'tuning' in attrs.keys():
         t = attrs.get("tuning", False)
         kernel_name = attrs.get("kernel_name", False)
@@ -36,20 +41,35 @@ def transpose_run(shape, axes, dtype, attrs):
         else:
             return mod
     else:
+        target_name = attrs.get("target", "cce").split()[0]
         mod = transpose_compile(shape, axes, dtype, attrs)
         bench_mark, data_input, output = gen_data(axes, dtype, shape)
         output = utils.mod_launch(mod, (data_input, output), expect=bench_mark)
         if attrs.get("profiling", False):
             import akg
-            target_name = attrs["target"].split()[0]
             args_list = to_tvm_nd_array([data_input, output], akg.tvm.context(target_name, 0))
             target_profiling(mod, *args_list, target=target_name, repeat_time=attrs["repeat_times"])
         # compare result
         rtol, atol = get_rtol_atol("transpose", dtype)
         compare_result = compare_tensor(output, bench_mark, rtol=rtol, atol=atol, equal_nan=True)
+        if compare_result and target_name == "llvm":
+            # square tiles use the register transpose kernels, check them against the rectangular tiles
+            compare_result = transpose_rect_check(shape, axes, dtype, attrs, data_input, output)
         return data_input, output, bench_mark, compare_result
 
 
+def transpose_rect_check(shape, axes, dtype, attrs, data_input, output):
+    rect_attrs = dict(attrs, enable_square_transpose=False)
+    rect_mod = transpose_compile(shape, axes, dtype, rect_attrs, kernel_name="transpose_rect")
+    rect_output = np.full(output.shape, np.nan, dtype)
+    rect_output = utils.mod_launch(rect_mod, (data_input, rect_output), expect=output)
+    if attrs.get("profiling", False):
+        import akg
+        args_list = to_tvm_nd_array([data_input, rect_output], akg.tvm.context("llvm", 0))
+        target_profiling(rect_mod, *args_list, target="llvm", repeat_time=attrs["repeat_times"])
+    return np.array_equal(output, rect_output)
+
+
 def gen_data(axes, dtype, shape):
     # Generate data
     data_input = random_gaussian(shape, miu=1, sigma=0.3).astype(dtype)
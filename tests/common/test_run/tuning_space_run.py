@@ -0,0 +1,66 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+import time
+import akg
+from akg.ops.nn.gpu import Conv
+from akg.utils import kernel_exec as utils
+
+
+def reduce_sum(data, axis):
+    return akg.topi.sum(data, axis=axis)
+
+
+def gen_space(op_name, shapes, dtype, op_attrs, attrs):
+    if op_name == "reduce_sum":
+        spaces = utils.op_build_test(reduce_sum, shapes, (dtype, ), op_attrs=op_attrs, attrs=attrs,
+                                     kernel_name="reduce_sum_space", tuning=True)
+    else:
+        spaces = utils.op_build_test(Conv, shapes, (dtype, dtype), op_attrs=op_attrs, attrs=attrs,
+                                     kernel_name="conv_space", tuning=True)
+    return spaces[0] if isinstance(spaces, tuple) else spaces
+
+
+def space_tables(space):
+    tables = [space.index_table, space.c1_tile_range_table, space.c1_tile_mod_table, space.tiling_candidate]
+    return [table.asnumpy().tolist() for table in tables]
+
+
+def tuning_space_run(op_name, shapes, op_attrs, dtype="float32", prune_level=1, thread_nums=(2, 8), attrs=None):
+    """
+    Generates the tiling tuning space on one thread and on several threads, and checks that the candidates are the
+    same and in the same order.
+    """
+    attrs = {} if attrs is None else attrs
+    build_attrs = {"target": attrs.get("target", "cuda"), "enable_auto_fuse": False,
+                   "prune_tuning_space_level": prune_level}
+
+    def timed_space(threads):
+        space_attrs = dict(build_attrs)
+        space_attrs["tuning_space_threads"] = threads
+        start = time.time()
+        tables = space_tables(gen_space(op_name, shapes, dtype, op_attrs, space_attrs))
+        return tables, time.time() - start
+
+    serial, serial_time = timed_space(1)
+    print("serial: {} candidates in {:.3f} s".format(len(serial[-1]), serial_time))
+    res = len(serial[-1]) > 0
+    for threads in thread_nums:
+        parallel, parallel_time = timed_space(threads)
+        same = parallel == serial
+        print("{} threads: {} candidates in {:.3f} s, {}".format(threads, len(parallel[-1]), parallel_time,
+                                                                 "identical" if same else "differs"))
+        res = res and same
+    if not res:
+        raise AssertionError("Test fail")
+    return shapes, len(serial[-1]), len(serial[-1]), res
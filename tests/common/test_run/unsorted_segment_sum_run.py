@@ -23,7 +23,12 @@ from akg.utils.result_analysis import target_profiling
 from akg.utils.format_transform import to_tvm_nd_array
 from akg.utils.gen_random import random_gaussian, gen_indices_unsorted_segment_sum
 
-def unsorted_segment_sum_run(shape, ids_shape, num_segments, dtype, attrs):
+def unsorted_segment_sum_run(shape, ids_shape, num_segments, dtype, attrs_op=None, attrs=None):
+    if attrs_op is not None:
+        if attrs is not None:
+            attrs.update(attrs_op)
+        else:
+            attrs = attrs_op
     if not attrs:
         attrs = {"target": CCE}
     if attrs["target"] != CCE:
@@ -11,7 +11,7 @@
 # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 # See the License for the specific language governing permissions and
 # limitations under the License.
-from copy import copy
+import copy
 import os
 import sys
 import json
@@ -19,7 +19,7 @@ import time
 import functools
 import glob
 import logging
-from multiprocessing import Process
+from multiprocessing import Process, Queue
 import pytest
 import numpy as np
 import akg
@@ -77,6 +77,9 @@ def print_usage():
     logging.info(template.format("", "json mind trick file"))
     logging.info(template.format("--mind-trick-string", ""))
     logging.info(template.format("", "json mind-trick string"))
+    logging.info(template.format("--benchmark=1", ""))
+    logging.info(template.format("", "Compare auto tiling with symbolic tiling on the '-f' or '-d' kernels, e.g. "
+                                     "'-d ../networks/cpu/deepfm/level0/' for the cpu cache model."))
     logging.info("\n")
 
 
@@ -275,7 +278,9 @@ def get_result(desc, poly, attrs=None, profiling=True, need_compare=True, precis
                 break
         if has_complex == False:
             inputs = to_tvm_nd_array(input_for_mod, ctx)
-            target_profiling(mod, *inputs, target=backend, repeat_time=1000)
+            run_time = target_profiling(mod, *inputs, target=backend, repeat_time=1000)
+            if cycles is None:
+                cycles = {"run_time": run_time}
     return True, cycles
 
 
@@ -298,6 +303,29 @@ def test_single_file(input_file, attrs, poly, profiling=True, max_run_times=3):
         raise ValueError("Precision Error")
 
 
+def benchmark_single_file(input_file, attrs, poly, queue):
+    """Run one kernel with the tiling strategy selected by SYMBOLIC_TILING and report its run time."""
+    if not input_file.endswith(".info") and not input_file.endswith(".json"):
+        return
+    enable_input_cache()
+    with open(input_file, 'r') as f:
+        desc = f.read()
+    result, cycles = get_result(desc, poly, attrs)
+    run_time = cycles["run_time"] if result and cycles is not None else -1
+    queue.put((input_file, os.environ.get("SYMBOLIC_TILING"), run_time))
+
+
+def log_benchmark_summary(results):
+    template = "{0:80}{1:>16}{2:>16}{3:>10}"
+    logging.info(template.format("kernel", "auto tiling", "symbolic tiling", "speedup"))
+    for file_name in sorted(results.keys()):
+        auto_time = results[file_name].get("0", -1)
+        symbolic_time = results[file_name].get("1", -1)
+        speedup = auto_time / symbolic_time if auto_time > 0 and symbolic_time > 0 else 0
+        logging.info(template.format(os.path.basename(file_name), "{:.3f} ms".format(auto_time * 1000),
+                                     "{:.3f} ms".format(symbolic_time * 1000), "{:.2f}x".format(speedup)))
+
+
 @pytest.mark.skip
 def test_json_dir(poly, use_custom, json_dir="./json_dir/", online_tuning=0):
     # enable input cache for json dir testing
@@ -579,6 +607,7 @@ def main(argv):
                     files = os.listdir(p)
                     for input_file in files:
                         file_names.append(p + "/" + input_file)
+        queue = Queue()
         for file_name in file_names:
             for frontend_choice in frontend_envdict:
                 for fk, fv in frontend_choice.items():
@@ -588,8 +617,7 @@ def main(argv):
                         attrs_list.pop("is_tbe_codegen")
                     attrs_copy = copy.deepcopy(attrs_list)
                     if 1:
-                        p = Process(target=test_single_file,
-                            args=(file_name, attrs_copy, poly, True,1))
+                        p = Process(target=benchmark_single_file, args=(file_name, attrs_copy, poly, queue))
                         p.start()
                         p.join()
                     else:
@@ -600,6 +628,11 @@ def main(argv):
                         except Exception as e:
                             msg = str(e)
                             logging.error(msg)
+        results = {}
+        while not queue.empty():
+            file_name, choice, run_time = queue.get()
+            results.setdefault(file_name, {})[choice] = run_time
+        log_benchmark_summary(results)
     else:
         if single_file:
             test_single_file(file_name, attrs_list, poly, True)
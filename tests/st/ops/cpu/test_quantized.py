@@ -0,0 +1,82 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import os
+import pytest
+import akg.utils as utils
+from tests.common.base import TestBase
+from tests.common.test_run.cpu import quantized_matmul_run, quantized_conv2d_run
+from tests.common.test_run.cpu.cpu_test_utils import cpu_has_flag
+
+
+############################################################
+# TestCase= class: put to tests/*/
+############################################################
+
+
+class TestCase(TestBase):
+    def setup(self):
+        case_name = "cpu_quantized"
+        case_path = os.getcwd()
+
+        self.params_init(case_name, case_path)
+
+        self.args_default = [
+            ("000_case", quantized_matmul_run, ((256, 512), (512, 768), "int32", "avx2"), ["level1"]),
+            ("001_case", quantized_matmul_run, ((256, 512), (512, 768), "uint8", "avx2"), ["level1"]),
+            ("002_case", quantized_conv2d_run, ((1, 8, 28, 28, 8), (8, 8, 3, 3, 8, 8), (1, 1), (1, 1, 1, 1),
+                                                (1, 1), "int32", "avx2"), ["level1"]),
+            ("003_case", quantized_conv2d_run, ((1, 8, 28, 28, 8), (8, 8, 3, 3, 8, 8), (1, 1), (1, 1, 1, 1),
+                                                (1, 1), "uint8", "avx2"), ["level1"]),
+        ]
+        # needs a cpu with avx512 vnni
+        self.args_vnni = [
+            ("004_case", quantized_matmul_run, ((256, 512), (512, 768), "int8", "avx512vnni"), ["level1"]),
+            ("005_case", quantized_conv2d_run, ((1, 4, 28, 28, 16), (4, 4, 3, 3, 16, 16), (1, 1), (1, 1, 1, 1),
+                                                (1, 1), "int32", "avx512vnni"), ["level1"]),
+        ]
+        # needs a cpu with avx512bw
+        self.args_avx512 = [
+            ("006_case", quantized_matmul_run, ((256, 512), (512, 768), "int32", "avx512"), ["level1"]),
+            ("007_case", quantized_conv2d_run, ((1, 4, 28, 28, 16), (4, 4, 3, 3, 16, 16), (1, 1), (1, 1, 1, 1),
+                                                (1, 1), "uint8", "avx512"), ["level1"]),
+        ]
+
+        return True
+
+    @pytest.mark.level1
+    @pytest.mark.platform_x86_cpu
+    @pytest.mark.env_onecard
+    def test_cpu_level1(self):
+        return self.run_cases(self.args_default, utils.LLVM, "level1")
+
+    @pytest.mark.level1
+    @pytest.mark.platform_x86_cpu
+    @pytest.mark.env_onecard
+    def test_cpu_vnni(self):
+        if not cpu_has_flag("avx512_vnni"):
+            pytest.skip("the host cpu has no avx512 vnni")
+        return self.run_cases(self.args_vnni, utils.LLVM, "level1")
+
+    @pytest.mark.level1
+    @pytest.mark.platform_x86_cpu
+    @pytest.mark.env_onecard
+    def test_cpu_avx512(self):
+        if not cpu_has_flag("avx512bw"):
+            pytest.skip("the host cpu has no avx512bw")
+        return self.run_cases(self.args_avx512, utils.LLVM, "level1")
+
+    def teardown(self):
+        self._log.info("{0} Teardown".format(self.casename))
+        super(TestCase, self).teardown()
+        return
@@ -0,0 +1,63 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import os
+import pytest
+import akg.utils as utils
+from tests.common.base import TestBase
+from tests.common.test_run.cpu import vector_math_run
+
+############################################################
+# TestCase= class: put to tests/*/
+############################################################
+
+
+class TestCase(TestBase):
+    def setup(self):
+        case_name = "cpu_vector_math"
+        case_path = os.getcwd()
+
+        self.params_init(case_name, case_path)
+
+        self.args_default = [
+            ("000_case", vector_math_run, ("exp", (1024, 1024), "float32", "precise"), ["level1"]),
+            ("001_case", vector_math_run, ("exp", (1024, 1024), "float32", "fast"), ["level1"]),
+            ("002_case", vector_math_run, ("tanh", (1024, 1024), "float32", "precise"), ["level1"]),
+            ("003_case", vector_math_run, ("tanh", (1024, 1024), "float32", "fast"), ["level1"]),
+            ("004_case", vector_math_run, ("sigmoid", (1024, 1024), "float32", "precise"), ["level1"]),
+            ("005_case", vector_math_run, ("erf", (1024, 1024), "float32", "precise"), ["level1"]),
+            ("006_case", vector_math_run, ("rsqrt", (1024, 1024), "float32", "precise"), ["level1"]),
+            ("007_case", vector_math_run, ("rsqrt", (1024, 1024), "float32", "fast"), ["level1"]),
+            ("008_case", vector_math_run, ("sin", (1024, 1024), "float32", "precise"), ["level1"]),
+            ("009_case", vector_math_run, ("cos", (1024, 1024), "float32", "precise"), ["level1"]),
+            ("010_case", vector_math_run, ("exp", (1024, 1024), "float16", "precise"), ["level1"]),
+            ("011_case", vector_math_run, ("tanh", (1024, 1024), "float16", "fast"), ["level1"]),
+            ("012_case", vector_math_run, ("log", (1024, 1024), "float32", "precise"), ["level1"]),
+            ("013_case", vector_math_run, ("log", (1024, 1024), "float16", "precise", (1e-2, 1e4)), ["level1"]),
+            # beyond the float32 reduction of sin and cos, the vectors go to libm
+            ("014_case", vector_math_run, ("sin", (1024, 1024), "float32", "precise", (-1e5, 1e5)), ["level1"]),
+            ("015_case", vector_math_run, ("cos", (1024, 1024), "float32", "precise", (-1e5, 1e5)), ["level1"]),
+        ]
+
+        return True
+
+    @pytest.mark.level1
+    @pytest.mark.platform_x86_cpu
+    @pytest.mark.env_onecard
+    def test_cpu_level1(self):
+        return self.run_cases(self.args_default, utils.LLVM, "level1")
+
+    def teardown(self):
+        self._log.info("{0} Teardown".format(self.casename))
+        super(TestCase, self).teardown()
+        return
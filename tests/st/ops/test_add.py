@@ -15,7 +15,7 @@ import os
 import pytest
 import akg.utils as utils
 from tests.common.base import TestBase, get_splitted_cases
-from tests.common.test_run.add_run import add_run
+from tests.common.test_run.add_run import add_run, add_vectorized_run
 
 
 ############################################################
@@ -201,7 +201,10 @@ class TestCase(TestBase):
             ("001_add", add_run, ((1024, 2), (1024, 2), 'float32'), ["level0"]),
             ("002_add", add_run, ((1024, 1024), (1024, 1024), 'float32'), ["level0"]),
             ("003_add", add_run, ((1024, 10240), (1024, 10240), 'float32'), ["level1"]),
-            ("004_add", add_run, ((1024, 1024, 10), (1024, 1024, 10), 'float32'), ["level1"])
+            ("004_add", add_run, ((1024, 1024, 10), (1024, 1024, 10), 'float32'), ["level1"]),
+            # partial tiles on every axis, the full tiles stay vectorized on the cpu
+            ("005_add", add_vectorized_run, ((1000, 1000), (1000, 1000), 'float32', "<8 x float>"), ["level0"]),
+            ("006_add", add_vectorized_run, ((1000, 127), (1000, 127), 'float32', "<8 x float>"), ["level0"]),
         ]
 
         return True
@@ -16,6 +16,7 @@ import pytest
 import akg.utils as utils
 from tests.common.base import TestBase
 from tests.common.test_run import batch_matmul_run
+from tests.common.test_run.cpu import batch_matmul_epilogue_run
 
 ############################################################
 # TestCase= class: put to tests/*/
@@ -30,6 +31,16 @@ class TestCase(TestBase):
             ("001_case", batch_matmul_run, ((32, 12, 128, 128), (32, 12, 128, 64), 'float32', 'float32', "NHDT",
                 "NHTD", "NHDT", (1, ), False, False), ["level0"])
         ]
+        # epilogues of the cpu gemm, folded into its write of C
+        self.args_cpu = [
+            ("002_case", batch_matmul_run, ((128, 64), (128, 64), 'float32', 'float32', "NHDT", "NHDT", "NHDT",
+                (128, ), True, False), ["level0"]),
+            ("003_case", batch_matmul_run, ((256, 128), (64, 128), 'float32', 'float32', "NHDT", "NHDT", "NHDT",
+                (1, ), True, False), ["level0"]),
+            ("004_case", batch_matmul_epilogue_run, ((128, 64), (128, 64), (128, ), "relu"), ["level0"]),
+            ("005_case", batch_matmul_epilogue_run, ((256, 128), (64, 128), (64, ), "residual"), ["level0"]),
+            ("006_case", batch_matmul_epilogue_run, ((128, 64), (128, 64), (128, ), "cast"), ["level0"]),
+        ]
         self.args_gpu = [
             ("001_case", batch_matmul_run, ((32, 12, 128, 128), (32, 12, 128, 64), 'float16', 'float16', "NHDT",
                 "NHTD", "NHDT", (1, ), False, True), ["level0"]),
@@ -51,7 +62,7 @@ class TestCase(TestBase):
         return self.run_cases(self.args_default + self.args_gpu, utils.CUDA, "level0")
     
     def run_cpu_level0(self):
-        return self.run_cases(self.args_default, utils.LLVM, "level0")
+        return self.run_cases(self.args_default + self.args_cpu, utils.LLVM, "level0")
 
     def teardown(self):
         self._log.info("{0} Teardown".format(self.casename))
@@ -29,6 +29,12 @@ class TestCase(TestBase):
             ("001_case", cumprod_run, ((32, 3, 3, 16), "float32", 1, True, False), ["level0"]),
             ("002_case", cumprod_run, ((64, 3, 3, 16), "float32", 2, True, True), ["level0"]),
         ]
+        # long scan axes take the blocked parallel scan on cpu
+        self.args_cpu = [
+            ("003_case", cumprod_run, ((4, 65536), "float32", 1, False, False), ["level0"]),
+            ("004_case", cumprod_run, ((65536,), "int32", 0, True, True), ["level0"]),
+            ("005_case", cumprod_run, ((2, 32768, 4), "int32", 1, False, False), ["level0"]),
+        ]
 
     def setup(self):
         self.params_init(self.case_name, self.case_path)
@@ -38,7 +44,7 @@ class TestCase(TestBase):
         return self.run_cases(self.args_default, utils.CUDA, "level0")
     
     def run_cpu_level0(self):
-        return self.run_cases(self.args_default, utils.LLVM, "level0")
+        return self.run_cases(self.args_default + self.args_cpu, utils.LLVM, "level0")
 
     def teardown(self):
         self._log.info("{0} Teardown".format(self.casename))
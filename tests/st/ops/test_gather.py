@@ -43,6 +43,11 @@ class TestCase(TestBase):
         self.args_default = [
             ("000_case", gather_run, ((19717, 8, 1), 'float32', (108365, ), 'int32', 0), ["level0"]),
         ]
+        # gathers along the last axis, whose vectorized lanes load through the indices with one gather
+        self.args_cpu = [
+            ("001_case", gather_run, ((64, 4096), 'float32', (1024, ), 'int32', 1, True), ["level0"]),
+            ("002_case", gather_run, ((32, 2048), 'float64', (512, ), 'int32', 1, True), ["level0"]),
+        ]
         return True
 
     @pytest.mark.level0
@@ -55,7 +60,7 @@ class TestCase(TestBase):
     @pytest.mark.platform_x86_cpu
     @pytest.mark.env_onecard
     def test_cpu_level0(self):
-        return self.run_cases(self.args_default, utils.LLVM, "level0")
+        return self.run_cases(self.args_default + self.args_cpu, utils.LLVM, "level0")
 
     @pytest.mark.level0
     @pytest.mark.platform_arm_ascend_training
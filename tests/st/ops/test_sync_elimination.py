@@ -0,0 +1,71 @@
+# Copyright 2022 Huawei Technologies Co., Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+import os
+import pytest
+import akg.utils as utils
+from tests.common.base import TestBase
+from tests.common.test_run import sync_elimination_run, sync_elimination_lower_run
+
+############################################################
+# TestCase= class: put to tests/*/
+############################################################
+class TestCase(TestBase):
+    def __init__(self):
+        self.case_name = "sync_elimination"
+        self.case_path = os.getcwd()
+        self.args_gpu = [
+            ("000_case", sync_elimination_run, ("square_add", (1024, 1024), True), ["level0"]),
+            ("001_case", sync_elimination_run, ("transpose", (1024, 1024), False), ["level0"]),
+            ("002_case", sync_elimination_run, ("swap_pairs", (1024, 1024), False), ["level0"]),
+        ]
+        # the barriers of the lowered ir only, without a launch
+        self.args_lower = [
+            ("003_case", sync_elimination_lower_run, ("square_add", (1024, 1024), "removed"), ["level0"]),
+            ("004_case", sync_elimination_lower_run, ("transpose", (1024, 1024), "kept"), ["level0"]),
+            ("005_case", sync_elimination_lower_run, ("swap_pairs", (1024, 1024), "warp"), ["level0"]),
+        ]
+
+    def setup(self):
+        self.params_init(self.case_name, self.case_path)
+        return True
+
+    def run_gpu_level0(self):
+        return self.run_cases(self.args_gpu, utils.CUDA, "level0")
+
+    def run_lower_level0(self):
+        return self.run_cases(self.args_lower, utils.CUDA, "level0")
+
+    def teardown(self):
+        self._log.info("{0} Teardown".format(self.casename))
+        super(TestCase, self).teardown()
+        return
+
+@pytest.mark.level0
+@pytest.mark.platform_x86_gpu_training
+@pytest.mark.env_onecard
+def test_gpu_level0():
+    test_case = TestCase()
+    test_case.setup()
+    test_case.run_gpu_level0()
+    test_case.teardown()
+
+
+@pytest.mark.level0
+@pytest.mark.platform_x86_gpu_training
+@pytest.mark.env_onecard
+def test_lower_level0():
+    test_case = TestCase()
+    test_case.setup()
+    test_case.run_lower_level0()
+    test_case.teardown()
@@ -20,6 +20,7 @@ import pytest
 import akg.utils as utils
 from tests.common.base import TestBase
 from tests.common.test_run import transpose_run
+from tests.common.test_run.cpu.cpu_test_utils import cpu_has_flag
 
 class TestCase(TestBase):
     def setup(self):
@@ -125,6 +126,15 @@ class TestCase(TestBase):
             ("002_case", transpose_run, ((8, 24, 32, 16), (0, 1, 3, 2), 'float32'), ["level0"]),
             ("003_case", transpose_run, ((1, 1, 32, 16), (0, 1, 3, 2), 'float32'), ["level0"])
         ]
+        # square register transposes, 16x16 for float16 and 8x8 for float32 on avx
+        self.args_cpu = [
+            ("004_case", transpose_run, ((4, 8, 64, 32), (0, 1, 3, 2), 'float16', {"feature": "avx"}), ["level0"]),
+            ("005_case", transpose_run, ((2, 256, 128), (0, 2, 1), 'float32', {"feature": "avx"}), ["level0"])
+        ]
+        # 16x16 for float32 on avx512
+        self.args_avx512 = [
+            ("006_case", transpose_run, ((2, 256, 128), (0, 2, 1), 'float32', {"feature": "avx512"}), ["level1"])
+        ]
 
         return True
 
@@ -153,4 +163,12 @@ class TestCase(TestBase):
     @pytest.mark.platform_x86_cpu
     @pytest.mark.env_onecard
     def test_cpu_level0(self):
-        return self.run_cases(self.args_outhers, utils.LLVM, "level0")
\ No newline at end of file
+        return self.run_cases(self.args_outhers + self.args_cpu, utils.LLVM, "level0")
+
+    @pytest.mark.level1
+    @pytest.mark.platform_x86_cpu
+    @pytest.mark.env_onecard
+    def test_cpu_avx512(self):
+        if not cpu_has_flag("avx512f"):
+            pytest.skip("the host cpu has no avx512f")
+        return self.run_cases(self.args_avx512, utils.LLVM, "level1")
\ No newline at end of file
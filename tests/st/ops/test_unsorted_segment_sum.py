@@ -33,6 +33,14 @@ class TestCase(TestBase):
             ("000_case", unsorted_segment_sum_run, ((108365, 8, 1), (108365,), 19717, "float32"), ["level0"]),
         ]
 
+        # few segments over many rows, accumulated in private copies of the output on cpu, one per thread
+        self.args_cpu = [
+            ("101_case", unsorted_segment_sum_run, ((65536, 32), (65536,), 64, "float32", {"cpu_thread_num": 8}),
+             ["level0"]),
+            ("102_case", unsorted_segment_sum_run, ((16384, 4, 16), (16384,), 8, "float32", {"cpu_thread_num": 4}),
+             ["level0"]),
+        ]
+
         self.args_ascend = [
             # testflag, opfuncname, testRunArgs, dimArgs
             ("001_uss_1280_1024_8192_fp16", unsorted_segment_sum_run, ([1280, 1024], [1280], 8192, "float16"), ["level0"]),
@@ -80,4 +88,10 @@ class TestCase(TestBase):
     # @pytest.mark.platform_x86_cpu
     # @pytest.mark.env_onecard
     # def test_cpu_level0(self):
-    #     return self.run_cases(self.test_args, utils.LLVM, "level0")
\ No newline at end of file
+    #     return self.run_cases(self.test_args, utils.LLVM, "level0")
+
+    @pytest.mark.level0
+    @pytest.mark.platform_x86_cpu
+    @pytest.mark.env_onecard
+    def test_cpu_segment_level0(self):
+        return self.run_cases(self.args_cpu, utils.LLVM, "level0")
\ No newline at end of file
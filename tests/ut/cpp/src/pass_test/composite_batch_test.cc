@@ -0,0 +1,86 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include "composite/composite_batch.h"
+
+namespace akg {
+namespace {
+Map<std::string, NodeRef> MakeKernel(const std::string &json_str) {
+  Map<std::string, NodeRef> leaf;
+  leaf.Set("json_str", StringImm::make(json_str));
+  leaf.Set("attrs", Map<std::string, NodeRef>());
+  Map<std::string, NodeRef> infos;
+  infos.Set("P", Array<NodeRef>({leaf}));
+  Map<std::string, NodeRef> kernel;
+  kernel.Set(lower::kBatchTarget, StringImm::make("cpu"));
+  kernel.Set(lower::kBatchPoly, Expr(1));
+  kernel.Set(lower::kBatchSegmentTree, StringImm::make("Normal0[P0]"));
+  kernel.Set(lower::kBatchSegmentInfos, infos);
+  return kernel;
+}
+}  // namespace
+
+TEST(CompositeBatchTest, CanonicalizeIgnoresJsonKeyOrder) {
+  auto a = MakeKernel(R"({"op": "Fused_Add", "op_desc": [{"name": "Add"}]})");
+  auto b = MakeKernel(R"({"op_desc": [{"name": "Add"}], "op": "Fused_Add"})");
+  auto c = MakeKernel(R"({"op": "Fused_Mul", "op_desc": [{"name": "Mul"}]})");
+  EXPECT_EQ(lower::CanonicalizeKernel(a), lower::CanonicalizeKernel(b));
+  EXPECT_NE(lower::CanonicalizeKernel(a), lower::CanonicalizeKernel(c));
+}
+
+TEST(CompositeBatchTest, CanonicalizeIgnoresKernelName) {
+  auto a = MakeKernel(R"({"op": "Fused_Add_1", "op_desc": [{"name": "Add"}]})");
+  auto b = MakeKernel(R"({"op": "Fused_Add_2", "op_desc": [{"name": "Add"}]})");
+  std::vector<std::string> names;
+  EXPECT_EQ(lower::CanonicalizeKernel(a, &names), lower::CanonicalizeKernel(b));
+  EXPECT_EQ(names, std::vector<std::string>({"Fused_Add_1"}));
+}
+
+TEST(CompositeBatchTest, ReplaceNamesPrefersLongestName) {
+  std::string text = "define void @Fused_Add_kernel0() {\n  call void @Fused_Add_1_split()\n}";
+  EXPECT_EQ(lower::ReplaceNames(text, {"Fused_Add", "Fused_Add_1"}, {"Fused_Sub", "Fused_Mul_7"}),
+            "define void @Fused_Sub_kernel0() {\n  call void @Fused_Mul_7_split()\n}");
+}
+
+TEST(CompositeBatchTest, ResultsIndexedLikeKernels) {
+  Array<Map<std::string, NodeRef>> kernels = {MakeKernel("{"), MakeKernel("not json")};
+  auto result = lower::LowerCompositeBatchToModule(kernels, 1, PackedFunc());
+  ASSERT_EQ(result.modules.size(), 2u);
+  ASSERT_EQ(result.errors.size(), 2u);
+  for (size_t i = 0; i < kernels.size(); ++i) {
+    EXPECT_FALSE(result.modules[i].defined());
+    EXPECT_FALSE(result.errors[i].empty());
+  }
+}
+
+TEST(CompositeBatchTest, EstimateCompileCost) {
+  auto elemwise = MakeKernel(R"({"op_desc": [{"name": "Add"}, {"name": "Mul"}]})");
+  auto matmul = MakeKernel(R"({"op_desc": [{"name": "MatMul"}, {"name": "Add"}]})");
+  EXPECT_EQ(lower::EstimateCompileCost(elemwise), 2);
+  EXPECT_GT(lower::EstimateCompileCost(matmul), lower::EstimateCompileCost(elemwise));
+}
+
+TEST(CompositeBatchTest, PlanDedupesAndOrdersByCost) {
+  auto plan = lower::PlanBatch({"a", "b", "a", "c", "b"}, {1, 5, 1, 5, 5});
+  ASSERT_EQ(plan.leaders.size(), 3u);
+  // the costly kernels first, in input order
+  EXPECT_EQ(plan.leaders[0], 1u);
+  EXPECT_EQ(plan.leaders[1], 3u);
+  EXPECT_EQ(plan.leaders[2], 0u);
+  std::vector<size_t> slot_of = {2, 0, 2, 1, 0};
+  EXPECT_EQ(plan.slot_of, slot_of);
+}
+}  // namespace akg
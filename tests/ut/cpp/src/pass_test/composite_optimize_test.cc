@@ -0,0 +1,151 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include "composite/optimize/pass.h"
+#include "composite/parser.h"
+
+namespace akg {
+namespace {
+std::string Desc(const std::string &name, const std::string &shape = "[16]", const std::string &dtype = "float32") {
+  return R"({"tensor_name": ")" + name + R"(", "shape": )" + shape + R"(, "data_type": ")" + dtype +
+         R"(", "format": "DefaultFormat"})";
+}
+
+std::string ConstDesc(const std::string &name, double value, const std::string &dtype = "float32") {
+  return R"({"tensor_name": ")" + name + R"(", "shape": [1], "data_type": ")" + dtype + R"(", "value": )" +
+         std::to_string(value) + R"(, "format": "DefaultFormat"})";
+}
+
+std::string Op(const std::string &name, const std::vector<std::string> &inputs, const std::string &output,
+               const std::string &attrs = "[]") {
+  std::string input_desc;
+  for (const auto &input : inputs) {
+    input_desc += (input_desc.empty() ? "[" : ", [") + input + "]";
+  }
+  return R"({"name": ")" + name + R"(", "attr": )" + attrs + R"(, "input_desc": [)" + input_desc +
+         R"(], "output_desc": [)" + output + "]}";
+}
+
+std::string Kernel(const std::vector<std::string> &inputs, const std::vector<std::string> &outputs,
+                   const std::vector<std::string> &ops) {
+  auto join = [](const std::vector<std::string> &items, bool nested) {
+    std::string res;
+    for (const auto &item : items) {
+      res += (res.empty() ? "" : ", ") + (nested ? "[" + item + "]" : item);
+    }
+    return res;
+  };
+  return R"({"op": "Fused_test", "process": "cpu", "input_desc": [)" + join(inputs, true) + R"(], "output_desc": [)" +
+         join(outputs, false) + R"(], "op_desc": [)" + join(ops, false) + "]}";
+}
+
+std::vector<const Call *> OpCalls(const Stmt &s) {
+  std::vector<const Call *> calls;
+  PostOrderVisit(s, [&calls](const NodeRef &node) {
+    if (auto provide = node.as<Provide>()) {
+      calls.push_back(provide->value.as<Call>());
+    }
+  });
+  return calls;
+}
+
+std::string InputName(const Call *call, size_t i) {
+  auto tensor = call->args[i].as<Call>();
+  return tensor == nullptr ? "" : tensor->name;
+}
+}  // namespace
+
+TEST(CompositeOptimizeTest, MergeDuplicateCasts) {
+  auto cast_attr = R"([{"name": "dst_type", "value": "float32"}])";
+  auto json = Kernel({Desc("x", "[16]", "float16")}, {Desc("out")},
+                     {Op("Cast", {Desc("x", "[16]", "float16")}, Desc("a"), cast_attr),
+                      Op("Cast", {Desc("x", "[16]", "float16")}, Desc("b"), cast_attr),
+                      Op("Add", {Desc("a"), Desc("b")}, Desc("out"))});
+  BuildInfo info;
+  auto stmt = CommonSubexprElim(Parse(String2Json(json), info), &info);
+  auto calls = OpCalls(stmt);
+  ASSERT_EQ(calls.size(), 2u);
+  EXPECT_EQ(calls[0]->name, "Cast");
+  EXPECT_EQ(calls[1]->name, "Add");
+  EXPECT_EQ(InputName(calls[1], 0), "a");
+  EXPECT_EQ(InputName(calls[1], 1), "a");
+}
+
+TEST(CompositeOptimizeTest, KeepOpsWithDifferentAttrs) {
+  auto json = Kernel({Desc("x", "[16, 16]")}, {Desc("out")},
+                     {Op("ReduceSum", {Desc("x", "[16, 16]")}, Desc("a"),
+                         R"([{"name": "axis", "value": [0]}, {"name": "keep_dims", "value": false}])"),
+                      Op("ReduceSum", {Desc("x", "[16, 16]")}, Desc("b"),
+                         R"([{"name": "axis", "value": [1]}, {"name": "keep_dims", "value": false}])"),
+                      Op("Add", {Desc("a"), Desc("b")}, Desc("out"))});
+  BuildInfo info;
+  auto stmt = CommonSubexprElim(Parse(String2Json(json), info), &info);
+  EXPECT_EQ(OpCalls(stmt).size(), 3u);
+}
+
+TEST(CompositeOptimizeTest, KeepDuplicateOutputs) {
+  auto json = Kernel({Desc("x"), Desc("y")}, {Desc("a"), Desc("b")},
+                     {Op("Mul", {Desc("x"), Desc("y")}, Desc("a")), Op("Mul", {Desc("x"), Desc("y")}, Desc("b"))});
+  BuildInfo info;
+  auto stmt = CommonSubexprElim(Parse(String2Json(json), info), &info);
+  EXPECT_EQ(OpCalls(stmt).size(), 2u);
+}
+
+TEST(CompositeOptimizeTest, FoldScalarChain) {
+  // out = x + sqrt(2 * 8)
+  auto json = Kernel({Desc("x")}, {Desc("out")},
+                     {Op("Mul", {ConstDesc("c0", 2.0), ConstDesc("c1", 8.0)}, Desc("m", "[1]")),
+                      Op("Sqrt", {Desc("m", "[1]")}, Desc("s", "[1]")),
+                      Op("Add", {Desc("x"), Desc("s", "[1]")}, Desc("out"))});
+  BuildInfo info;
+  auto stmt = ConstantFolding(Parse(String2Json(json), info), &info);
+  auto calls = OpCalls(stmt);
+  ASSERT_EQ(calls.size(), 1u);
+  EXPECT_EQ(calls[0]->name, "Add");
+  auto value = calls[0]->args[1].as<FloatImm>();
+  ASSERT_NE(value, nullptr);
+  EXPECT_DOUBLE_EQ(value->value, 4.0);
+}
+
+TEST(CompositeOptimizeTest, RoundFoldedValueToType) {
+  // out = x + 1 / 3 in float16
+  auto json = Kernel({Desc("x", "[16]", "float16")}, {Desc("out", "[16]", "float16")},
+                     {Op("RealDiv", {ConstDesc("c0", 1.0, "float16"), ConstDesc("c1", 3.0, "float16")},
+                         Desc("d", "[1]", "float16")),
+                      Op("Add", {Desc("x", "[16]", "float16"), Desc("d", "[1]", "float16")},
+                         Desc("out", "[16]", "float16"))});
+  BuildInfo info;
+  auto stmt = ConstantFolding(Parse(String2Json(json), info), &info);
+  auto calls = OpCalls(stmt);
+  ASSERT_EQ(calls.size(), 1u);
+  auto value = calls[0]->args[1].as<FloatImm>();
+  ASSERT_NE(value, nullptr);
+  // 0x3555, the float16 nearest to 1 / 3
+  EXPECT_DOUBLE_EQ(value->value, 0.333251953125);
+}
+
+TEST(CompositeOptimizeTest, KeepConstantOfNonElemwiseConsumer) {
+  auto json = Kernel({Desc("x")}, {Desc("out")},
+                     {Op("Mul", {ConstDesc("c0", 2.0), ConstDesc("c1", 3.0)}, Desc("m", "[1]")),
+                      Op("BroadcastTo", {Desc("m", "[1]")}, Desc("b"), R"([{"name": "shape", "value": [16]}])"),
+                      Op("Add", {Desc("x"), Desc("b")}, Desc("out"))});
+  BuildInfo info;
+  auto stmt = ConstantFolding(Parse(String2Json(json), info), &info);
+  auto calls = OpCalls(stmt);
+  ASSERT_EQ(calls.size(), 3u);
+  EXPECT_EQ(calls[0]->name, "Mul");
+}
+}  // namespace akg
@@ -0,0 +1,67 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include <tvm/ir.h>
+#include <tvm/ir_pass.h>
+#include "ir_pass.h"
+
+namespace akg {
+namespace {
+using air::ir::Call;
+using air::ir::Load;
+using air::ir::Ramp;
+using air::ir::Store;
+
+constexpr int kLanes = 8;
+
+// Y[ramp(0, 1, 8)] = name(X[ramp(0, 1, 8)])
+Stmt MakeMathStore(const std::string &name) {
+  Var x("X", air::Handle());
+  Var y("Y", air::Handle());
+  Expr index = Ramp::make(0, 1, kLanes);
+  Expr value = Load::make(air::Float(32, kLanes), x, index, air::const_true(kLanes));
+  Expr call = Call::make(air::Float(32, kLanes), name, {value}, Call::PureIntrinsic);
+  return Store::make(y, call, index, air::const_true(kLanes));
+}
+
+std::vector<std::string> CallNames(const Stmt &stmt) {
+  std::vector<std::string> names;
+  air::ir::PostOrderVisit(stmt, [&names](const NodeRef &node) {
+    if (auto call = node.as<Call>()) {
+      names.push_back(call->name);
+    }
+  });
+  return names;
+}
+}  // namespace
+
+TEST(CpuFastMathTest, RenamesCallsWithFastRules) {
+  for (const std::string name : {"exp", "tanh", "sigmoid", "rsqrt"}) {
+    Stmt stmt = ir::UseFastMath(MakeMathStore(name));
+    EXPECT_EQ(CallNames(stmt), std::vector<std::string>{"fast_" + name});
+  }
+}
+
+TEST(CpuFastMathTest, KeepsOtherCalls) {
+  for (const std::string name : {"log", "erf", "sin", "cos"}) {
+    Stmt stmt = MakeMathStore(name);
+    EXPECT_TRUE(ir::UseFastMath(stmt).same_as(stmt));
+  }
+}
+}  // namespace akg
@@ -0,0 +1,172 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <tvm/ir.h>
+#include <tvm/ir_pass.h>
+#include <tvm/operation.h>
+#include "ir_pass.h"
+
+namespace akg {
+namespace {
+using air::ir::AttrStmt;
+using air::ir::Cast;
+using air::ir::Evaluate;
+using air::ir::For;
+using air::ir::ForType;
+using air::ir::Max;
+using air::ir::Provide;
+
+constexpr int kRows = 64;
+constexpr int kCols = 32;
+
+struct Gemm {
+  Tensor local = air::placeholder({kRows, kCols}, air::Float(32), "compute_local");
+  Tensor out = air::placeholder({kRows, kCols}, air::Float(32), "compute");
+  Tensor bias = air::placeholder({kCols}, air::Float(32), "bias");
+};
+
+// for (i, 0, 64) for (j, 0, 32) body, the outer loop parallel
+Stmt MakeNest(const std::string &prefix, const std::function<Stmt(const Var &, const Var &)> &body) {
+  Var i(prefix + "i");
+  Var j(prefix + "j");
+  Stmt stmt = For::make(j, 0, kCols, ForType::Serial, air::ir::DeviceAPI::None, body(i, j));
+  return For::make(i, 0, kRows, ForType::Parallel, air::ir::DeviceAPI::None, stmt);
+}
+
+// the packed gemm writes compute from its register tile
+Stmt MakeGemm(const Gemm &gemm) {
+  Stmt pack = AttrStmt::make(gemm.local->op, "pack_a", 0, Evaluate::make(0));
+  Stmt write = MakeNest("cc", [&gemm](const Var &i, const Var &j) {
+    return Provide::make(gemm.out->op, 0, gemm.local(i, j), {i, j});
+  });
+  return air::ir::Block::make(pack, write);
+}
+
+Stmt MakeElemwise(const Tensor &dst, const std::function<Expr(const Var &, const Var &)> &value) {
+  return MakeNest(dst->op->name, [&dst, &value](const Var &i, const Var &j) {
+    return Provide::make(dst->op, 0, value(i, j), {i, j});
+  });
+}
+
+int ParallelLoops(const Stmt &stmt) {
+  int loops = 0;
+  air::ir::PostOrderVisit(stmt, [&loops](const NodeRef &node) {
+    auto loop = node.as<For>();
+    if (loop != nullptr && loop->for_type == ForType::Parallel) {
+      ++loops;
+    }
+  });
+  return loops;
+}
+
+// whether stmt reads t
+bool Reads(const Stmt &stmt, const Tensor &t) {
+  bool found = false;
+  air::ir::PostOrderVisit(stmt, [&found, &t](const NodeRef &node) {
+    auto call = node.as<air::ir::Call>();
+    if (call != nullptr && call->func.same_as(t->op)) {
+      found = true;
+    }
+  });
+  return found;
+}
+}  // namespace
+
+TEST(CpuGemmEpilogueTest, FoldsBiasAddAndActivation) {
+  Gemm gemm;
+  Tensor add = air::placeholder({kRows, kCols}, air::Float(32), "T_add");
+  Tensor relu = air::placeholder({kRows, kCols}, air::Float(32), "T_relu");
+  Stmt bias_add =
+    MakeElemwise(add, [&gemm](const Var &i, const Var &j) { return gemm.out(i, j) + gemm.bias(j); });
+  Stmt activation =
+    MakeElemwise(relu, [&add](const Var &i, const Var &j) { return Max::make(add(i, j), air::make_zero(add->dtype)); });
+  Stmt stmt = air::ir::Block::make({MakeGemm(gemm), bias_add, activation});
+  Stmt fused = ir::FuseCpuGemmEpilogue(stmt);
+  EXPECT_EQ(ParallelLoops(fused), 1);
+  // the activation is computed from the register tile, nothing reads C or the bias-add back
+  EXPECT_FALSE(Reads(fused, gemm.out));
+  EXPECT_FALSE(Reads(fused, add));
+}
+
+TEST(CpuGemmEpilogueTest, FoldsResidualAddAndCast) {
+  Gemm gemm;
+  Tensor residual = air::placeholder({kRows, kCols}, air::Float(32), "residual");
+  Tensor add = air::placeholder({kRows, kCols}, air::Float(32), "T_add");
+  Tensor cast = air::placeholder({kRows, kCols}, air::Float(16), "T_cast");
+  // both provides of one nest
+  Stmt epilogue = MakeNest("ee", [&](const Var &i, const Var &j) {
+    return air::ir::Block::make(
+      Provide::make(add->op, 0, gemm.out(i, j) + gemm.bias(j) + residual(i, j), {i, j}),
+      Provide::make(cast->op, 0, Cast::make(air::Float(16), add(i, j)), {i, j}));
+  });
+  Stmt fused = ir::FuseCpuGemmEpilogue(air::ir::Block::make(MakeGemm(gemm), epilogue));
+  EXPECT_EQ(ParallelLoops(fused), 1);
+  EXPECT_FALSE(Reads(fused, gemm.out));
+  EXPECT_FALSE(Reads(fused, add));
+  EXPECT_TRUE(Reads(fused, residual));
+}
+
+TEST(CpuGemmEpilogueTest, ReloadsAccumulatedOutput) {
+  Gemm gemm;
+  Tensor add = air::placeholder({kRows, kCols}, air::Float(32), "T_add");
+  Stmt pack = AttrStmt::make(gemm.local->op, "pack_a", 0, Evaluate::make(0));
+  // the last k block adds its register tile to C
+  Stmt write = MakeNest("cc", [&gemm](const Var &i, const Var &j) {
+    return Provide::make(gemm.out->op, 0, gemm.out(i, j) + gemm.local(i, j), {i, j});
+  });
+  Stmt epilogue =
+    MakeElemwise(add, [&gemm](const Var &i, const Var &j) { return gemm.out(i, j) + gemm.bias(j); });
+  Stmt fused = ir::FuseCpuGemmEpilogue(air::ir::Block::make({pack, write, epilogue}));
+  EXPECT_EQ(ParallelLoops(fused), 1);
+  Stmt fused_add;
+  air::ir::PostOrderVisit(fused, [&fused_add, &add](const NodeRef &node) {
+    auto provide = node.as<Provide>();
+    if (provide != nullptr && provide->func.same_as(add->op)) {
+      fused_add = GetRef<Stmt>(provide);
+    }
+  });
+  ASSERT_TRUE(fused_add.defined());
+  // C + C_local would add the tile twice, the epilogue reads the sum back from C
+  EXPECT_TRUE(Reads(fused_add, gemm.out));
+  EXPECT_FALSE(Reads(fused_add, gemm.local));
+}
+
+TEST(CpuGemmEpilogueTest, KeepsEpilogueOfOtherIndices) {
+  Gemm gemm;
+  Tensor add = air::placeholder({kRows, kCols}, air::Float(32), "T_add");
+  // reads C one row ahead, which the write of C has not produced yet
+  Stmt epilogue = MakeElemwise(add, [&gemm](const Var &i, const Var &j) {
+    return gemm.out(air::ir::Min::make(i + 1, kRows - 1), j) + gemm.bias(j);
+  });
+  Stmt stmt = air::ir::Block::make(MakeGemm(gemm), epilogue);
+  EXPECT_EQ(ParallelLoops(ir::FuseCpuGemmEpilogue(stmt)), 2);
+}
+
+TEST(CpuGemmEpilogueTest, KeepsNestWithoutGemm) {
+  Gemm gemm;
+  Tensor add = air::placeholder({kRows, kCols}, air::Float(32), "T_add");
+  Stmt write = MakeNest("cc", [&gemm](const Var &i, const Var &j) {
+    return Provide::make(gemm.out->op, 0, gemm.local(i, j), {i, j});
+  });
+  Stmt stmt = air::ir::Block::make(
+    write, MakeElemwise(add, [&gemm](const Var &i, const Var &j) { return gemm.out(i, j) + gemm.bias(j); }));
+  EXPECT_TRUE(ir::FuseCpuGemmEpilogue(stmt).same_as(stmt));
+}
+}  // namespace akg
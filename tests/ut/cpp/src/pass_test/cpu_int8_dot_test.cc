@@ -0,0 +1,102 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <tvm/ir.h>
+#include <tvm/ir_pass.h>
+#include "ir_pass.h"
+
+namespace akg {
+namespace {
+using air::ir::Broadcast;
+using air::ir::Call;
+using air::ir::Cast;
+using air::ir::For;
+using air::ir::ForType;
+using air::ir::Load;
+using air::ir::Ramp;
+using air::ir::Store;
+
+constexpr int kLanes = 8;
+
+/*
+ * for (k, 0, extent) {
+ *   C[c_index] = C[c_index] + x8(int32(A[k])) * int32(B[ramp(b_index, b_stride, 8)])
+ * }
+ */
+Stmt MakeReduction(const Var &k, int extent, const Expr &b_index, int b_stride,
+                   const Expr &c_index = Ramp::make(0, 1, kLanes)) {
+  Var a("A", air::Handle());
+  Var b("B", air::Handle());
+  Var c("C", air::Handle());
+  Expr acc = Load::make(air::Int(32, kLanes), c, c_index, air::const_true(kLanes));
+  Expr a_value = Broadcast::make(Cast::make(air::Int(32), Load::make(air::UInt(8), a, k, air::const_true())), kLanes);
+  Expr b_value = Cast::make(air::Int(32, kLanes), Load::make(air::Int(8, kLanes), b, Ramp::make(b_index, b_stride, kLanes),
+                                                             air::const_true(kLanes)));
+  Stmt store = Store::make(c, acc + a_value * b_value, c_index, air::const_true(kLanes));
+  return For::make(k, 0, extent, ForType::Serial, air::ir::DeviceAPI::None, store);
+}
+
+int CountDots(const Stmt &stmt) {
+  int count = 0;
+  air::ir::PostOrderVisit(stmt, [&count](const NodeRef &node) {
+    auto call = node.as<Call>();
+    count += (call != nullptr && call->is_intrinsic(air::ir::intrinsic::akg_dot_u8s8)) ? 1 : 0;
+  });
+  return count;
+}
+}  // namespace
+
+TEST(CpuInt8DotTest, FoldsGroupsOfFourAndKeepsTail) {
+  Var k("k");
+  Stmt stmt = ir::EmitCpuInt8Dot(MakeReduction(k, 10, k * kLanes, 1));
+  auto block = stmt.as<air::ir::Block>();
+  ASSERT_NE(block, nullptr);
+  auto main = block->first.as<For>();
+  auto tail = block->rest.as<For>();
+  ASSERT_NE(main, nullptr);
+  ASSERT_NE(tail, nullptr);
+  EXPECT_TRUE(air::is_const_int(main->extent, 2));
+  EXPECT_TRUE(air::is_const_int(tail->min, 8));
+  EXPECT_TRUE(air::is_const_int(tail->extent, 2));
+  EXPECT_EQ(CountDots(main->body), 1);
+  EXPECT_EQ(CountDots(tail->body), 0);
+}
+
+TEST(CpuInt8DotTest, LoadsPackedOperandAsOneVector) {
+  // u8s8 packed layout: the four k of a lane are next to each other
+  Var k("k");
+  Expr index = air::floordiv(k, 4) * (kLanes * 4) + air::floormod(k, 4);
+  Stmt stmt = ir::EmitCpuInt8Dot(MakeReduction(k, 16, index, 4));
+  auto loop = stmt.as<For>();
+  ASSERT_NE(loop, nullptr);
+  EXPECT_TRUE(air::is_const_int(loop->extent, 4));
+  bool has_shuffle = false;
+  bool has_wide_load = false;
+  air::ir::PostOrderVisit(stmt, [&has_shuffle, &has_wide_load](const NodeRef &node) {
+    has_shuffle = has_shuffle || node.as<air::ir::Shuffle>() != nullptr;
+    auto load = node.as<Load>();
+    has_wide_load = has_wide_load || (load != nullptr && load->type == air::Int(8, kLanes * 4));
+  });
+  EXPECT_FALSE(has_shuffle);
+  EXPECT_TRUE(has_wide_load);
+}
+
+TEST(CpuInt8DotTest, SkipsAccumulatorIndexedByReduction) {
+  Var k("k");
+  Stmt stmt = MakeReduction(k, 8, k * kLanes, 1, Ramp::make(k * kLanes, 1, kLanes));
+  EXPECT_TRUE(ir::EmitCpuInt8Dot(stmt).same_as(stmt));
+}
+}  // namespace akg
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <tvm/buffer.h>
+#include <tvm/ir.h>
+#include <tvm/ir_pass.h>
+#include "ir_pass.h"
+#include "pass/utils.h"
+
+namespace akg {
+namespace {
+using air::ir::AttrStmt;
+using air::ir::Call;
+using air::ir::For;
+using air::ir::ForType;
+using air::ir::Load;
+using air::ir::Ramp;
+using air::ir::Store;
+
+constexpr int kLanes = 8;
+// 32MB of float32, beyond the non-temporal threshold of the pass
+constexpr int kRows = 1024;
+constexpr int kCols = 8192;
+
+/*
+ * // attr [INFO] STREAM_OP = "..."
+ * for (i, 0, 1024) {       // parallel
+ *   for (j, 0, 1024) {
+ *     C[ramp(i*8192 + j*8, 1, 8)] = A[ramp(i*8192 + j*8, 1, 8)]
+ *   }
+ * }
+ */
+Stmt MakeCopy(const air::Buffer &a, const air::Buffer &c, ForType outer_type) {
+  Var i("i");
+  Var j("j");
+  Expr index = Ramp::make(i * kCols + j * kLanes, 1, kLanes);
+  Stmt store = Store::make(c->data, Load::make(air::Float(32, kLanes), a->data, index, air::const_true(kLanes)),
+                           index, air::const_true(kLanes));
+  Stmt inner = For::make(j, 0, kCols / kLanes, ForType::Serial, air::ir::DeviceAPI::None, store);
+  Stmt outer = For::make(i, 0, kRows, outer_type, air::ir::DeviceAPI::None, inner);
+  return AttrStmt::make(Expr("INFO"), ir::AKG_STREAM_OP, Expr("Elemwise"), outer);
+}
+
+air::Buffer MakeBuffer(const std::string &name) {
+  return air::BufferNode::make(Var(name, air::Handle()), air::Float(32), {kRows, kCols}, {}, Expr(), name, "", 0, 0,
+                               air::kDefault);
+}
+
+int CountPrefetches(const Stmt &stmt) {
+  int prefetches = 0;
+  air::ir::PostOrderVisit(stmt, [&prefetches](const NodeRef &node) {
+    auto call = node.as<Call>();
+    if (call != nullptr && call->is_intrinsic(Call::prefetch)) {
+      ++prefetches;
+    }
+  });
+  return prefetches;
+}
+}  // namespace
+
+TEST(CpuStreamHintTest, ScopeEnclosesParallelLoop) {
+  auto a = MakeBuffer("A");
+  auto c = MakeBuffer("C");
+  Stmt stmt = ir::InjectCpuStreamHint(MakeCopy(a, c, ForType::Parallel), {a, c});
+  EXPECT_EQ(CountPrefetches(stmt), 1);
+  int scopes = 0;
+  air::ir::PostOrderVisit(stmt, [&scopes, &c](const NodeRef &node) {
+    auto attr = node.as<AttrStmt>();
+    if (attr == nullptr || attr->attr_key != air::ir::attr::nontemporal_scope) {
+      return;
+    }
+    ++scopes;
+    EXPECT_TRUE(attr->node.same_as(c->data));
+    // the tasks fence once after their loop, not once per iteration
+    auto loop = attr->body.as<For>();
+    ASSERT_NE(loop, nullptr);
+    EXPECT_EQ(loop->for_type, ForType::Parallel);
+  });
+  EXPECT_EQ(scopes, 1);
+}
+
+TEST(CpuStreamHintTest, ScopeEnclosesSerialKernel) {
+  auto a = MakeBuffer("A");
+  auto c = MakeBuffer("C");
+  Stmt stmt = ir::InjectCpuStreamHint(MakeCopy(a, c, ForType::Serial), {a, c});
+  auto attr = stmt.as<AttrStmt>();
+  ASSERT_NE(attr, nullptr);
+  EXPECT_EQ(attr->attr_key, air::ir::attr::nontemporal_scope);
+}
+}  // namespace akg
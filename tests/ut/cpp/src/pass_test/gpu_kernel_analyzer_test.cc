@@ -0,0 +1,106 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <tvm/ir.h>
+#include <tvm/lowered_func.h>
+#include "pass/gpu_kernel_analyzer.h"
+
+namespace akg {
+namespace {
+using air::ir::AttrStmt;
+using air::ir::Load;
+using air::ir::Store;
+
+constexpr int kBlocks = 64;
+constexpr int kThreads = 256;
+
+/*
+ * // attr [iter_var(blockIdx.x)] thread_extent = 64
+ * // attr [iter_var(threadIdx.x)] thread_extent = 256
+ * // attr [S] storage_scope = "shared"
+ * allocate S[float32 * 256]
+ * B[blockIdx.x*256 + threadIdx.x] = A[blockIdx.x*256 + threadIdx.x]*2f
+ * C[threadIdx.x*64 + blockIdx.x] = A[blockIdx.x*256 + threadIdx.x]
+ */
+LoweredFunc MakeKernel() {
+  Var a("A", air::Handle());
+  Var b("B", air::Handle());
+  Var c("C", air::Handle());
+  Var s("S", air::Handle());
+  IterVar bx = air::IterVarNode::make(Range(0, kBlocks), Var("blockIdx.x"), air::kThreadIndex, "blockIdx.x");
+  IterVar tx = air::IterVarNode::make(Range(0, kThreads), Var("threadIdx.x"), air::kThreadIndex, "threadIdx.x");
+  Expr row = bx->var * kThreads + tx->var;
+  Expr value = Load::make(air::Float(32), a, row, air::const_true());
+  Stmt body = air::ir::Block::make(
+    Store::make(b, value * air::make_const(air::Float(32), 2), row, air::const_true()),
+    Store::make(c, value, tx->var * kBlocks + bx->var, air::const_true()));
+  body = air::ir::Allocate::make(s, air::Float(32), {kThreads}, air::const_true(), body);
+  body = AttrStmt::make(s, air::ir::attr::storage_scope, air::ir::StringImm::make("shared"), body);
+  body = AttrStmt::make(tx, air::ir::attr::thread_extent, kThreads, body);
+  body = AttrStmt::make(bx, air::ir::attr::thread_extent, kBlocks, body);
+
+  auto n = air::make_node<air::LoweredFuncNode>();
+  n->name = "strided_kernel";
+  n->args = {a, b, c};
+  n->func_type = air::kDeviceFunc;
+  n->body = body;
+  return LoweredFunc(n);
+}
+}  // namespace
+
+TEST(GpuKernelAnalyzerTest, OccupancyLimitedByThreads) {
+  ir::GpuSmConfig sm;
+  auto occ = ir::ComputeGpuOccupancy(sm, 1024, 32, 0);
+  EXPECT_EQ(occ.active_blocks_per_sm, 2);
+  EXPECT_DOUBLE_EQ(occ.occupancy, 1.0);
+}
+
+TEST(GpuKernelAnalyzerTest, OccupancyLimitedByRegisters) {
+  ir::GpuSmConfig sm;
+  auto occ = ir::ComputeGpuOccupancy(sm, 256, 128, 0);
+  EXPECT_EQ(occ.active_blocks_per_sm, 2);
+  EXPECT_EQ(occ.limiter, "registers");
+  EXPECT_DOUBLE_EQ(occ.occupancy, 0.25);
+}
+
+TEST(GpuKernelAnalyzerTest, OccupancyLimitedBySharedMemory) {
+  ir::GpuSmConfig sm;
+  auto occ = ir::ComputeGpuOccupancy(sm, 128, 32, 40 * 1024);
+  EXPECT_EQ(occ.active_blocks_per_sm, 2);
+  EXPECT_EQ(occ.limiter, "shared");
+}
+
+TEST(GpuKernelAnalyzerTest, BlockCannotBeResident) {
+  ir::GpuSmConfig sm;
+  EXPECT_DOUBLE_EQ(ir::ComputeGpuOccupancy(sm, 2048, 32, 0).occupancy, 0.0);
+  EXPECT_DOUBLE_EQ(ir::ComputeGpuOccupancy(sm, 1024, 32, 64 * 1024).occupancy, 0.0);
+}
+
+TEST(GpuKernelAnalyzerTest, AnalyzeLoweredKernel) {
+  ir::GpuSmConfig sm;
+  auto report = ir::AnalyzeGpuKernel(MakeKernel(), sm);
+  EXPECT_EQ(report.name, "strided_kernel");
+  EXPECT_EQ(report.grid_size, kBlocks);
+  EXPECT_EQ(report.threads_per_block, kThreads);
+  EXPECT_EQ(report.shared_bytes, kThreads * 4);
+  EXPECT_EQ(report.coalesced_accesses, 3);
+  EXPECT_EQ(report.strided_accesses, 1);
+  EXPECT_EQ(report.flops, kBlocks * kThreads);
+  EXPECT_EQ(report.global_bytes, kBlocks * kThreads * 4 * 4);
+  EXPECT_TRUE(report.memory_bound);
+  EXPECT_GT(report.occupancy.occupancy, 0.0);
+}
+}  // namespace akg
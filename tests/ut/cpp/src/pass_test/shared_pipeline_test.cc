@@ -0,0 +1,137 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include <tvm/ir.h>
+#include <tvm/ir_pass.h>
+#include <tvm/ir_visitor.h>
+#include <tvm/lowered_func.h>
+#include "tvm.h"
+#include "codegen/codegen_cuda.h"
+
+namespace akg {
+namespace {
+using air::ir::AttrStmt;
+using air::ir::For;
+using air::ir::Load;
+using air::ir::Ramp;
+using air::ir::Store;
+
+constexpr int kThreads = 8;
+constexpr int kLanes = 8;
+constexpr int kTile = kThreads * kLanes;
+constexpr int kSteps = 16;
+
+/*
+ * // attr [iter_var(threadIdx.x)] thread_extent = 8
+ * for (k, 0, 16) {
+ *   // attr [S] storage_scope = "shared"
+ *   allocate S[float16 * 64]
+ *   // attr [S] double_buffer_scope = stages
+ *   S[ramp(threadIdx.x*8, 1, 8)] = A[ramp(k*64 + threadIdx.x*8, 1, 8)]
+ *   B[ramp(k*64 + threadIdx.x*8, 1, 8)] = S[ramp(threadIdx.x*8, 1, 8)]
+ * }
+ * The copies are vectorized to 16 bytes as VectorizeLoop leaves them before InjectDoubleBuffer.
+ */
+LoweredFunc MakeKernel(int stages) {
+  Var a("A", air::Handle());
+  Var b("B", air::Handle());
+  Var s("S", air::Handle());
+  Var k("k");
+  IterVar tx = air::IterVarNode::make(Range(0, kThreads), Var("threadIdx.x"), air::kThreadIndex, "threadIdx.x");
+  air::DataType vec = air::Float(16, kLanes);
+  Expr shared_index = Ramp::make(tx->var * kLanes, 1, kLanes);
+  Expr global_index = Ramp::make(k * kTile + tx->var * kLanes, 1, kLanes);
+  Stmt copy = Store::make(s, Load::make(vec, a, global_index, air::const_true(kLanes)), shared_index,
+                          air::const_true(kLanes));
+  copy = AttrStmt::make(s, air::ir::attr::double_buffer_scope, stages, copy);
+  Stmt compute = Store::make(b, Load::make(vec, s, shared_index, air::const_true(kLanes)), global_index,
+                             air::const_true(kLanes));
+  Stmt body =
+    air::ir::Allocate::make(s, air::Float(16), {kTile}, air::const_true(), air::ir::Block::make(copy, compute));
+  body = AttrStmt::make(s, air::ir::attr::storage_scope, air::ir::StringImm::make("shared"), body);
+  body = For::make(k, 0, kSteps, air::ir::ForType::Serial, air::ir::DeviceAPI::None, body);
+  body = AttrStmt::make(tx, air::ir::attr::thread_extent, kThreads, body);
+
+  auto n = air::make_node<air::LoweredFuncNode>();
+  n->name = "shared_pipeline_kernel";
+  n->args = {a, b};
+  n->func_type = air::kDeviceFunc;
+  n->body = air::ir::Simplify(air::ir::InjectDoubleBuffer(body, 1, true));
+  return air::ir::LowerIntrin(LoweredFunc(n), "cuda");
+}
+
+std::string CudaSource(const LoweredFunc &func) {
+  air::codegen::CodeGenCUDA cg;
+  cg.Init(false);
+  cg.AddFunction(func);
+  return cg.Finish();
+}
+
+// Collects the indices of the vector stores to one buffer.
+class StoreIndexCollector : public air::ir::IRVisitor {
+ public:
+  explicit StoreIndexCollector(const Var &buffer) : buffer_(buffer) {}
+
+  void Visit_(const Store *op) final {
+    if (op->buffer_var.same_as(buffer_) && op->value.type().lanes() > 1) {
+      indices.push_back(op->index);
+    }
+    IRVisitor::Visit_(op);
+  }
+
+  std::vector<Expr> indices;
+
+ private:
+  Var buffer_;
+};
+}  // namespace
+
+TEST(SharedPipelineTest, AsyncCopyOfVectorizedTile) {
+  std::string source = CudaSource(MakeKernel(3));
+  EXPECT_NE(source.find("#include <cuda_pipeline.h>"), std::string::npos) << source;
+  EXPECT_NE(source.find("__pipeline_memcpy_async("), std::string::npos) << source;
+  EXPECT_NE(source.find("__pipeline_commit()"), std::string::npos) << source;
+  EXPECT_NE(source.find("__pipeline_wait_prior(1)"), std::string::npos) << source;
+  // one 16 byte copy per thread and stage, the tile of a stage is 64 elements after the previous ones
+  EXPECT_NE(source.find(", 16)"), std::string::npos) << source;
+  EXPECT_NE(source.find("((half *)S + ((((k_outer + 2) % 3) * 64) + (((int)threadIdx.x) * 8)))"), std::string::npos)
+      << source;
+}
+
+TEST(SharedPipelineTest, TwoStagesKeepVectorStores) {
+  LoweredFunc func = MakeKernel(2);
+  Var shared;
+  air::ir::PostOrderVisit(func->body, [&shared](const air::NodeRef &node) {
+    if (const auto alloc = node.as<air::ir::Allocate>()) {
+      if (alloc->buffer_var->name_hint == "S") {
+        shared = alloc->buffer_var;
+      }
+    }
+  });
+  ASSERT_TRUE(shared.defined());
+  StoreIndexCollector collector(shared);
+  collector.Visit(func->body);
+  ASSERT_FALSE(collector.indices.empty());
+  for (const auto &index : collector.indices) {
+    EXPECT_NE(index.as<Ramp>(), nullptr) << index;
+  }
+  std::string source = CudaSource(func);
+  EXPECT_EQ(source.find("__pipeline_memcpy_async("), std::string::npos) << source;
+}
+}  // namespace akg
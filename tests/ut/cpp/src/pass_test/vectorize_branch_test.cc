@@ -0,0 +1,109 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <tvm/ir.h>
+#include <tvm/ir_pass.h>
+#include "ir_pass.h"
+
+namespace akg {
+namespace {
+using air::ir::For;
+using air::ir::ForType;
+using air::ir::IfThenElse;
+using air::ir::Load;
+using air::ir::Ramp;
+using air::ir::Select;
+using air::ir::Store;
+
+constexpr int kLanes = 8;
+constexpr int kRows = 1024;
+
+/*
+ * for (j, 0, 8) vectorized {
+ *   if ((0 <= idx[j]) && (idx[j] < 1024)) {
+ *     out[i*8 + j] = data[i*1024 + idx[j]] + x[i*8 + j]
+ *   } else {
+ *     out[i*8 + j] = 0f
+ *   }
+ * }
+ */
+struct GatherLoop {
+  Var i{"i"};
+  Var j{"j"};
+  Var out{"out", air::Handle()};
+  Var data{"data", air::Handle()};
+  Var x{"x", air::Handle()};
+  Var idx{"idx", air::Handle()};
+
+  Stmt Make() const {
+    Expr index = Load::make(air::Int(32), idx, j, air::const_true());
+    Expr guard = air::ir::And::make(Expr(0) <= index, index < kRows);
+    Expr dst = i * kLanes + j;
+    Expr value = Load::make(air::Float(32), data, i * kRows + index, air::const_true()) +
+                 Load::make(air::Float(32), x, dst, air::const_true());
+    Stmt branch = IfThenElse::make(guard, Store::make(out, value, dst, air::const_true()),
+                                   Store::make(out, air::make_zero(air::Float(32)), dst, air::const_true()));
+    return For::make(j, 0, kLanes, ForType::Vectorized, air::ir::DeviceAPI::None, branch);
+  }
+};
+
+const Load *FindLoad(const Stmt &stmt, const Var &buffer) {
+  const Load *found = nullptr;
+  air::ir::PostOrderVisit(stmt, [&found, &buffer](const NodeRef &node) {
+    auto load = node.as<Load>();
+    if (load != nullptr && load->buffer_var.same_as(buffer)) {
+      found = load;
+    }
+  });
+  return found;
+}
+}  // namespace
+
+TEST(VectorizeBranchTest, GuardsContiguousLoadsWithPredicate) {
+  GatherLoop loop;
+  Stmt stmt = ir::SelectVectorizedBranch(loop.Make());
+  auto store = stmt.as<For>()->body.as<Store>();
+  ASSERT_NE(store, nullptr);
+  EXPECT_NE(store->value.as<Select>(), nullptr);
+
+  auto x = FindLoad(stmt, loop.x);
+  ASSERT_NE(x, nullptr);
+  EXPECT_FALSE(air::is_one(x->predicate));
+  EXPECT_EQ(x->index.as<Select>(), nullptr);
+
+  auto data = FindLoad(stmt, loop.data);
+  ASSERT_NE(data, nullptr);
+  EXPECT_TRUE(air::is_one(data->predicate));
+  EXPECT_NE(data->index.as<Select>(), nullptr);
+}
+
+TEST(VectorizeBranchTest, ContiguousLoadsStayRamps) {
+  GatherLoop loop;
+  Stmt stmt = air::ir::VectorizeLoop(ir::SelectVectorizedBranch(loop.Make()));
+  auto x = FindLoad(stmt, loop.x);
+  ASSERT_NE(x, nullptr);
+  auto ramp = x->index.as<Ramp>();
+  ASSERT_NE(ramp, nullptr);
+  EXPECT_TRUE(air::is_one(ramp->stride));
+  EXPECT_EQ(x->predicate.type().lanes(), kLanes);
+
+  auto data = FindLoad(stmt, loop.data);
+  ASSERT_NE(data, nullptr);
+  EXPECT_EQ(data->index.as<Ramp>(), nullptr);
+  EXPECT_EQ(data->index.type().lanes(), kLanes);
+}
+}  // namespace akg
@@ -0,0 +1,101 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "poly/tiling/hermes/cpu_tiling.h"
+
+namespace akg {
+
+namespace {
+using ir::poly::Axis;
+using ir::poly::CpuHardware;
+using ir::poly::ModelGraph;
+using ir::poly::Node;
+using HermesTensor = ir::poly::Tensor;
+
+constexpr int64_t kRange = 1024;
+constexpr size_t kL1 = 32 * 1024;
+constexpr size_t kL2 = 256 * 1024;
+constexpr size_t kLine = 64;
+constexpr size_t kVectorBytes = 32;
+
+const CpuHardware kHardware(4, kL1, kL2, 8 * 1024 * 1024, kLine, kVectorBytes);
+
+Axis MakeAxis(int dim, int64_t range) {
+  Axis axis;
+  axis.dim_axis_ = dim;
+  axis.range_ = range;
+  return axis;
+}
+
+std::shared_ptr<Node> MakeNode(const std::vector<Axis> &axes) {
+  auto node = std::make_shared<Node>();
+  node->axis_of_node_ = axes;
+  node->output_tensors_.push_back(
+    std::make_shared<HermesTensor>(std::vector<int64_t>{kRange, kRange}, HermesTensor::DataType::Float32, "DefaultFormat"));
+  return node;
+}
+
+// out[i, j] = a[i, j] + bias[j] over a 1024x1024 float32 band
+ModelGraph MakeBiasAddGraph() {
+  std::vector<Axis> axes = {MakeAxis(0, kRange), MakeAxis(1, kRange)};
+  ModelGraph::global_axis_vec_ = axes;
+  ModelGraph graph;
+  graph.nodes_ = {MakeNode(axes), MakeNode({MakeAxis(1, kRange)}), MakeNode(axes)};
+  return graph;
+}
+}  // namespace
+
+TEST(TestCpuTilingCost, CacheTilesBeatScalarTiles) {
+  ModelGraph graph = MakeBiasAddGraph();
+  double scalar = ir::poly::GetCpuTilingCost(graph, kHardware, {1, 1}, {1, 1});
+  double blocked = ir::poly::GetCpuTilingCost(graph, kHardware, {64, 64}, {8, 32});
+  EXPECT_GT(scalar, 0.0);
+  EXPECT_LT(blocked, scalar);
+}
+
+TEST(TestCpuTilingCost, SpillingL2CostsMore) {
+  ModelGraph graph = MakeBiasAddGraph();
+  // the 64x256 tiles of a and out stay in L2 and bias is reused across the rows; the 64x1024 tiles spill it,
+  // so bias is fetched again for every tile
+  double resident = ir::poly::GetCpuTilingCost(graph, kHardware, {64, 256}, {8, 32});
+  double spilled = ir::poly::GetCpuTilingCost(graph, kHardware, {64, kRange}, {8, 32});
+  EXPECT_LT(resident, spilled);
+}
+
+TEST(TestCpuTilingCost, SearchKeepsInnerTilesInL1) {
+  ModelGraph graph = MakeBiasAddGraph();
+  ir::poly::GetCpuTilingSize(graph, kHardware, 1, 1);
+  const auto &axes = ModelGraph::global_axis_vec_;
+  ASSERT_EQ(axes.size(), 2u);
+  int64_t lanes = static_cast<int64_t>(kVectorBytes) / HermesTensor::kFourBytesPerVal;
+  EXPECT_GE(axes[1].c0_tiling_, lanes);
+  for (const auto &axis : axes) {
+    EXPECT_LE(axis.c0_tiling_, axis.c1_tiling_);
+    EXPECT_LE(axis.c1_tiling_, kRange);
+  }
+  // the c0 tiles of a and out alone
+  int64_t c0_bytes = 2 * axes[0].c0_tiling_ * axes[1].c0_tiling_ * HermesTensor::kFourBytesPerVal;
+  EXPECT_LE(c0_bytes, static_cast<int64_t>(kL1));
+  std::vector<int64_t> c1 = {axes[0].c1_tiling_, axes[1].c1_tiling_};
+  std::vector<int64_t> c0 = {axes[0].c0_tiling_, axes[1].c0_tiling_};
+  EXPECT_LE(ir::poly::GetCpuTilingCost(graph, kHardware, c1, c0),
+            ir::poly::GetCpuTilingCost(graph, kHardware, {1, lanes}, {1, lanes}));
+}
+}  // namespace akg
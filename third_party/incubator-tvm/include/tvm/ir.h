@@ -1568,6 +1568,8 @@ constexpr const char* coproc_scope = "coproc_scope";
 constexpr const char* coproc_uop_scope = "coproc_uop_scope";
 /*! \brief Mark the scope as volatile access for certain handle. */
 constexpr const char* volatile_scope = "volatile_scope";
+/*! \brief Mark the stores to certain handle in the scope as non-temporal. */
+constexpr const char* nontemporal_scope = "nontemporal_scope";
 /*!
  * \brief Mark the scope as generated by extern primitive.
  *  such scope can contain arbitrary ir program and we need to be careful
@@ -1994,6 +1996,17 @@ constexpr const char* akg_fragment_elem = "akg_fragment_elem";
 constexpr const char* tvm_cce_string_print = "tvm_cce_string_print";
 
 constexpr const char* sgemm_kernel_avx = "SgemmKernelAvx";
+
+/*!
+ * \brief akg intrinsic for the int8 dot product of cpu gemm.
+ *
+ *  int32xN akg_dot_u8s8(int32xN acc, uint8x(4N) a, int8x(4N) b) {
+ *    for (i = 0; i < N; ++i)
+ *      acc[i] += a[4i] * b[4i] + a[4i+1] * b[4i+1] + a[4i+2] * b[4i+2] + a[4i+3] * b[4i+3];
+ *    return acc;
+ *  }
+ */
+constexpr const char* akg_dot_u8s8 = "akg_dot_u8s8";
 }   // namespace intrinsic
 
 /*!
@@ -181,6 +181,10 @@ std::string CodeGenCUDA::Finish() {
     decl_stream << "#include <math_constants.h>\n";
   }
 
+  if (need_pipeline_h_) {
+    decl_stream << "#include <cuda_pipeline.h>\n";
+  }
+
   if (need_mma_h_) {
     if (wmma_scope == "akg") {
       decl_stream << "#include \"akg_mma_lib/wmma.hpp\"\n";
@@ -644,6 +648,9 @@ void CodeGenCUDA::VisitExpr_(const Call *op, std::ostream& os) {
       os << ")";
       return;
     }
+    if (op->name.rfind(PIPELINE_PREFIX, 0) == 0) {
+      need_pipeline_h_ = true;
+    }
     if (op->name == STANDARD_NORMAL) {
       need_random_lib_ = true;
       CHECK_GE(op->args.size(), 1);
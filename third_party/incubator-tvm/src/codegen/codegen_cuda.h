@@ -91,6 +91,7 @@ constexpr auto PARIS_ATOMIC_RETURN = "paris_reduce::ParisReturn";
 constexpr auto ORIGIN_REDUCE_LIB = "origin";
 constexpr auto PARIS_REDUCE_LIB = "paris";
 constexpr auto STANDARD_NORMAL = "StandardNormal";
+constexpr auto PIPELINE_PREFIX = "__pipeline_";
 
 class CodeGenCUDA final : public CodeGenC {
  public:
@@ -99,7 +100,7 @@ class CodeGenCUDA final : public CodeGenC {
   void AddFunction(LoweredFunc f);
   std::string Finish();
   bool need_include_path() {
-    return (enable_fp16_ || enable_int8_ || need_math_constants_h_ || need_mma_h_);
+    return (enable_fp16_ || enable_int8_ || need_math_constants_h_ || need_mma_h_ || need_pipeline_h_);
   }
   // override behavior
   void VisitStmt_(const ir::For* op) final;
@@ -155,6 +156,8 @@ class CodeGenCUDA final : public CodeGenC {
   bool need_mma_h_{false};
   // whether need random lib
   bool need_random_lib_{false};
+  // whether need cuda_pipeline.h
+  bool need_pipeline_h_{false};
 
   // whether next store will be a reinterpret_cast
   bool is_reinterpret{false};
@@ -1021,6 +1021,10 @@ void CodeGenCPU::VisitStmt_(const For* op) {
         Expr end = Min::make((task_id + make_const(t, 1)) * step, op->extent);
         CreateSerialFor(MakeValue(begin), MakeValue(end), ConstInt32(1), op->loop_var, op->body);
       }
+      // every task makes its non-temporal stores visible once, before it reports to the launcher
+      if (!nontemporal_buf_.empty()) {
+        builder_->CreateFence(llvm::AtomicOrdering::SequentiallyConsistent);
+      }
       parallel_env_.in_parallel_loop = false;
       ++parallel_env_.parallel_loop_count;
     }
@@ -37,6 +37,9 @@
  *   Adapt LLVM 15 interface support
  * 2023.08.12
  *   Adapt LLVM 15 interface support
+ * 2026.10.19
+ *   Emit fast_exp with the exp polynomial.
+ *   Emit masked loads for predicated loads.
  */
 
 #ifdef TVM_LLVM_VERSION
@@ -813,7 +816,7 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const Call* op) {
     return CreateMatrixTranspose(op);
   } else if (op->is_intrinsic("log")) {
     return CreateLog(op);
-  } else if (op->is_intrinsic("exp")) {
+  } else if (op->is_intrinsic("exp") || op->is_intrinsic("fast_exp")) {
     return CreateExp(op);
   } else {
     LOG(FATAL) << "unknown intrinsic " << op->name;
@@ -990,6 +993,9 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const Load* op) {
   llvm::Value* buffer = MakeValue(op->buffer_var);
   llvm::Value* index = MakeValue(op->index);
 
+  if (!is_one(op->predicate)) {
+    return CreateMaskedLoad(op, buffer);
+  }
   if (t.lanes() == 1) {
     int alignment, native_bits;
     GetAlignment(t, op->buffer_var.get(), op->index, &alignment, &native_bits);
@@ -1041,6 +1047,55 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const Load* op) {
   return ret;
 }
 
+// A predicated load reads nothing on the lanes whose predicate is false, which are zero. A scalar load is a
+// masked load of one lane; a vector load is masked when contiguous and a masked gather otherwise.
+llvm::Value* CodeGenLLVM::CreateMaskedLoad(const Load* op, llvm::Value* buffer) {
+  Type t = op->type;
+  CHECK_EQ(op->predicate.type().lanes(), t.lanes());
+  unsigned addrspace = llvm::dyn_cast<llvm::PointerType>(buffer->getType())->getAddressSpace();
+#if TVM_LLVM_VERSION >= 110
+  llvm::Type* vec_type = llvm::FixedVectorType::get(LLVMType(t.element_of()), t.lanes());
+#else
+  llvm::Type* vec_type = llvm::VectorType::get(LLVMType(t.element_of()), t.lanes());
+#endif
+  llvm::Value* mask = MakeValue(op->predicate);
+  if (t.lanes() == 1) {
+    mask = CreateBroadcast(mask, 1);
+  }
+  llvm::Value* zero = llvm::Constant::getNullValue(vec_type);
+  int basic_align = t.bits() / 8;
+  llvm::CallInst* load = nullptr;
+  const Ramp* ramp = op->index.as<Ramp>();
+  if (t.lanes() == 1 || (ramp != nullptr && is_one(ramp->stride))) {
+    int alignment, native_bits;
+    Expr base = t.lanes() == 1 ? op->index : ramp->base;
+    GetAlignment(t, op->buffer_var.get(), base, &alignment, &native_bits);
+    llvm::Value* ptr = CreateBufferPtr(t.element_of(), buffer, MakeValue(base));
+    ptr = builder_->CreatePointerCast(ptr, vec_type->getPointerTo(addrspace));
+#if TVM_LLVM_VERSION >= 130
+    load = builder_->CreateMaskedLoad(vec_type, ptr, llvm::Align(alignment), mask, zero);
+#elif TVM_LLVM_VERSION >= 110
+    load = builder_->CreateMaskedLoad(ptr, llvm::Align(alignment), mask, zero);
+#else
+    load = builder_->CreateMaskedLoad(ptr, alignment, mask, zero);
+#endif
+  } else {
+    llvm::Value* ptrs = CreateBufferPtr(t.element_of(), buffer, MakeValue(op->index));
+#if TVM_LLVM_VERSION >= 130
+    load = builder_->CreateMaskedGather(vec_type, ptrs, llvm::Align(basic_align), mask, zero);
+#elif TVM_LLVM_VERSION >= 110
+    load = builder_->CreateMaskedGather(ptrs, llvm::Align(basic_align), mask, zero);
+#else
+    load = builder_->CreateMaskedGather(ptrs, basic_align, mask, zero);
+#endif
+  }
+  AddAliasInfo(load, op->buffer_var.get(), Expr(), t);
+  if (t.lanes() == 1) {
+    return builder_->CreateExtractElement(load, ConstInt32(0));
+  }
+  return load;
+}
+
 llvm::Value* CodeGenLLVM::VisitExpr_(const Call* op) {
   if (op->call_type == Call::Intrinsic || op->call_type == Call::PureIntrinsic) {
     return CreateIntrinsic(op);
@@ -1123,6 +1178,10 @@ void CodeGenLLVM::VisitStmt_(const Store* op) {
         llvm::StoreInst* store = builder_->CreateAlignedStore(value, ptr, alignment, is_volatile);
 #endif
         AddAliasInfo(store, op->buffer_var.get(), op->index, op->value.type());
+        if (nontemporal_buf_.count(op->buffer_var.get())) {
+          store->setMetadata(llvm::LLVMContext::MD_nontemporal,
+                             llvm::MDNode::get(*ctx_, {llvm::ConstantAsMetadata::get(builder_->getInt32(1))}));
+        }
         return;
       }
     }
@@ -1251,6 +1310,18 @@ void CodeGenLLVM::VisitStmt_(const AttrStmt* op) {
     const Variable* v = op->node.as<Variable>();
     CHECK(v);
     volatile_buf_.insert(v);
+  } else if (op->attr_key == ir::attr::nontemporal_scope) {
+    const Variable* v = op->node.as<Variable>();
+    CHECK(v);
+    nontemporal_buf_.insert(v);
+    this->VisitStmt(op->body);
+    nontemporal_buf_.erase(v);
+    // non-temporal stores are weakly ordered, make them visible before anyone reads the buffer.
+    // Inside a parallel loop every task fences its own stores as well, see CodeGenCPU.
+    if (nontemporal_buf_.empty()) {
+      builder_->CreateFence(llvm::AtomicOrdering::SequentiallyConsistent);
+    }
+    return;
   }
   this->VisitStmt(op->body);
 }
@@ -1553,6 +1624,52 @@ llvm::Value* CodeGenLLVM::CreateMatrixTranspose8x4(llvm::Value* dst_buffer, llvm
   return store;
 }
 
+llvm::Value* CodeGenLLVM::CreateMatrixTransposeSquare(llvm::Value* dst_buffer, llvm::Value* src_buffer,
+                                                      size_t size, size_t bits) {
+#if TVM_LLVM_VERSION >= 110
+  auto align = llvm::Align(bits / 8);
+  using ShuffleMask = std::vector<int>;
+#else
+  auto align = bits / 8;
+  using ShuffleMask = std::vector<unsigned>;
+#endif
+  bool is_volatile = false;
+  auto type = DataType(kDLUInt, bits, size);
+  std::vector<llvm::Value*> rows(size);
+  for (size_t i = 0; i < size; ++i) {
+    llvm::Value* ptr = CreateBufferVecPtr(type, src_buffer, ConstInt32(i));
+    rows[i] = builder_->CreateAlignedLoad(LLVMType(type), ptr, align, is_volatile);
+  }
+
+  // The rows stay in registers. Each round swaps the off-diagonal blocks of the half, quarter, ... sized
+  // sub-tiles with two-source shuffles, which lower to lane permutes, 64-bit and 32-bit unpacks on x86.
+  for (size_t half = size / 2; half > 0; half /= 2) {
+    ShuffleMask low(size);
+    ShuffleMask high(size);
+    for (size_t j = 0; j < size; ++j) {
+      bool left = (j & half) == 0;
+      low[j] = left ? j : size + j - half;
+      high[j] = left ? j + half : size + j;
+    }
+    for (size_t i = 0; i < size; ++i) {
+      if ((i & half) != 0) {
+        continue;
+      }
+      llvm::Value* top = rows[i];
+      llvm::Value* bottom = rows[i + half];
+      rows[i] = builder_->CreateShuffleVector(top, bottom, low);
+      rows[i + half] = builder_->CreateShuffleVector(top, bottom, high);
+    }
+  }
+
+  llvm::StoreInst* store = nullptr;
+  for (size_t i = 0; i < size; ++i) {
+    llvm::Value* ptr = CreateBufferVecPtr(type, dst_buffer, ConstInt32(i));
+    store = builder_->CreateAlignedStore(rows[i], ptr, align, is_volatile);
+  }
+  return store;
+}
+
 llvm::Value* CodeGenLLVM::CreateMatrixTranspose(const Call* op) {
   const int row_pos = 2;
   const int col_pos = 3;
@@ -1572,6 +1689,8 @@ llvm::Value* CodeGenLLVM::CreateMatrixTranspose(const Call* op) {
     return CreateMatrixTranspose4x4(dst_buffer, src_buffer, row, col, bits);
   } else if (row == 8 && col == 4) {
     return CreateMatrixTranspose8x4(dst_buffer, src_buffer, row, col, bits);
+  } else if (row == col && (row == 8 || row == 16)) {
+    return CreateMatrixTransposeSquare(dst_buffer, src_buffer, row, bits);
   }
   return CreateMatrixTransposeBase(dst_buffer, src_buffer, row, col, bits);
 }
@@ -242,6 +242,7 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const Expr&)>,
   llvm::Value* CreateBroadcast(llvm::Value* value, int lanes);
   llvm::Value* CreateBufferPtr(Type t, llvm::Value* buffer, llvm::Value* index);
   llvm::Value* CreateBufferVecPtr(Type t, llvm::Value* buffer, llvm::Value* index);
+  llvm::Value* CreateMaskedLoad(const Load* op, llvm::Value* buffer);
   // Vector concatenation.
   llvm::Value* CreateVecSlice(llvm::Value* vec, int begin, int extent);
   llvm::Value* CreateVecFlip(llvm::Value* vec);
@@ -304,6 +305,8 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const Expr&)>,
   std::unordered_set<const Variable*> alias_var_set_;
   // set of volatile buffer.
   std::unordered_set<const Variable*> volatile_buf_;
+  // set of buffer whose vector stores bypass the cache.
+  std::unordered_set<const Variable*> nontemporal_buf_;
   /*! \brief Helper struct for debug infos. */
   struct DebugInfo {
     std::unique_ptr<llvm::DIBuilder> di_builder_;
@@ -326,6 +329,8 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const Expr&)>,
                                         size_t row, size_t col, size_t bits = 32);
   llvm::Value* CreateMatrixTranspose8x4(llvm::Value* dst_buffer, llvm::Value* src_buffer,
                                         size_t row, size_t col, size_t bits = 32);
+  llvm::Value* CreateMatrixTransposeSquare(llvm::Value* dst_buffer, llvm::Value* src_buffer,
+                                           size_t size, size_t bits = 32);
 };
 }  // namespace codegen
 }  // namespace air
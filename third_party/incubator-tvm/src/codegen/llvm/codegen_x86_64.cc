@@ -59,13 +59,25 @@ bool TargetHasFeature(const llvm::TargetMachine& tm, const std::string& feature)
   // return checkFeatures(MCInfo, std::string("+") + feature);
 #endif
 }
+
+// An index driven vector access: x86 gathers and scatters move 32 or 64 bit elements.
+bool IsIndexDriven(const Type& t, const Expr& index) {
+  return t.lanes() > 1 && (t.bits() == 32 || t.bits() == 64) && index.type().lanes() == t.lanes() &&
+         index.as<Ramp>() == nullptr && index.as<Broadcast>() == nullptr;
+}
 }  // namespace
 
 class CodeGenX86_64 final : public CodeGenCPU {
  public:
   llvm::Value* VisitExpr_(const Cast* op) override;
+  llvm::Value* VisitExpr_(const Load* op) override;
+  void VisitStmt_(const Store* op) override;
+  llvm::Value* CreateIntrinsic(const Call* op) override;
 
  private:
+  llvm::Value* CreateDotU8S8(const Call* op);
+  llvm::Value* CallWideningDot(llvm::Intrinsic::ID maddwd_id, int intrin_lanes, llvm::Value* acc, llvm::Value* a,
+                               llvm::Value* b, int lanes);
   llvm::Value* CallVectorIntrin(llvm::Intrinsic::ID id, size_t intrin_lanes, llvm::Type* result_ty,
                                 const std::vector<llvm::Value*>& args);
 };
@@ -109,6 +121,129 @@ llvm::Value* CodeGenX86_64::VisitExpr_(const Cast* op) {
   return CodeGenCPU::VisitExpr_(op);
 }
 
+llvm::Value* CodeGenX86_64::CreateIntrinsic(const Call* op) {
+  if (op->is_intrinsic(ir::intrinsic::akg_dot_u8s8)) {
+    return CreateDotU8S8(op);
+  }
+  return CodeGenCPU::CreateIntrinsic(op);
+}
+
+// acc[i] += sum(zext(a[4i + q]) * sext(b[4i + q])), q in [0, 4).
+// Every sequence is exact: vpdpbusd accumulates in int32, the avx2 and avx512bw sequence widens the bytes to int16
+// before vpmaddwd instead of using vpmaddubsw, whose int16 pair sums saturate.
+llvm::Value* CodeGenX86_64::CreateDotU8S8(const Call* op) {
+  CHECK_EQ(op->args.size(), 3U);
+  const int lanes = op->type.lanes();
+  CHECK_EQ(op->args[1].type().lanes(), lanes * 4);
+  CHECK_EQ(op->args[2].type().lanes(), lanes * 4);
+  CHECK_NOTNULL(target_machine_);
+  llvm::Value* acc = MakeValue(op->args[0]);
+  llvm::Value* a = MakeValue(op->args[1]);
+  llvm::Value* b = MakeValue(op->args[2]);
+
+  const auto has_vnni = TargetHasFeature(*target_machine_, "avx512vnni");
+  if (has_vnni && lanes % 16 == 0) {
+    llvm::Type* dwords = LLVMType(Int(32, lanes));
+    return CallVectorIntrin(::llvm::Intrinsic::x86_avx512_vpdpbusd_512, 16, dwords,
+                            {acc, builder_->CreateBitCast(a, dwords), builder_->CreateBitCast(b, dwords)});
+  }
+  if (has_vnni && lanes % 8 == 0 && TargetHasFeature(*target_machine_, "avx512vl")) {
+    llvm::Type* dwords = LLVMType(Int(32, lanes));
+    return CallVectorIntrin(::llvm::Intrinsic::x86_avx512_vpdpbusd_256, 8, dwords,
+                            {acc, builder_->CreateBitCast(a, dwords), builder_->CreateBitCast(b, dwords)});
+  }
+  if (lanes % 16 == 0 && TargetHasFeature(*target_machine_, "avx512bw")) {
+    return CallWideningDot(::llvm::Intrinsic::x86_avx512_pmaddw_d_512, 16, acc, a, b, lanes);
+  }
+  if (lanes % 8 == 0 && TargetHasFeature(*target_machine_, "avx2")) {
+    return CallWideningDot(::llvm::Intrinsic::x86_avx2_pmadd_wd, 8, acc, a, b, lanes);
+  }
+
+  llvm::Type* wide = LLVMType(Int(32, lanes * 4));
+  llvm::Value* prod = builder_->CreateMul(builder_->CreateZExt(a, wide), builder_->CreateSExt(b, wide));
+  llvm::Value* sum = acc;
+  for (int q = 0; q < 4; ++q) {
+    std::vector<uint32_t> idx(lanes);
+    for (int i = 0; i < lanes; ++i) {
+      idx[i] = static_cast<uint32_t>(i * 4 + q);
+    }
+    llvm::Value* mask = llvm::ConstantDataVector::get(builder_->getContext(), idx);
+    sum = builder_->CreateAdd(sum,
+                              builder_->CreateShuffleVector(prod, llvm::UndefValue::get(prod->getType()), mask));
+  }
+  return sum;
+}
+
+// Index driven vector loads (e.g. of gather and GatherNd) become one gather instead of a load and an insertelement
+// per lane.
+llvm::Value* CodeGenX86_64::VisitExpr_(const Load* op) {
+  CHECK_NOTNULL(target_machine_);
+  const Type t = op->type;
+  if (!IsIndexDriven(t, op->index) || !is_one(op->predicate) || volatile_buf_.count(op->buffer_var.get()) ||
+      !TargetHasFeature(*target_machine_, "avx2")) {
+    return CodeGenLLVM::VisitExpr_(op);
+  }
+  llvm::Value* ptrs = CreateBufferPtr(t.element_of(), MakeValue(op->buffer_var), MakeValue(op->index));
+  const int alignment = t.bits() / 8;
+#if TVM_LLVM_VERSION >= 130
+  llvm::CallInst* load = builder_->CreateMaskedGather(LLVMType(t), ptrs, llvm::Align(alignment));
+#elif TVM_LLVM_VERSION >= 110
+  llvm::CallInst* load = builder_->CreateMaskedGather(ptrs, llvm::Align(alignment));
+#else
+  llvm::CallInst* load = builder_->CreateMaskedGather(ptrs, alignment);
+#endif
+  AddAliasInfo(load, op->buffer_var.get(), Expr(), t);
+  return load;
+}
+
+// Index driven vector stores (e.g. of TensorScatterAdd) become one scatter. Lanes with the same address are written
+// from the lowest lane up, like the scalarized stores.
+void CodeGenX86_64::VisitStmt_(const Store* op) {
+  CHECK_NOTNULL(target_machine_);
+  const Type t = op->value.type();
+  if (!IsIndexDriven(t, op->index) || !is_one(op->predicate) || volatile_buf_.count(op->buffer_var.get()) ||
+      !TargetHasFeature(*target_machine_, "avx512f")) {
+    CodeGenLLVM::VisitStmt_(op);
+    return;
+  }
+  llvm::Value* ptrs = CreateBufferPtr(t.element_of(), MakeValue(op->buffer_var), MakeValue(op->index));
+  llvm::Value* value = MakeValue(op->value);
+  const int alignment = t.bits() / 8;
+#if TVM_LLVM_VERSION >= 110
+  llvm::CallInst* store = builder_->CreateMaskedScatter(value, ptrs, llvm::Align(alignment));
+#else
+  llvm::CallInst* store = builder_->CreateMaskedScatter(value, ptrs, alignment);
+#endif
+  AddAliasInfo(store, op->buffer_var.get(), Expr(), t);
+}
+
+// a is zero-extended and b sign-extended to int16, so each vpmaddwd dword holds the exact sum of two products, i.e.
+// dword 2i + q covers k = 4i + 2q and 4i + 2q + 1. The even and odd dwords are then added into acc[i].
+llvm::Value* CodeGenX86_64::CallWideningDot(llvm::Intrinsic::ID maddwd_id, int intrin_lanes, llvm::Value* acc,
+                                            llvm::Value* a, llvm::Value* b, int lanes) {
+  llvm::Function* maddwd = llvm::Intrinsic::getDeclaration(module_.get(), maddwd_id, {});
+  llvm::Type* words = LLVMType(Int(16, lanes * 4));
+  llvm::Value* a_words = builder_->CreateZExt(a, words);
+  llvm::Value* b_words = builder_->CreateSExt(b, words);
+  std::vector<llvm::Value*> pairs;
+  for (int i = 0; i < lanes * 2; i += intrin_lanes) {
+    pairs.push_back(builder_->CreateCall(
+        maddwd, {CreateVecSlice(a_words, i * 2, intrin_lanes * 2), CreateVecSlice(b_words, i * 2, intrin_lanes * 2)}));
+  }
+  llvm::Value* sums = CreateVecConcat(pairs);
+  llvm::Value* result = acc;
+  for (int q = 0; q < 2; ++q) {
+    std::vector<uint32_t> idx(lanes);
+    for (int i = 0; i < lanes; ++i) {
+      idx[i] = static_cast<uint32_t>(i * 2 + q);
+    }
+    llvm::Value* mask = llvm::ConstantDataVector::get(builder_->getContext(), idx);
+    result = builder_->CreateAdd(result,
+                                 builder_->CreateShuffleVector(sums, llvm::UndefValue::get(sums->getType()), mask));
+  }
+  return result;
+}
+
 llvm::Value* CodeGenX86_64::CallVectorIntrin(llvm::Intrinsic::ID id, size_t intrin_lanes,
                                              llvm::Type* result_ty,
 
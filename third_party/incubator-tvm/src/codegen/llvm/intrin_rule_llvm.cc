@@ -28,10 +28,14 @@
  *   Optimize tanh intrinsic
  * 2023.2.10
  *   Disable optimize tanh default
+ * 2026.10.19
+ *   Emit vector math for exp, log, tanh, sigmoid, erf, rsqrt, sin and cos and the fast variants
  */
 #ifdef TVM_LLVM_VERSION
 
 #include "intrin_rule_llvm.h"
+#include "vector_math.h"
+#include "../intrin_rule.h"
 
 namespace air {
 namespace codegen {
@@ -44,19 +48,66 @@ static constexpr auto COEF_3 = 17325.0f;
 static constexpr auto COEF_4 = 62370.0f;
 static constexpr auto COEF_5 = 135135.0f;
 
+// the vector math of a float32 or vectorized float16 call, scalar float32 only when scalar_float32
+template <typename F>
+bool DispatchVectorMath(const TVMArgs& targs, TVMRetValue* rv, bool scalar_float32, F emit) {
+  Expr e = targs[0];
+  const ir::Call* call = e.as<ir::Call>();
+  CHECK(call != nullptr);
+  if (!UseVectorMath(call->args[0].type(), scalar_float32)) {
+    return false;
+  }
+  *rv = emit(call->args[0]);
+  return true;
+}
+
 TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.prefetch")
 .set_body(DispatchLLVMIntrin<::llvm::Intrinsic::prefetch, 4>);
 
-TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.exp")
-.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+// the tanh of the scalar lanes that the vector math leaves, e.g. float64
+static Expr TanhByExp(const Expr& x) {
+  Expr one = make_const(x.type(), 1);
+  Expr two = make_const(x.type(), 2);
+  Expr neg_two = make_const(x.type(), -2);
+
+  Expr exp_neg2x = ir::Call::make(
+      x.type(), "exp", {neg_two * x}, ir::Call::PureIntrinsic);
+  Expr exp_pos2x = ir::Call::make(
+      x.type(), "exp", {two * x}, ir::Call::PureIntrinsic);
+
+  Expr tanh_pos = (one - exp_neg2x) / (one + exp_neg2x);
+  Expr tanh_neg = (exp_pos2x - one) / (exp_pos2x + one);
+  return ir::Select::make(
+      x >= make_zero(x.type()), tanh_pos, tanh_neg);
+}
+
+static Expr SigmoidByExp(const Expr& x) {
+  Expr one = make_const(x.type(), 1);
+  return one / (one + exp(-x));
+}
+
+static Expr CallArg(const TVMArgs& targs) {
   Expr e = targs[0];
   const ir::Call* call = e.as<ir::Call>();
   CHECK(call != nullptr);
-  const Expr& x = call->args[0];
-  const auto type = x.type();
+  return call->args[0];
+}
+
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.exp")
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  if (!DispatchVectorMath(targs, rv, true, [](const Expr& v) { return VectorExp(v, MathAccuracy::kPrecise); })) {
+    DispatchLLVMPureIntrin<::llvm::Intrinsic::exp, 1>(targs, rv);
+  }
+});
+
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.fast_exp")
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  Expr e = targs[0];
+  const auto type = CallArg(targs).type();
   if (type.is_float() && type.bits() == 32) {
+    // emitted by CodeGenLLVM::CreateExp
     *rv = e;
-  } else {
+  } else if (!DispatchVectorMath(targs, rv, true, [](const Expr& v) { return VectorExp(v, MathAccuracy::kFast); })) {
     DispatchLLVMPureIntrin<::llvm::Intrinsic::exp, 1>(targs, rv);
   }
 });
@@ -72,8 +123,9 @@ TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.log")
   const Expr& x = call->args[0];
   const auto type = x.type();
   if (type.is_float() && type.bits() == 32) {
+    // emitted by CodeGenLLVM::CreateLog
     *rv = e;
-  } else {
+  } else if (!DispatchVectorMath(targs, rv, false, VectorLog)) {
     DispatchLLVMPureIntrin<::llvm::Intrinsic::log, 1>(targs, rv);
   }
 });
@@ -101,23 +153,16 @@ TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.nearbyint")
 
 TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.tanh")
 .set_body([](const TVMArgs& targs, TVMRetValue* rv) {
-  Expr e = targs[0];
-  const ir::Call* call = e.as<ir::Call>();
-  CHECK(call != nullptr);
-  const Expr& x = call->args[0];
-  Expr one = make_const(x.type(), 1);
-  Expr two = make_const(x.type(), 2);
-  Expr neg_two = make_const(x.type(), -2);
-
-  Expr exp_neg2x = ir::Call::make(
-      x.type(), "exp", {neg_two * x}, ir::Call::PureIntrinsic);
-  Expr exp_pos2x = ir::Call::make(
-      x.type(), "exp", {two * x}, ir::Call::PureIntrinsic);
+  if (!DispatchVectorMath(targs, rv, true, [](const Expr& v) { return VectorTanh(v, MathAccuracy::kPrecise); })) {
+    *rv = TanhByExp(CallArg(targs));
+  }
+});
 
-  Expr tanh_pos = (one - exp_neg2x) / (one + exp_neg2x);
-  Expr tanh_neg = (exp_pos2x - one) / (exp_pos2x + one);
-  *rv = ir::Select::make(
-      x >= make_zero(x.type()), tanh_pos, tanh_neg);
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.fast_tanh")
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  if (!DispatchVectorMath(targs, rv, true, [](const Expr& v) { return VectorTanh(v, MathAccuracy::kFast); })) {
+    *rv = TanhByExp(CallArg(targs));
+  }
 });
 
 TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.tanh2")
@@ -140,11 +185,56 @@ TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.pow")
 TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.popcount")
 .set_body(DispatchLLVMPureIntrin<::llvm::Intrinsic::ctpop, 1>);
 
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.sigmoid")
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  if (!DispatchVectorMath(targs, rv, true, [](const Expr& v) { return VectorSigmoid(v, MathAccuracy::kPrecise); })) {
+    *rv = SigmoidByExp(CallArg(targs));
+  }
+});
+
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.fast_sigmoid")
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  if (!DispatchVectorMath(targs, rv, true, [](const Expr& v) { return VectorSigmoid(v, MathAccuracy::kFast); })) {
+    *rv = SigmoidByExp(CallArg(targs));
+  }
+});
+
+// 1 / sqrt(x) is already vectorized, only the fast estimate has its own expression
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.rsqrt")
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  Expr x = CallArg(targs);
+  *rv = make_const(x.type(), 1) / sqrt(x);
+});
+
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.fast_rsqrt")
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  if (!DispatchVectorMath(targs, rv, true, [](const Expr& v) { return VectorRsqrt(v, MathAccuracy::kFast); })) {
+    Expr x = CallArg(targs);
+    *rv = make_const(x.type(), 1) / sqrt(x);
+  }
+});
+
+// libm keeps the scalar calls of erf, sin and cos
+TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.erf")
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  if (!DispatchVectorMath(targs, rv, false, VectorErf)) {
+    intrin::DispatchExtern<intrin::FloatSuffix>(targs, rv);
+  }
+});
+
 TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.cos")
-.set_body(DispatchLLVMPureIntrin<::llvm::Intrinsic::cos, 1>);
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  if (!DispatchVectorMath(targs, rv, false, VectorCos)) {
+    DispatchLLVMPureIntrin<::llvm::Intrinsic::cos, 1>(targs, rv);
+  }
+});
 
 TVM_REGISTER_GLOBAL("tvm.intrin.rule.llvm.sin")
-.set_body(DispatchLLVMPureIntrin<::llvm::Intrinsic::sin, 1>);
+.set_body([](const TVMArgs& targs, TVMRetValue* rv) {
+  if (!DispatchVectorMath(targs, rv, false, VectorSin)) {
+    DispatchLLVMPureIntrin<::llvm::Intrinsic::sin, 1>(targs, rv);
+  }
+});
 
 }  // namespace llvm
 }  // namespace codegen
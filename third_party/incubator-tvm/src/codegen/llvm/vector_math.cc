@@ -0,0 +1,311 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file vector_math.cc
+ * \brief Polynomial float32 math that the llvm intrinsic rules emit for vector lanes.
+ *
+ *  exp, log, tanh, sin and cos follow the Cephes single precision routines, erf and the fast
+ *  tanh are the rational approximations used by Eigen.
+ */
+#ifdef TVM_LLVM_VERSION
+
+// llvm_common.h comes first, vector_math.h opens the namespace air::codegen::llvm
+#include "llvm_common.h"
+#include "vector_math.h"
+
+#include <tvm/expr_operator.h>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace air {
+namespace codegen {
+namespace llvm {
+namespace {
+// sin and cos reduce their argument in float32 up to this magnitude, larger ones go to libm
+constexpr double kMaxSinCosReduce = 8192;
+
+Expr Const(const Type& t, double value) { return make_const(t, value); }
+
+// c[0] * x^n + c[1] * x^(n-1) + ... + c[n], the multiply-adds become fma
+Expr Poly(const Expr& x, const std::vector<double>& coeffs) {
+  CHECK(!coeffs.empty());
+  Expr p = Const(x.type(), coeffs[0]);
+  for (size_t i = 1; i < coeffs.size(); ++i) {
+    p = p * x + Const(x.type(), coeffs[i]);
+  }
+  return p;
+}
+
+// binds value to a var for body, the expressions use their operands several times
+template <typename F>
+Expr Bind(const std::string& name, const Expr& value, F body) {
+  if (value.as<Variable>() != nullptr || is_const(value)) {
+    return body(value);
+  }
+  Var v(name, value.type());
+  return ir::Let::make(v, value, body(v));
+}
+
+template <typename F>
+Expr InFloat32(const Expr& x, F body) {
+  Type t = x.type();
+  CHECK(t.is_float() && (t.bits() == 32 || t.bits() == 16)) << "vector math takes float32 or float16, not " << t;
+  if (t.bits() == 32) {
+    return Bind("x", x, body);
+  }
+  Expr value = Bind("x", ir::Cast::make(Float(32, t.lanes()), x), body);
+  return ir::Cast::make(t, value);
+}
+
+Expr Reinterpret(const Type& t, const Expr& x) {
+  return ir::Call::make(t, ir::Call::reinterpret, {x}, ir::Call::PureIntrinsic);
+}
+
+Expr Negate(const Expr& cond, const Expr& x) {
+  return Bind("v", x, [&cond](const Expr& v) { return ir::Select::make(cond, make_zero(v.type()) - v, v); });
+}
+
+// 2^k of type t for the int32 k in [-126, 127]
+Expr Pow2(const Type& t, const Expr& k) {
+  Type it = k.type();
+  return Reinterpret(t, (k + make_const(it, 127)) << make_const(it, 23));
+}
+
+// x * 2^n for the integral float n in [-252, 254], scaled by one half of n at a time, since 2^128 itself is not
+// finite but x * 2^128 is for x < 1
+Expr ScaleByPow2(const Expr& x, const Expr& n) {
+  Type t = n.type();
+  return Bind("k", ir::Cast::make(Int(32, t.lanes()), n), [&t, &x](const Expr& k) {
+    return Bind("h", k >> make_const(k.type(), 1),
+                [&t, &x, &k](const Expr& h) { return (x * Pow2(t, h)) * Pow2(t, k - h); });
+  });
+}
+
+// any lane of the bool vector cond
+Expr AnyLane(const Expr& cond) {
+  int lanes = cond.type().lanes();
+  if (lanes == 1) {
+    return cond;
+  }
+  return Bind("c", cond, [lanes](const Expr& c) {
+    Expr any = ir::Shuffle::make_extract_element(c, 0);
+    for (int i = 1; i < lanes; ++i) {
+      any = ir::Or::make(any, ir::Shuffle::make_extract_element(c, i));
+    }
+    return any;
+  });
+}
+
+Expr LLVMPureIntrin(unsigned id, const Expr& x) {
+  return ir::Call::make(x.type(), "llvm_intrin",
+                        {make_const(UInt(32), id), make_const(UInt(32), 1), x}, ir::Call::PureIntrinsic);
+}
+
+Expr ExpImpl(const Expr& x) {
+  Type t = x.type();
+  constexpr double kMaxLog = 88.72283935546875;
+  constexpr double kMinLog = -87.33654475055310898657;
+  Expr clamped = ir::Max::make(ir::Min::make(x, Const(t, kMaxLog)), Const(t, kMinLog));
+  Expr value = Bind("n", nearbyint(clamped * Const(t, 1.44269504088896341)), [&t, &clamped](const Expr& n) {
+    // x - n * ln2 with ln2 split in two, the first part is exact in 9 bits
+    Expr r = clamped - n * Const(t, 0.693359375) + n * Const(t, 2.12194440e-4);
+    return Bind("r", r, [&t, &n](const Expr& r) {
+      Expr p = Poly(r, {1.9875691500e-4, 1.3981999507e-3, 8.3334519073e-3, 4.1665795894e-2, 1.6666665459e-1,
+                        5.0000001201e-1});
+      return ScaleByPow2(p * r * r + r + Const(t, 1), n);
+    });
+  });
+  value = ir::Select::make(x > Const(t, kMaxLog), Const(t, std::numeric_limits<float>::infinity()), value);
+  value = ir::Select::make(x < Const(t, kMinLog), make_zero(t), value);
+  return ir::Select::make(x != x, x, value);
+}
+
+// emitted by CodeGenLLVM::CreateExp
+Expr FastExpCall(const Expr& x) { return ir::Call::make(x.type(), "fast_exp", {x}, ir::Call::PureIntrinsic); }
+
+// emitted by CodeGenLLVM::CreateLog, the Cephes logf
+Expr LogCall(const Expr& x) { return ir::Call::make(x.type(), "log", {x}, ir::Call::PureIntrinsic); }
+
+Expr TanhPreciseImpl(const Expr& x) {
+  Type t = x.type();
+  return Bind("a", abs(x), [&t, &x](const Expr& a) {
+    Expr z = x * x;
+    Expr small = Poly(z, {-5.70498872745e-3, 2.06390887954e-2, -5.37397155531e-2, 1.33314422036e-1,
+                          -3.33332819422e-1}) * z * x + x;
+    // 1 - 2 / (exp(2|x|) + 1), exp(18) already rounds the result to 1
+    Expr e = ExpImpl(ir::Min::make(a + a, Const(t, 18)));
+    Expr large = Negate(x < make_zero(t), Const(t, 1) - Const(t, 2) / (e + Const(t, 1)));
+    return ir::Select::make(a < Const(t, 0.625), small, large);
+  });
+}
+
+Expr TanhFastImpl(const Expr& x) {
+  Type t = x.type();
+  constexpr double kClamp = 7.90531110763549805;
+  Expr clamped = ir::Max::make(ir::Min::make(x, Const(t, kClamp)), Const(t, -kClamp));
+  return Bind("c", clamped, [&t](const Expr& c) {
+    return Bind("c2", c * c, [&c](const Expr& c2) {
+      Expr p = Poly(c2, {-2.76076847742355e-16, 2.00018790482477e-13, -8.60467152213735e-11, 5.12229709037114e-08,
+                         1.48572235717979e-05, 6.37261928875436e-04, 4.89352455891786e-03});
+      Expr q = Poly(c2, {1.19825839466702e-06, 1.18534705686654e-04, 2.26843463243900e-03, 4.89352518554385e-03});
+      return p * c / q;
+    });
+  });
+}
+
+Expr SigmoidImpl(const Expr& x, MathAccuracy accuracy) {
+  Type t = x.type();
+  Expr neg = make_zero(t) - x;
+  Expr e = accuracy == MathAccuracy::kFast ? FastExpCall(neg) : ExpImpl(neg);
+  return Const(t, 1) / (Const(t, 1) + e);
+}
+
+Expr ErfImpl(const Expr& x) {
+  Type t = x.type();
+  Expr clamped = ir::Max::make(ir::Min::make(x, Const(t, 4)), Const(t, -4));
+  return Bind("c", clamped, [&t](const Expr& c) {
+    return Bind("c2", c * c, [&c](const Expr& c2) {
+      Expr p = Poly(c2, {-2.72614225801306e-10, 2.77068142495902e-08, -2.10102402082508e-06, -5.69250639462346e-05,
+                         -7.34990630326855e-04, -2.95459980854025e-03, -1.60960333262415e-02});
+      Expr q = Poly(c2, {-1.45660718464996e-05, -2.13374055278905e-04, -1.68282697438203e-03, -7.37332916720468e-03,
+                         -1.42647390514189e-02});
+      return c * p / q;
+    });
+  });
+}
+
+Expr RsqrtFastImpl(const Expr& x) {
+  Type t = x.type();
+  Type it = Int(32, t.lanes());
+  // the bit level estimate and two newton steps y * (1.5 - 0.5 * x * y * y)
+  Expr bits = Reinterpret(it, x);
+  Expr y = Reinterpret(t, make_const(it, 0x5f375a86) - (bits >> make_const(it, 1)));
+  return Bind("h", x * Const(t, 0.5), [&t, &y](const Expr& h) {
+    Expr step = Bind("y", y, [&t, &h](const Expr& y) { return y * (Const(t, 1.5) - h * y * y); });
+    return Bind("y", step, [&t, &h](const Expr& y) { return y * (Const(t, 1.5) - h * y * y); });
+  });
+}
+
+/*
+ * Reduces |x| to r in [-pi/4, pi/4] with j = the even octant, pi/4 split in three parts,
+ * and calls body(j, r, r * r).
+ */
+template <typename F>
+Expr SinCosReduce(const Expr& a, F body) {
+  Type t = a.type();
+  Type it = Int(32, t.lanes());
+  Expr j = ir::Cast::make(it, a * Const(t, 1.27323954473516));
+  j = (j + make_const(it, 1)) & make_const(it, -2);
+  return Bind("j", j, [&t, &a, &body](const Expr& j) {
+    return Bind("y", ir::Cast::make(t, j), [&t, &a, &j, &body](const Expr& y) {
+      Expr r = a - y * Const(t, 0.78515625) - y * Const(t, 2.4187564849853515625e-4) -
+               y * Const(t, 3.77489497744594108e-8);
+      return Bind("r", r, [&j, &body](const Expr& r) {
+        return Bind("z", r * r, [&j, &r, &body](const Expr& z) { return body(j, r, z); });
+      });
+    });
+  });
+}
+
+Expr SinPoly(const Expr& r, const Expr& z) {
+  return Poly(z, {-1.9515295891e-4, 8.3321608736e-3, -1.6666654611e-1}) * z * r + r;
+}
+
+Expr CosPoly(const Expr& z) {
+  Type t = z.type();
+  return Poly(z, {2.443315711809948e-5, -1.388731625493765e-3, 4.166664568298827e-2}) * z * z -
+         Const(t, 0.5) * z + Const(t, 1);
+}
+
+Expr OctantBit(const Expr& j, int bit) { return (j & make_const(j.type(), bit)) != make_zero(j.type()); }
+
+// the polynomial unless a lane is beyond the reduction range, inf or nan; then the whole vector goes to libm
+Expr WithLibmFallback(const Expr& x, unsigned libm_id, const Expr& poly) {
+  Type t = x.type();
+  Expr large = AnyLane(!(abs(x) <= Const(t, kMaxSinCosReduce)));
+  return ir::Call::make(t, ir::intrinsic::tvm_if_then_else, {large, LLVMPureIntrin(libm_id, x), poly},
+                        ir::Call::PureIntrinsic);
+}
+
+Expr SinImpl(const Expr& x) {
+  Type t = x.type();
+  Expr poly = SinCosReduce(abs(x), [&t, &x](const Expr& j, const Expr& r, const Expr& z) {
+    Expr p = ir::Select::make(OctantBit(j, 2), CosPoly(z), SinPoly(r, z));
+    return Negate(OctantBit(j, 4) != (x < make_zero(t)), p);
+  });
+  return WithLibmFallback(x, ::llvm::Intrinsic::sin, poly);
+}
+
+Expr CosImpl(const Expr& x) {
+  Expr poly = SinCosReduce(abs(x), [](const Expr& j, const Expr& r, const Expr& z) {
+    Expr p = ir::Select::make(OctantBit(j, 2), SinPoly(r, z), CosPoly(z));
+    return Negate(OctantBit(j + make_const(j.type(), 2), 4), p);
+  });
+  return WithLibmFallback(x, ::llvm::Intrinsic::cos, poly);
+}
+}  // namespace
+
+bool UseVectorMath(const Type& t, bool scalar_float32) {
+  if (!t.is_float()) {
+    return false;
+  }
+  if (t.lanes() > 1) {
+    return t.bits() == 32 || t.bits() == 16;
+  }
+  return scalar_float32 && t.bits() == 32;
+}
+
+Expr VectorExp(const Expr& x, MathAccuracy accuracy) {
+  if (accuracy == MathAccuracy::kFast) {
+    return InFloat32(x, FastExpCall);
+  }
+  return InFloat32(x, ExpImpl);
+}
+
+Expr VectorTanh(const Expr& x, MathAccuracy accuracy) {
+  return accuracy == MathAccuracy::kFast ? InFloat32(x, TanhFastImpl) : InFloat32(x, TanhPreciseImpl);
+}
+
+Expr VectorSigmoid(const Expr& x, MathAccuracy accuracy) {
+  return InFloat32(x, [accuracy](const Expr& v) { return SigmoidImpl(v, accuracy); });
+}
+
+Expr VectorLog(const Expr& x) { return InFloat32(x, LogCall); }
+
+Expr VectorErf(const Expr& x) { return InFloat32(x, ErfImpl); }
+
+Expr VectorRsqrt(const Expr& x, MathAccuracy accuracy) {
+  if (accuracy == MathAccuracy::kFast) {
+    return InFloat32(x, RsqrtFastImpl);
+  }
+  return InFloat32(x, [](const Expr& v) { return make_const(v.type(), 1) / sqrt(v); });
+}
+
+Expr VectorSin(const Expr& x) { return InFloat32(x, SinImpl); }
+
+Expr VectorCos(const Expr& x) { return InFloat32(x, CosImpl); }
+
+}  // namespace llvm
+}  // namespace codegen
+}  // namespace air
+
+#endif  // TVM_LLVM_VERSION
@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file vector_math.h
+ * \brief Polynomial float32 math that the llvm intrinsic rules emit for vector lanes.
+ *
+ *  The functions build plain arithmetic, bitwise and select expressions, so a vectorized
+ *  call stays in registers and llvm selects the SSE, AVX2, AVX-512 or NEON instructions
+ *  of the target instead of calling libm once per lane.
+ *
+ *  precise: within a few ulp of libm over the float32 range, denormal results flush to zero,
+ *           sin and cos reduce their argument for |x| <= 8192 and call libm for the whole
+ *           vector when a lane is larger.
+ *  fast:    fewer operations for exp, tanh, sigmoid and rsqrt, about 1e-5 relative error.
+ *           The llvm rules of fast_exp, fast_tanh, fast_sigmoid and fast_rsqrt emit it, the
+ *           UseFastMath pass of a build with cpu_math_accuracy "fast" renames the calls.
+ *
+ *  float32 log is emitted by CodeGenLLVM::CreateLog for any lanes, vectorized float16 log
+ *  goes through it in float32.
+ */
+#ifndef TVM_CODEGEN_LLVM_VECTOR_MATH_H_
+#define TVM_CODEGEN_LLVM_VECTOR_MATH_H_
+
+#include <tvm/ir.h>
+
+namespace air {
+namespace codegen {
+namespace llvm {
+
+enum class MathAccuracy : int { kPrecise = 0, kFast };
+
+/*! \brief Whether the function of type t is emitted by the polynomials of this file */
+bool UseVectorMath(const Type& t, bool scalar_float32);
+
+/*!
+ * \brief The math functions, x is float32 or float16 with any lanes,
+ *  float16 is computed in float32.
+ */
+Expr VectorExp(const Expr& x, MathAccuracy accuracy);
+Expr VectorTanh(const Expr& x, MathAccuracy accuracy);
+Expr VectorSigmoid(const Expr& x, MathAccuracy accuracy);
+Expr VectorLog(const Expr& x);
+Expr VectorErf(const Expr& x);
+Expr VectorRsqrt(const Expr& x, MathAccuracy accuracy);
+Expr VectorSin(const Expr& x);
+Expr VectorCos(const Expr& x);
+
+}  // namespace llvm
+}  // namespace codegen
+}  // namespace air
+
+#endif  // TVM_CODEGEN_LLVM_VECTOR_MATH_H_
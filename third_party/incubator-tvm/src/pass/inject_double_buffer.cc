@@ -45,6 +45,9 @@ namespace air {
 namespace ir {
 constexpr auto TRANSFER_WRITE_INDEX = "transfer_write_index";
 constexpr auto USE_THREAD_GROUP = "use_thread_group";
+constexpr auto PIPELINE_MEMCPY_ASYNC = "__pipeline_memcpy_async";
+constexpr auto PIPELINE_COMMIT = "__pipeline_commit";
+constexpr auto PIPELINE_WAIT_PRIOR = "__pipeline_wait_prior";
 
 inline Expr BroadcastTo(Expr e, int lanes) {
   if (e.type().lanes() == lanes) return e;
@@ -80,6 +83,57 @@ class DoubleBufferDetector : public IRVisitor {
   std::unordered_set<const Variable*> touched_;
 };
 
+// Check that every store to a buffer of the scope can be issued as one asynchronous copy from global memory.
+class AsyncCopyChecker : public IRVisitor {
+ public:
+  explicit AsyncCopyChecker(const std::unordered_set<const Variable*>& buffers) : buffers_(buffers) {}
+
+  void Visit_(const Store* op) final {
+    IRVisitor::Visit_(op);
+    if (!buffers_.count(op->buffer_var.get())) return;
+    const auto load = op->value.as<Load>();
+    if (load == nullptr || buffers_.count(load->buffer_var.get()) || !IsContiguous(op->index) ||
+        !IsContiguous(load->index) || !is_one(op->predicate) || !is_one(load->predicate)) {
+      can_copy_ = false;
+      return;
+    }
+    int bytes = load->type.bytes() * load->type.lanes();
+    if (bytes != 4 && bytes != 8 && bytes != 16) {
+      can_copy_ = false;
+    }
+  }
+
+  bool CanCopy() const { return can_copy_; }
+
+ private:
+  static bool IsContiguous(const Expr& index) {
+    const auto ramp = index.as<Ramp>();
+    return ramp == nullptr || is_one(ramp->stride);
+  }
+
+  const std::unordered_set<const Variable*>& buffers_;
+  bool can_copy_{true};
+};
+
+inline Stmt PipelineCall(const std::string& name, const Array<Expr>& args) {
+  return Evaluate::make(Call::make(Int(32), name, args, Call::Extern));
+}
+
+// Offset a flat index by whole buffers. A vector index stays a ramp, so that its base is the first element.
+inline Expr OffsetIndex(const Expr& offset, const Expr& index) {
+  if (const auto ramp = index.as<Ramp>()) {
+    return Ramp::make(offset + ramp->base, ramp->stride, ramp->lanes);
+  }
+  return offset + index;
+}
+
+inline Expr AddressOf(const Var& buffer, air::DataType type, const Expr& index) {
+  const auto ramp = index.as<Ramp>();
+  Expr base = ramp != nullptr ? ramp->base : index;
+  return Call::make(Handle(), intrinsic::tvm_address_of,
+                    {Load::make(type.element_of(), buffer, base, const_true())}, Call::PureIntrinsic);
+}
+
 class StripSyncAndAllocs : public IRMutator {
  public:
   explicit StripSyncAndAllocs(bool use_double_shared)
@@ -288,7 +342,7 @@ class DoubleBufferInjector : public IRMutator {
         alloc_nest.emplace_back(AttrStmt::make(alloc->buffer_var, attr::storage_scope,
                                               StringImm::make(it->second.scope), Evaluate::make(0)));
         if (use_double_buffer_) {
-          Array<Expr> new_extents{make_const(alloc->extents[0].type(), 2)};
+          Array<Expr> new_extents{make_const(alloc->extents[0].type(), it->second.stages)};
           for (Expr e : alloc->extents) {
             new_extents.push_back(e);
           }
@@ -298,6 +352,10 @@ class DoubleBufferInjector : public IRMutator {
           alloc_nest.emplace_back(Allocate::make(alloc->buffer_var, alloc->type, alloc->extents, alloc->condition,
                                                 Evaluate::make(0)));
         }
+        if (it->second.async_copy) {
+          // asynchronous copies go to the shared memory directly, without the transfer buffer
+          return alloc->body;
+        }
         alloc_nest.emplace_back(
             AttrStmt::make(it->second.transfer_buffer, air::ir::attr::storage_scope,
                             StringImm::make(it->second.transfer_buffer_scope), Evaluate::make(0)));
@@ -316,6 +374,7 @@ class DoubleBufferInjector : public IRMutator {
       transfer_loop_nest_.push_back(op);
     }
     Stmt stmt = IRMutator::Mutate_(op, s);
+    AddAsyncWait(op);
     const For* orig_loop = stmt.as<For>();
     auto iter = loop_transfer_.find(op);
     std::vector<Stmt> fragment_allocs;
@@ -390,6 +449,15 @@ class DoubleBufferInjector : public IRMutator {
       if (it != dbuffer_info_.end()) {
         StorageEntry& e = it->second;
         CHECK(in_double_buffer_scope_);
+        if (e.async_copy) {
+          const auto load = store->value.as<Load>();
+          CHECK(load != nullptr);
+          CHECK(e.stride.defined());
+          Expr dst = AddressOf(store->buffer_var, load->type, OffsetIndex(e.switch_write_var * e.stride, store->index));
+          Expr src = AddressOf(load->buffer_var, load->type, load->index);
+          return PipelineCall(PIPELINE_MEMCPY_ASYNC,
+                              {dst, src, make_const(Int(32), load->type.bytes() * load->type.lanes())});
+        }
         Expr transfer_index = make_const(e.loop->loop_var.type(), 0);
         Expr transfer_extent = make_const(e.transfer_buffer_extents[0].type(), 1);
         for (unsigned i = 0; i < transfer_loop_nest_.size(); i++) {
@@ -417,8 +485,8 @@ class DoubleBufferInjector : public IRMutator {
                         BroadcastTo(transfer_index, lanes), BroadcastTo(store->predicate, lanes));
         if (use_double_buffer_) {
           CHECK(e.stride.defined());
-          transfer_store =
-            AttrStmt::make(store->buffer_var, TRANSFER_WRITE_INDEX, e.switch_write_var * e.stride + store->index, transfer_store);
+          transfer_store = AttrStmt::make(store->buffer_var, TRANSFER_WRITE_INDEX,
+                                          OffsetIndex(e.switch_write_var * e.stride, store->index), transfer_store);
         } else {
           transfer_store =
             AttrStmt::make(store->buffer_var, TRANSFER_WRITE_INDEX, store->index, transfer_store);
@@ -437,7 +505,8 @@ class DoubleBufferInjector : public IRMutator {
         const StorageEntry& e = it->second;
         CHECK(e.stride.defined());
         CHECK(e.switch_read_var.defined());
-        return Load::make(load->type, load->buffer_var, e.switch_read_var * e.stride + load->index, load->predicate);
+        return Load::make(load->type, load->buffer_var, OffsetIndex(e.switch_read_var * e.stride, load->index),
+                          load->predicate);
       }
     }
     return expr;
@@ -449,6 +518,27 @@ class DoubleBufferInjector : public IRMutator {
   }
 
  private:
+  struct StorageEntry;
+  // The prologue fills all stages but the last before the loop, stage by stage, so that the groups of
+  // copies are committed in the order of the iterations both before and inside the loop.
+  void AddAsyncWait(const For* op) {
+    auto it = async_loops_.find(op);
+    if (it == async_loops_.end()) return;
+    const AsyncLoop& async_loop = it->second;
+    Stmt wait = PipelineCall(PIPELINE_WAIT_PRIOR,
+                             {make_const(Int(32), async_loop.num_scopes * (async_loop.stages - 2))});
+    for (const auto& stage : async_loop.prologue) {
+      loop_pre_[op].insert(loop_pre_[op].end(), stage.begin(), stage.end());
+    }
+    loop_pre_[op].emplace_back(wait);
+    loop_transfer_[op].emplace_back(wait);
+    if (split_loop_ != 1) {
+      // only the main loop split by one already ends with a barrier
+      loop_transfer_[op].emplace_back(Evaluate::make(
+          Call::make(Int(32), "tvm_storage_sync", {StringImm::make("shared")}, Call::Intrinsic)));
+    }
+  }
+
   Stmt MakeProducer(const AttrStmt* op, const Stmt& s) {
     const VarExpr buffer = Downcast<VarExpr>(op->node);
     CHECK_NE(loop_nest_.size(), 0U) << "Double buffer scope must be inside a loop";
@@ -459,6 +549,21 @@ class DoubleBufferInjector : public IRMutator {
     }
     StorageEntry& e = it->second;
     e.loop = loop_nest_.back();
+    const auto stages = op->value.as<IntImm>();
+    if (use_double_buffer_ && stages != nullptr && stages->value > 2) {
+      std::unordered_set<const Variable*> buffers;
+      for (const auto& kv : dbuffer_info_) {
+        buffers.insert(kv.first);
+      }
+      AsyncCopyChecker checker(buffers);
+      checker.Visit(op->body);
+      if (checker.CanCopy()) {
+        e.stages = static_cast<int>(stages->value);
+        e.async_copy = true;
+        return MakeAsyncProducer(op, e);
+      }
+      LOG(WARNING) << "Cannot copy " << buffer << " asynchronously, use two stages of double buffer instead";
+    }
     Expr zero = make_const(e.loop->loop_var.type(), 0);
     Expr one = make_const(e.loop->loop_var.type(), 1);
     Expr two = make_const(e.loop->loop_var.type(), 2);
@@ -492,6 +597,49 @@ class DoubleBufferInjector : public IRMutator {
     transfer_loop_nest_.clear();
     return body;
   }
+
+  // The tile of iteration k is copied into stage k % stages by an asynchronous copy issued
+  // stages - 1 iterations ahead. Every scope commits one group of copies per iteration, and the
+  // loop waits for the groups of the next iteration before the barrier at its end.
+  Stmt MakeAsyncProducer(const AttrStmt* op, StorageEntry& e) {
+    air::DataType loop_type = e.loop->loop_var.type();
+    Expr num_stages = make_const(loop_type, e.stages);
+    Expr ahead = make_const(loop_type, e.stages - 1);
+    Expr loop_shift = e.loop->loop_var + ahead;
+    e.switch_write_var = Var(e.loop->loop_var->name_hint + ".db", loop_type);
+    e.switch_read_var = indexmod(e.loop->loop_var, num_stages);
+    in_double_buffer_scope_ = true;
+    Stmt body = Mutate(op->body);
+    in_double_buffer_scope_ = false;
+    Stmt commit = PipelineCall(PIPELINE_COMMIT, {});
+    AsyncLoop& async_loop = async_loops_[e.loop];
+    CHECK(async_loop.prologue.empty() || async_loop.stages == e.stages)
+        << "The buffers of one loop must have the same number of stages";
+    async_loop.stages = e.stages;
+    async_loop.prologue.resize(e.stages - 1);
+    ++async_loop.num_scopes;
+    std::unordered_map<const Variable*, Expr> vmap;
+    for (int i = 0; i < e.stages - 1; ++i) {
+      Expr idx = make_const(loop_type, i);
+      vmap[e.loop->loop_var.get()] = idx;
+      vmap[e.switch_write_var.get()] = idx;
+      Stmt prefetch = Substitute(body, vmap);
+      if (i > 0) {
+        prefetch = IfThenElse::make(idx < e.loop->extent, prefetch);
+      }
+      async_loop.prologue[i].emplace_back(prefetch);
+      async_loop.prologue[i].emplace_back(commit);
+    }
+    vmap[e.loop->loop_var.get()] = loop_shift;
+    vmap[e.switch_write_var.get()] = indexmod(loop_shift, num_stages);
+    body = Substitute(body, vmap);
+    body = AttrStmt::make(op->node, air::ir::attr::double_buffer_write, 1, body);
+    body = IfThenElse::make(loop_shift < e.loop->extent, body);
+    transfer_loop_nest_.clear();
+    // commit even when nothing is copied, so the number of pending groups stays the same for every iteration
+    return Block::make(body, commit);
+  }
+
   // Storage entry for those who need double buffering.
   struct StorageEntry {
     // The size of the buffer
@@ -514,6 +662,10 @@ class DoubleBufferInjector : public IRMutator {
     Var transfer_buffer;
     // The transfer buffer extent
     Array<Expr> transfer_buffer_extents;
+    // The number of stages of the shared memory
+    int stages{2};
+    // Whether the stages are filled by asynchronous copies
+    bool async_copy{false};
   };
   // Whether split loop
   int32_t split_loop_;
@@ -533,6 +685,14 @@ class DoubleBufferInjector : public IRMutator {
   std::unordered_map<const For*, std::vector<Stmt> > loop_transfer_;
   // The loop nest for transfer
   std::vector<const For*> transfer_loop_nest_;
+  // The loops with buffers filled by asynchronous copies
+  struct AsyncLoop {
+    int stages{0};
+    int num_scopes{0};
+    // The copies and commits of each stage before the loop
+    std::vector<std::vector<Stmt> > prologue;
+  };
+  std::unordered_map<const For*, AsyncLoop> async_loops_;
 };
 
 Stmt InjectDoubleBuffer(Stmt stmt, int split_loop, bool use_double_shared) {